@@ -0,0 +1,96 @@
+//
+//  Benchmark.cpp
+//  cpu_bench
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+namespace Benchmark
+{
+    bool Suite::Enabled(const std::string& name) const
+    {
+        return mOptions.filter.empty() || name.find(mOptions.filter) != std::string::npos;
+    }
+
+    Result& Suite::Run(const std::string& name, const std::function<void()>& body)
+    {
+        /* Find a batch size that takes roughly minTimeSeconds. */
+        std::uint64_t batch = 1;
+        for (;;)
+        {
+            const auto start = Clock::now();
+            for (std::uint64_t index = 0; index < batch; index++)
+                body();
+
+            const double elapsed = ElapsedNs(start);
+            if (elapsed >= mOptions.minTimeSeconds * 1e9 || batch >= (1ull << 40))
+                break;
+
+            const double scale = elapsed > 0.0 ? mOptions.minTimeSeconds * 1e9 / elapsed : 10.0;
+            batch = std::max<std::uint64_t>(batch + 1, static_cast<std::uint64_t>(batch * std::min(scale * 1.2, 10.0)));
+        }
+
+        Result result;
+        result.name       = name;
+        result.iterations = batch;
+        result.nsPerOp    = 1e300;
+
+        for (unsigned repeat = 0; repeat < std::max(1u, mOptions.repeats); repeat++)
+        {
+            const auto start = Clock::now();
+            for (std::uint64_t index = 0; index < batch; index++)
+                body();
+
+            const double nsPerOp = ElapsedNs(start) / batch;
+            result.nsPerOp      = std::min(result.nsPerOp, nsPerOp);
+            result.nsPerOpMean += nsPerOp / std::max(1u, mOptions.repeats);
+        }
+
+        std::cerr << name << ": " << result.nsPerOp << " ns/op" << std::endl;
+        mResults.push_back(result);
+        return mResults.back();
+    }
+
+    Result& Suite::Report(const std::string& name, std::uint64_t iterations, double totalNs)
+    {
+        Result result;
+        result.name        = name;
+        result.iterations  = iterations;
+        result.nsPerOp     = iterations ? totalNs / iterations : 0.0;
+        result.nsPerOpMean = result.nsPerOp;
+
+        std::cerr << name << ": " << result.nsPerOp << " ns/op" << std::endl;
+        mResults.push_back(result);
+        return mResults.back();
+    }
+
+    std::string Suite::ToJSON(const std::string& label) const
+    {
+        std::ostringstream json;
+        json << "{\n  \"benchmark\": \"cpu_bench\",\n  \"label\": \"" << label << "\",\n  \"results\": [";
+
+        for (size_t index = 0; index < mResults.size(); index++)
+        {
+            const Result& result = mResults[index];
+            json << (index ? "," : "") << "\n    {\"name\": \"" << result.name << "\""
+                 << ", \"iterations\": " << result.iterations
+                 << ", \"ns_per_op\": " << result.nsPerOp
+                 << ", \"ns_per_op_mean\": " << result.nsPerOpMean;
+
+            for (const auto& counter: result.counters)
+                json << ", \"" << counter.first << "\": " << counter.second;
+
+            json << "}";
+        }
+
+        json << "\n  ]\n}\n";
+        return json.str();
+    }
+}
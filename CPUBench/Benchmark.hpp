@@ -0,0 +1,80 @@
+//
+//  Benchmark.hpp
+//  cpu_bench
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef Benchmark_hpp
+#define Benchmark_hpp
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+    struct Result
+    {
+        std::string                   name;
+        std::uint64_t                 iterations{};
+        double                        nsPerOp{};       /* best of the repeats */
+        double                        nsPerOpMean{};
+        std::map<std::string, double> counters;        /* extra metrics, e.g. "MB/s", "allocations" */
+    };
+
+    struct Options
+    {
+        std::string resourceRoot = "../../../res/";
+        std::string modelsDirectory;                    /* import-throughput pass, defaults to <res>/Models */
+        std::string filter;                             /* only run benchmarks whose name contains this */
+        double      minTimeSeconds = 0.2;
+        unsigned    repeats        = 5;
+    };
+
+    /* Keeps the optimiser from dropping the computation that produced `value`. */
+    template <typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    class Suite
+    {
+    public:
+        explicit Suite(const Options& options): mOptions(options) {}
+
+        const Options& GetOptions() const { return mOptions; }
+        bool Enabled(const std::string& name) const;
+
+        /* Runs `body` in batches until minTimeSeconds elapsed, `repeats` times. body() is one operation. */
+        Result& Run(const std::string& name, const std::function<void()>& body);
+
+        /* For things that can only run once per measurement (file imports etc.), caller reports the time. */
+        Result& Report(const std::string& name, std::uint64_t iterations, double totalNs);
+
+        const std::vector<Result>& GetResults() const { return mResults; }
+        std::string ToJSON(const std::string& label) const;
+
+    private:
+        Options             mOptions;
+        std::vector<Result> mResults;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    inline double ElapsedNs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    /* Counted by the global operator new replacement in main.cpp. */
+    std::uint64_t GetAllocationCount();
+    std::uint64_t GetAllocatedBytes();
+}
+
+#endif /* Benchmark_hpp */
@@ -0,0 +1,1310 @@
+//
+//  main.cpp
+//  cpu_bench
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+//  Times the CPU-only hot paths of the viewer (model import, bounding boxes, model matrices, shader parsing,
+//  texture decode) without a GL context and prints the results as JSON.
+//
+//  cpu_bench [--res ../../../res/] [--models-dir <res>/Models] [--filter name] [--min-time 0.2]
+//            [--repeats 5] [--label commit] [--output result.json]
+//
+
+#include "Benchmark.hpp"
+
+#include "ClusteredLighting.hpp"
+#include "BlockCompression.hpp"
+#include "Mipmap.hpp"
+#include "CommonUtils.hpp"
+#include "Frustum.hpp"
+#include "OcclusionCulling.hpp"
+#include "SceneBVH.hpp"
+#include "SceneGraph.hpp"
+#include "SceneRenderHelper.hpp"
+#include "Profiler.hpp"
+#include "Shader.hpp"
+#include "TextureStreamer.hpp"
+#include "Transforms.hpp"
+#include "ThreadPool.hpp"
+#include "TriangleBVH.hpp"
+#include "TriangleMesh.hpp"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <random>
+#include <sys/stat.h>
+
+namespace
+{
+    std::atomic<std::uint64_t> gAllocationCount{0};
+    std::atomic<std::uint64_t> gAllocatedBytes{0};
+}
+
+/* Count every heap allocation of the process, so imports can report how many they make. */
+void* operator new(std::size_t size)
+{
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+    if (void* pointer = std::malloc(size ? size : 1))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace Benchmark
+{
+    std::uint64_t GetAllocationCount() { return gAllocationCount.load(std::memory_order_relaxed); }
+    std::uint64_t GetAllocatedBytes()  { return gAllocatedBytes.load(std::memory_order_relaxed); }
+}
+
+namespace
+{
+    struct CommandLine
+    {
+        Benchmark::Options options;
+        std::string        label = "local";
+        std::string        output;
+    };
+
+    CommandLine ParseOptions(int argc, const char* argv[])
+    {
+        CommandLine commandLine;
+        Benchmark::Options& options = commandLine.options;
+
+        for (int index = 1; index < argc; index++)
+        {
+            const std::string arg = argv[index];
+            if (index + 1 >= argc)
+                throw std::runtime_error("Missing value for " + arg);
+
+            const std::string value = argv[++index];
+
+            if (arg == "--res")               options.resourceRoot    = value;
+            else if (arg == "--models-dir")   options.modelsDirectory = value;
+            else if (arg == "--filter")       options.filter          = value;
+            else if (arg == "--min-time")     options.minTimeSeconds  = std::stod(value);
+            else if (arg == "--repeats")      options.repeats         = static_cast<unsigned>(std::stoul(value));
+            else if (arg == "--label")        commandLine.label       = value;
+            else if (arg == "--output")       commandLine.output      = value;
+            else throw std::runtime_error("Unknown option " + arg);
+        }
+
+        if (options.modelsDirectory.empty())
+            options.modelsDirectory = options.resourceRoot + "Models";
+
+        return commandLine;
+    }
+
+    std::uint64_t FileSize(const std::string& path)
+    {
+        struct stat info{};
+        return stat(path.c_str(), &info) == 0 ? static_cast<std::uint64_t>(info.st_size) : 0;
+    }
+
+    bool IsModelFile(const std::string& path)
+    {
+        static const char* kExtensions[] = {".obj", ".fbx", ".dae", ".gltf", ".glb", ".3ds", ".ply", ".stl"};
+
+        const auto dot = path.find_last_of('.');
+        if (dot == std::string::npos)
+            return false;
+
+        std::string extension = path.substr(dot);
+        for (auto& character: extension)
+            character = static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+
+        for (const char* known: kExtensions)
+            if (extension == known)
+                return true;
+
+        return false;
+    }
+
+    void FindModels(const std::string& directory, std::vector<std::string>& models)
+    {
+        DIR* handle = opendir(directory.c_str());
+        if (!handle)
+            return;
+
+        while (const dirent* entry = readdir(handle))
+        {
+            const std::string name = entry->d_name;
+            if (name == "." || name == "..")
+                continue;
+
+            const std::string path = directory + "/" + name;
+
+            struct stat info{};
+            if (stat(path.c_str(), &info) != 0)
+                continue;
+
+            if (S_ISDIR(info.st_mode))
+                FindModels(path, models);
+            else if (IsModelFile(path))
+                models.push_back(path);
+        }
+
+        closedir(handle);
+        std::sort(models.begin(), models.end());
+    }
+
+    /* Sums the profiler zones recorded since `sinceNs`, keyed by zone name. */
+    std::map<std::string, double> StageTimes(std::uint64_t sinceNs)
+    {
+        std::map<std::string, double> stages;
+        for (const Profiler::Zone& zone: Profiler::CollectZones())
+            if (zone.startNs >= sinceNs)
+                stages[zone.name] += static_cast<double>(zone.endNs - zone.startNs);
+
+        return stages;
+    }
+
+    void RunImportBenchmarks(Benchmark::Suite& suite)
+    {
+        const std::string& root = suite.GetOptions().resourceRoot;
+        const std::vector<std::pair<std::string, std::string>> models = {
+            {"Ivysaur",     root + "Models/Ivysaur_OBJ/Pokemon.obj"},
+            {"GroundPlane", root + "Models/GroundPlane/GroundPlane.obj"},
+            {"Light",       root + "Models/Light/Light.obj"},
+            {"Cube",        root + "Models/Cube.obj"},
+            {"Sphere",      root + "Models/Sphere.obj"},
+        };
+
+        const unsigned repeats = std::max(1u, suite.GetOptions().repeats);
+
+        for (const auto& model: models)
+        {
+            const std::string name = "TriangleMesh::Import/" + model.first;
+            if (!suite.Enabled(name))
+                continue;
+
+            /* Imports are slow and allocate a lot, time each one instead of batching. */
+            double best = 1e300;
+            std::map<std::string, double> bestStages;
+            std::uint64_t allocations = 0;
+
+            for (unsigned repeat = 0; repeat < repeats; repeat++)
+            {
+                const std::uint64_t allocationsBefore = Benchmark::GetAllocationCount();
+                const std::uint64_t since = Profiler::NowNs();
+                const auto start = Benchmark::Clock::now();
+
+                TriangleMesh mesh(model.second);
+                Benchmark::DoNotOptimize(mesh.GetNumberOfMeshes());
+
+                const double elapsed = Benchmark::ElapsedNs(start);
+                const std::uint64_t importAllocations = Benchmark::GetAllocationCount() - allocationsBefore;
+
+                if (elapsed < best)
+                {
+                    best        = elapsed;
+                    bestStages  = StageTimes(since);
+                    allocations = importAllocations;
+                }
+            }
+
+            Benchmark::Result& result = suite.Report(name, 1, best);
+            result.counters["allocations"] = static_cast<double>(allocations);
+            for (const auto& stage: bestStages)
+                result.counters["stage_ns/" + stage.first] = stage.second;
+        }
+    }
+
+    void RunBoundingBoxBenchmarks(Benchmark::Suite& suite)
+    {
+        const std::string& root = suite.GetOptions().resourceRoot;
+
+        const std::vector<TriangleMesh> meshes = {
+            TriangleMesh(root + "Models/Ivysaur_OBJ/Pokemon.obj"),
+            TriangleMesh(root + "Models/GroundPlane/GroundPlane.obj"),
+            TriangleMesh(root + "Models/Light/Light.obj"),
+        };
+
+        const TriangleMesh& object = meshes.front();
+
+        std::vector<std::vector<float>> positions;
+        for (const auto& mesh: object.GetModelMesh())
+            positions.push_back(mesh.second.mPositions);
+
+        const std::vector<float>& largest = *std::max_element(positions.begin(), positions.end(),
+            [](const std::vector<float>& a, const std::vector<float>& b) { return a.size() < b.size(); });
+
+        std::vector<CommonUtils::BBCoord> boxes;
+        for (const auto& vertices: positions)
+            boxes.push_back(CommonUtils::GetBBox(vertices));
+
+        if (suite.Enabled("GetBBox/positions"))
+        {
+            auto& result = suite.Run("GetBBox/positions", [&] { Benchmark::DoNotOptimize(CommonUtils::GetBBox(largest)); });
+            result.counters["vertices"] = static_cast<double>(largest.size() / 3);
+        }
+
+        if (suite.Enabled("GetBBox/boxes"))
+            suite.Run("GetBBox/boxes", [&] { Benchmark::DoNotOptimize(CommonUtils::GetBBox(boxes)); });
+
+        if (suite.Enabled("GetBBox/TriangleMesh"))
+            suite.Run("GetBBox/TriangleMesh", [&] { Benchmark::DoNotOptimize(CommonUtils::GetBBox(object)); });
+
+        if (suite.Enabled("GetBBox/TriangleMeshes"))
+            suite.Run("GetBBox/TriangleMeshes", [&] { Benchmark::DoNotOptimize(CommonUtils::GetBBox(meshes)); });
+
+        if (suite.Enabled("GetBBox/positionsVector"))
+            suite.Run("GetBBox/positionsVector", [&] { Benchmark::DoNotOptimize(CommonUtils::GetBBox(positions)); });
+
+        if (suite.Enabled("ModelMatrix::GetMatrix"))
+        {
+            CommonUtils::ModelMatrix modelMatrix(CommonUtils::GetBBox(meshes), CommonUtils::GetBBox(object));
+            modelMatrix.fScale = glm::vec3(5.0f);
+
+            float angle = 0.0f;
+            suite.Run("ModelMatrix::GetMatrix", [&] {
+                modelMatrix.fAngle.y = (angle += 0.01f);
+                Benchmark::DoNotOptimize(modelMatrix.GetMatrix());
+            });
+        }
+    }
+
+    void RunShaderBenchmarks(Benchmark::Suite& suite)
+    {
+        const std::string& root = suite.GetOptions().resourceRoot;
+
+        for (const std::string shader: {"ModelObject", "LightObject", "Framebuffer"})
+        {
+            const std::string name = "Shader::ParseShader/" + shader;
+            const std::string path = root + "Shaders/" + shader + ".shader";
+
+            if (!suite.Enabled(name) || FileSize(path) == 0)
+                continue;
+
+            suite.Run(name, [&] { Benchmark::DoNotOptimize(Shader::ParseShader(path)); });
+        }
+    }
+
+    void RunTextureBenchmarks(Benchmark::Suite& suite)
+    {
+        const std::string directory = suite.GetOptions().resourceRoot + "Models/Ivysaur_OBJ/";
+
+        for (const std::string texture: {"Diffuse", "Specular", "Normal", "Glossiness", "Emissive", "Ambient_Occlusion"})
+        {
+            const std::string name = "stbi_load/Ivysaur_" + texture;
+            const std::string path = directory + "Final_Pokemon_" + texture + ".jpg";
+
+            if (!suite.Enabled(name) || FileSize(path) == 0)
+                continue;
+
+            int width = 0, height = 0, channels = 0;
+
+            /* Same flags the Texture class uses. */
+            stbi_set_flip_vertically_on_load_thread(true);
+            auto& result = suite.Run(name, [&] {
+                unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 0);
+                Benchmark::DoNotOptimize(pixels);
+                stbi_image_free(pixels);
+            });
+
+            result.counters["megapixels_per_s"] = width * height / result.nsPerOp * 1e3;
+        }
+
+        /* The whole set, as SceneRenderer's TextureStreamer decodes it: one file per pool task. */
+        if (!suite.Enabled("TextureStreamer::Decode"))
+            return;
+
+        std::vector<std::string> paths;
+        for (const std::string texture: {"Diffuse", "Specular", "Normal", "Glossiness", "Emissive", "Ambient_Occlusion"})
+            if (FileSize(directory + "Final_Pokemon_" + texture + ".jpg"))
+                paths.push_back(directory + "Final_Pokemon_" + texture + ".jpg");
+
+        if (paths.empty())
+            return;
+
+        std::vector<TextureStreamer::Image> images(paths.size());
+        auto decode = [&](size_t begin, size_t end) {
+            for (size_t index = begin; index < end; index++)
+                images[index] = TextureStreamer::Decode(paths[index]);
+        };
+
+        suite.Run("TextureStreamer::Decode/Ivysaur/serial", [&] { decode(0, paths.size()); });
+        auto& parallel = suite.Run("TextureStreamer::Decode/Ivysaur", [&] { ThreadPool::Shared().ParallelFor(paths.size(), 1, decode); });
+        parallel.counters["files"]   = static_cast<double>(paths.size());
+        parallel.counters["threads"] = ThreadPool::Shared().GetThreadCount() + 1.0;
+    }
+
+    /*
+     * BC encoding of the Ivysaur diffuse map with its mip chain, serial and on the pool. The SSE2 BC1 and BC4 kernels
+     * have to match the scalar ones on every block of the image, PSNR of level 0 shows the quality.
+     */
+    bool RunBlockCompressionBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("BlockCompression"))
+            return true;
+
+        const std::string path = suite.GetOptions().resourceRoot + "Models/Ivysaur_OBJ/Final_Pokemon_Diffuse.jpg";
+        const TextureStreamer::Image source = TextureStreamer::Decode(path);
+        if (!source.pixels)
+            return true;
+
+        const int width = source.width, height = source.height, channels = source.channels;
+        auto texel = [&](int x, int y, int channel) {
+            x = std::min(x, width - 1);
+            y = std::min(y, height - 1);
+            return channel < channels ? source.pixels.get()[(static_cast<size_t>(y) * width + x) * channels + channel] : 255;
+        };
+
+        for (int blockY = 0; blockY < (height + 3) / 4; blockY++)
+            for (int blockX = 0; blockX < (width + 3) / 4; blockX++)
+            {
+                unsigned char texels[64], simd[8], scalar[8];
+                for (int index = 0; index < 64; index++)
+                    texels[index] = static_cast<unsigned char>(texel(4 * blockX + index / 4 % 4, 4 * blockY + index / 16, index % 4));
+
+                BlockCompression::EncodeBC1Block(texels, simd);
+                BlockCompression::EncodeBC1BlockScalar(texels, scalar);
+                if (std::memcmp(simd, scalar, sizeof(simd)) != 0)
+                {
+                    std::cerr << "BlockCompression: SIMD BC1 block " << blockX << ", " << blockY << " differs from the scalar one" << std::endl;
+                    return false;
+                }
+
+                for (int channel = 0; channel < 4; channel++)
+                {
+                    BlockCompression::EncodeBC4Block(texels, channel, simd);
+                    BlockCompression::EncodeBC4BlockScalar(texels, channel, scalar);
+                    if (std::memcmp(simd, scalar, sizeof(simd)) != 0)
+                    {
+                        std::cerr << "BlockCompression: SIMD BC4 block " << blockX << ", " << blockY << " channel " << channel << " differs from the scalar one" << std::endl;
+                        return false;
+                    }
+                }
+            }
+
+        const double megapixels = width * height / 1e6;
+
+        /* Encoding only, the mips are built once up front. */
+        const auto levels = Mipmap::Layout(width, height, channels);
+        std::vector<unsigned char> chain(Mipmap::GetByteSize(levels, channels));
+        std::memcpy(chain.data(), source.pixels.get(), static_cast<size_t>(width) * height * channels);
+        Mipmap::Generate(chain.data(), levels, channels, true, &ThreadPool::Shared());
+
+        for (const auto format: {BlockCompression::Format::BC1, BlockCompression::Format::BC3, BlockCompression::Format::BC4, BlockCompression::Format::BC5})
+        {
+            const std::string name = std::string("BlockCompression::Compress/") + BlockCompression::GetName(format);
+
+            BlockCompression::Image image;
+            auto& serial = suite.Run(name + "/serial", [&] { image = BlockCompression::Compress(chain.data(), levels, channels, format, nullptr); });
+            serial.counters["megapixels_per_s"] = megapixels / serial.nsPerOp * 1e9;
+
+            auto& pooled = suite.Run(name, [&] { image = BlockCompression::Compress(chain.data(), levels, channels, format, &ThreadPool::Shared()); });
+            pooled.counters["megapixels_per_s"] = megapixels / pooled.nsPerOp * 1e9;
+            pooled.counters["threads"]          = ThreadPool::Shared().GetThreadCount() + 1.0;
+            pooled.counters["bytes"]            = static_cast<double>(image.GetByteSize());
+            pooled.counters["ratio"]            = static_cast<double>(width) * height * channels * 4 / 3 / image.GetByteSize();
+
+            /* Over the channels the format keeps. */
+            const int kept = format == BlockCompression::Format::BC4 ? 1 : format == BlockCompression::Format::BC5 ? 2 : std::min(channels, 3);
+            const BlockCompression::Level& level = image.levels[0];
+            const int blocksX = (width + 3) / 4;
+            double squaredError = 0.0;
+            for (int blockY = 0; blockY < (height + 3) / 4; blockY++)
+                for (int blockX = 0; blockX < blocksX; blockX++)
+                {
+                    unsigned char decoded[64];
+                    BlockCompression::DecodeBlock(format, &level.data[(blockY * blocksX + blockX) * BlockCompression::GetBlockBytes(format)], decoded);
+                    for (int index = 0; index < 16; index++)
+                        for (int channel = 0; channel < kept; channel++)
+                        {
+                            const double error = decoded[4 * index + channel] - texel(4 * blockX + index % 4, 4 * blockY + index / 4, channel);
+                            squaredError += error * error;
+                        }
+                }
+
+            const double meanError = squaredError / (static_cast<double>(blocksX) * ((height + 3) / 4) * 16 * kept);
+            pooled.counters["psnr_db"] = meanError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanError) : 99.0;
+        }
+
+        return true;
+    }
+
+    /*
+     * Kaiser mips of the Ivysaur diffuse map, serial and on the pool, which must give the same bytes. A flat image
+     * has to stay flat all the way down. Then a texture load without the cache (decode and mips) against one
+     * mapped from it, which must hold the same chain.
+     */
+    bool RunMipmapBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("Mipmap") && !suite.Enabled("TextureCache"))
+            return true;
+
+        const std::string path = suite.GetOptions().resourceRoot + "Models/Ivysaur_OBJ/Final_Pokemon_Diffuse.jpg";
+        const TextureStreamer::Image source = TextureStreamer::Decode(path);
+        if (!source.pixels)
+            return true;
+
+        const int width = source.width, height = source.height, channels = source.channels;
+        const auto levels = Mipmap::Layout(width, height, channels);
+        const size_t levelBytes = static_cast<size_t>(width) * height * channels;
+
+        std::vector<unsigned char> serial(Mipmap::GetByteSize(levels, channels)), pooled(serial.size());
+        std::memcpy(serial.data(), source.pixels.get(), levelBytes);
+        std::memcpy(pooled.data(), source.pixels.get(), levelBytes);
+
+        const double megapixels = width * height / 1e6;
+        auto& serialResult = suite.Run("Mipmap::Generate/serial", [&] { Mipmap::Generate(serial.data(), levels, channels, true, nullptr); });
+        serialResult.counters["megapixels_per_s"] = megapixels / serialResult.nsPerOp * 1e9;
+
+        auto& pooledResult = suite.Run("Mipmap::Generate", [&] { Mipmap::Generate(pooled.data(), levels, channels, true, &ThreadPool::Shared()); });
+        pooledResult.counters["megapixels_per_s"] = megapixels / pooledResult.nsPerOp * 1e9;
+        pooledResult.counters["threads"]          = ThreadPool::Shared().GetThreadCount() + 1.0;
+        pooledResult.counters["levels"]           = static_cast<double>(levels.size());
+
+        if (serial != pooled)
+        {
+            std::cerr << "Mipmap: pooled mips differ from the serial ones" << std::endl;
+            return false;
+        }
+
+        const auto flatLevels = Mipmap::Layout(37, 19, 4);
+        std::vector<unsigned char> flat(Mipmap::GetByteSize(flatLevels, 4), 0);
+        for (size_t index = 0; index < static_cast<size_t>(37) * 19 * 4; index++)
+            flat[index] = index % 4 == 3 ? 77 : 200;
+        Mipmap::Generate(flat.data(), flatLevels, 4, true, nullptr);
+        for (size_t index = 0; index < flat.size(); index++)
+            if (flat[index] != (index % 4 == 3 ? 77 : 200))
+            {
+                std::cerr << "Mipmap: flat image changed at byte " << index << std::endl;
+                return false;
+            }
+
+        TextureStreamer::Image cold, warm;
+        auto& coldResult = suite.Run("TextureCache/cold", [&] { cold = TextureStreamer::Prepare(path, false, true, false); });
+        coldResult.counters["megapixels_per_s"] = megapixels / coldResult.nsPerOp * 1e9;
+
+        /* Writes the entry if it isn't there yet. */
+        TextureStreamer::Prepare(path, false, true, true);
+        auto& warmResult = suite.Run("TextureCache/warm", [&] { warm = TextureStreamer::Prepare(path, false, true, true); });
+        warmResult.counters["megapixels_per_s"] = megapixels / warmResult.nsPerOp * 1e9;
+        warmResult.counters["speedup"]          = coldResult.nsPerOp / warmResult.nsPerOp;
+        warmResult.counters["mapped"]           = warm.mapping ? 1.0 : 0.0;
+
+        suite.Run("TextureCache::HashFile", [&] { Benchmark::DoNotOptimize(TextureCache::HashFile(path)); });
+
+        if (warm.IsEmpty() || cold.IsEmpty() || std::memcmp(warm.chain, cold.chain, serial.size()) != 0 ||
+            std::memcmp(cold.chain, serial.data(), serial.size()) != 0)
+        {
+            std::cerr << "TextureCache: cached chain differs from a fresh one" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    constexpr size_t kSyntheticBoxes = 100000;
+
+    /* Random boxes scattered around the origin, same set on every run. */
+    std::vector<CommonUtils::BBCoord> SyntheticBoxes(size_t count)
+    {
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+        std::uniform_real_distribution<float> extent(0.1f, 10.0f);
+
+        std::vector<CommonUtils::BBCoord> boxes;
+        boxes.reserve(count);
+        for (size_t index = 0; index < count; index++)
+        {
+            const glm::vec3 center(position(random), position(random), position(random));
+            const glm::vec3 halfSize(extent(random), extent(random), extent(random));
+            boxes.push_back({center - halfSize, center + halfSize});
+        }
+
+        return boxes;
+    }
+
+    /* Viewer's default camera distance, looking at the origin. */
+    Culling::Frustum SyntheticFrustum()
+    {
+        const glm::mat4 proj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 60.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        return Culling::Frustum::FromMatrix(proj * view);
+    }
+
+    /* 100k random boxes around the camera. SIMD and scalar kernels have to agree box for box. */
+    bool RunCullingBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("CullAABBs"))
+            return true;
+
+        constexpr size_t kBoxes = kSyntheticBoxes;
+
+        Culling::AABBList boxes;
+        boxes.Reserve(kBoxes);
+        for (const auto& box: SyntheticBoxes(kBoxes))
+            boxes.Add(box);
+
+        const Culling::Frustum frustum = SyntheticFrustum();
+
+        std::vector<unsigned char> visibleSimd, visibleScalar;
+        const size_t countSimd   = Culling::CullAABBs(frustum, boxes, visibleSimd);
+        const size_t countScalar = Culling::CullAABBsScalar(frustum, boxes, visibleScalar);
+
+        if (countSimd != countScalar || visibleSimd != visibleScalar)
+        {
+            std::cerr << "CullAABBs: SIMD kernel disagrees with the scalar one (" << countSimd << " vs " << countScalar << " visible)" << std::endl;
+            return false;
+        }
+
+        /* A box straddling a plane, one fully outside, and one at the eye. */
+        Culling::AABBList edgeCases;
+        edgeCases.Add({glm::vec3(-1.0f, -1.0f, -45.0f), glm::vec3(1.0f, 1.0f, -35.0f)});
+        edgeCases.Add({glm::vec3(-1.0f, -1.0f, 70.0f),  glm::vec3(1.0f, 1.0f, 80.0f)});
+        edgeCases.Add({glm::vec3(-1.0f, -1.0f, 59.0f),  glm::vec3(1.0f, 1.0f, 61.0f)});
+
+        std::vector<unsigned char> edgeVisible;
+        Culling::CullAABBs(frustum, edgeCases, edgeVisible);
+        if (edgeVisible != std::vector<unsigned char>{1, 0, 1})
+        {
+            std::cerr << "CullAABBs: wrong result for the edge cases" << std::endl;
+            return false;
+        }
+
+        auto& simd = suite.Run("CullAABBs/100k", [&] { Benchmark::DoNotOptimize(Culling::CullAABBs(frustum, boxes, visibleSimd)); });
+        simd.counters["visible"]      = static_cast<double>(countSimd);
+        simd.counters["Mboxes_per_s"] = kBoxes / simd.nsPerOp * 1e3;
+
+        auto& scalar = suite.Run("CullAABBs/100k/scalar", [&] { Benchmark::DoNotOptimize(Culling::CullAABBsScalar(frustum, boxes, visibleScalar)); });
+        scalar.counters["Mboxes_per_s"] = kBoxes / scalar.nsPerOp * 1e3;
+
+        return true;
+    }
+
+    /* BVH over the same 100k boxes. Its frustum query has to return exactly what the linear kernel does. */
+    bool RunSceneBVHBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("SceneBVH"))
+            return true;
+
+        std::vector<CommonUtils::BBCoord> boxes = SyntheticBoxes(kSyntheticBoxes);
+        const Culling::Frustum frustum = SyntheticFrustum();
+
+        SceneBVH bvh;
+        auto& build = suite.Run("SceneBVH::Build/100k", [&] { bvh.Build(boxes); });
+        build.counters["nodes"]    = static_cast<double>(bvh.GetNodeCount());
+        build.counters["sah_cost"] = bvh.GetCost();
+
+        Culling::AABBList list;
+        for (const auto& box: boxes)
+            list.Add(box);
+
+        std::vector<unsigned char> visible;
+        Culling::CullAABBs(frustum, list, visible);
+
+        std::vector<SceneBVH::ObjectID> objects;
+        bvh.QueryFrustum(frustum, objects);
+
+        std::vector<unsigned char> visibleBVH(boxes.size(), 0);
+        for (const auto object: objects)
+            visibleBVH[object] = 1;
+
+        if (visibleBVH != visible)
+        {
+            std::cerr << "SceneBVH: frustum query disagrees with the linear kernel" << std::endl;
+            return false;
+        }
+
+        auto& query = suite.Run("SceneBVH::QueryFrustum/100k", [&] { bvh.QueryFrustum(frustum, objects); Benchmark::DoNotOptimize(objects.size()); });
+        query.counters["visible"] = static_cast<double>(objects.size());
+
+        std::vector<SceneBVH::RayHit> hits;
+        suite.Run("SceneBVH::QueryRay/100k", [&] {
+            bvh.QueryRay(glm::vec3(0.0f, 0.0f, 300.0f), glm::vec3(0.0f, 0.0f, -1.0f), hits);
+            Benchmark::DoNotOptimize(hits.size());
+        });
+
+        suite.Run("SceneBVH::QueryOverlap/100k", [&] {
+            bvh.QueryOverlap({glm::vec3(-20.0f), glm::vec3(20.0f)}, objects);
+            Benchmark::DoNotOptimize(objects.size());
+        });
+
+        /* Move 1% of the objects per "frame", rebuilds happen in the background when the tree degrades. */
+        std::mt19937 random(99);
+        std::uniform_int_distribution<size_t> pick(0, boxes.size() - 1);
+        std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+
+        auto& refit = suite.Run("SceneBVH::Update+Commit/1k", [&] {
+            for (size_t moved = 0; moved < boxes.size() / 100; moved++)
+            {
+                const size_t object = pick(random);
+                const glm::vec3 delta(offset(random), offset(random), offset(random));
+                boxes[object] = {boxes[object].Min + delta, boxes[object].Max + delta};
+                bvh.Update(static_cast<SceneBVH::ObjectID>(object), boxes[object]);
+            }
+            bvh.Commit();
+        });
+        refit.counters["rebuilds"] = bvh.GetRebuildCount();
+
+        return true;
+    }
+
+    /* The model matrix as it was composed before the cache: five 4x4 matrices and four products, every call. */
+    glm::mat4 ComposeModelMatrix(const glm::vec3& center, const glm::vec3& angle, const glm::vec3& translation, const glm::vec3& scale)
+    {
+        auto TranslateToOrigin  = glm::translate(glm::identity<glm::mat4>(), -center);
+        auto Scale              = glm::scale(glm::identity<glm::mat4>(), scale);
+        auto Rotate             = glm::eulerAngleXYZ(angle.x, angle.y, angle.z);
+        auto Translate          = glm::translate(glm::identity<glm::mat4>(), translation);
+        auto TranslateToInitial = glm::translate(glm::identity<glm::mat4>(), center);
+
+        return TranslateToInitial * Translate * Rotate * Scale * TranslateToOrigin;
+    }
+
+    bool RunTransformBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("Transforms"))
+            return true;
+
+        const size_t count = 10000;
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> position(-50.0f, 50.0f), angle(0.0f, 6.28f), scale(0.5f, 2.0f);
+
+        const CommonUtils::BBCoord span{glm::vec3(-1.0f), glm::vec3(1.0f)};
+        std::vector<CommonUtils::ModelMatrix> objects;
+        objects.reserve(count);
+        for (size_t index = 0; index < count; index++)
+        {
+            CommonUtils::ModelMatrix object(span, {glm::vec3(-1.0f, 0.0f, -1.0f), glm::vec3(1.0f, 2.0f, 1.0f)});
+            object.fAngle       = glm::vec3(angle(random), angle(random), angle(random));
+            object.fTranslation = glm::vec3(position(random), position(random), position(random));
+            object.fScale       = glm::vec3(scale(random));
+            objects.push_back(object);
+        }
+
+        const glm::vec3 center(0.0f, 1.0f, 0.0f);
+        const glm::mat4 viewProj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+                                   glm::lookAt(glm::vec3(0.0f, 20.0f, 60.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        std::vector<glm::mat4> models(count), mvps(count), reference(count);
+
+        /* The cache and the closed form against the old composition, the kernel against glm. */
+        for (size_t index = 0; index < count; index++)
+        {
+            const CommonUtils::ModelMatrix& object = objects[index];
+            const glm::mat4 composed = ComposeModelMatrix(center, object.fAngle, object.fTranslation, object.fScale);
+            const glm::mat3 normal = glm::transpose(glm::inverse(glm::mat3(composed)));
+            for (int column = 0; column < 4; column++)
+                for (int row = 0; row < 4; row++)
+                    if (std::abs(composed[column][row] - object.GetMatrix()[column][row]) > 1e-3f ||
+                        (column < 3 && row < 3 && std::abs(normal[column][row] - object.GetNormalMatrix()[column][row]) > 1e-3f))
+                    {
+                        std::cerr << "Transforms: cached model matrix " << index << " disagrees with the composed one" << std::endl;
+                        return false;
+                    }
+            models[index] = object.GetMatrix();
+        }
+
+        Transforms::MultiplyMatrices(viewProj, models.data(), mvps.data(), count);
+        Transforms::MultiplyMatricesScalar(viewProj, models.data(), reference.data(), count);
+        for (size_t index = 0; index < count; index++)
+            for (int column = 0; column < 4; column++)
+                if (glm::any(glm::greaterThan(glm::abs(mvps[index][column] - reference[index][column]), glm::vec4(1e-4f * (1.0f + glm::length(reference[index][column]))))))
+                {
+                    std::cerr << "Transforms: batched MVP " << index << " disagrees with glm" << std::endl;
+                    return false;
+                }
+
+        /* Before: every object composed again and multiplied one at a time, every frame. */
+        auto& before = suite.Run("Transforms::ComposeAndMVP/10k", [&] {
+            for (size_t index = 0; index < count; index++)
+            {
+                const CommonUtils::ModelMatrix& object = objects[index];
+                mvps[index] = viewProj * ComposeModelMatrix(center, object.fAngle, object.fTranslation, object.fScale);
+            }
+            Benchmark::DoNotOptimize(mvps.back());
+        });
+        before.counters["objects"] = count;
+
+        /* After, nothing moved: cached matrices, one batched kernel. */
+        auto& cached = suite.Run("Transforms::CachedAndBatchedMVP/10k", [&] {
+            for (size_t index = 0; index < count; index++)
+                models[index] = objects[index].GetMatrix();
+            Transforms::MultiplyMatrices(viewProj, models.data(), mvps.data(), count);
+            Benchmark::DoNotOptimize(mvps.back());
+        });
+        cached.counters["objects"] = count;
+
+        /* After, everything moved: the closed form recomposes, normal matrices included. */
+        float spin = 0.0f;
+        auto& moved = suite.Run("Transforms::RecomposedAndBatchedMVP/10k", [&] {
+            spin += 0.01f;
+            for (size_t index = 0; index < count; index++)
+            {
+                objects[index].fAngle.y = spin;
+                models[index] = objects[index].GetMatrix();
+            }
+            Transforms::MultiplyMatrices(viewProj, models.data(), mvps.data(), count);
+            Benchmark::DoNotOptimize(mvps.back());
+        });
+        moved.counters["objects"] = count;
+
+        suite.Run("Transforms::MultiplyMatricesScalar/10k", [&] {
+            Transforms::MultiplyMatricesScalar(viewProj, models.data(), mvps.data(), count);
+            Benchmark::DoNotOptimize(mvps.back());
+        });
+
+        suite.Run("Transforms::MultiplyMatrices/10k", [&] {
+            Transforms::MultiplyMatrices(viewProj, models.data(), mvps.data(), count);
+            Benchmark::DoNotOptimize(mvps.back());
+        });
+
+        suite.Run("Transforms::MultiplyMatrices/10k/pool", [&] {
+            Transforms::MultiplyMatrices(viewProj, models.data(), mvps.data(), count, &ThreadPool::Shared());
+            Benchmark::DoNotOptimize(mvps.back());
+        });
+
+        return true;
+    }
+
+    /* Four children a node, level by level, every node a little rotated and moved from its parent. */
+    SceneGraph SyntheticSceneGraph(unsigned int nodes)
+    {
+        SceneGraph graph;
+        for (unsigned int node = 0; node < nodes; node++)
+        {
+            const glm::mat4 local = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 0.5f, 0.0f)), 0.01f * (node % 7), glm::vec3(0.0f, 1.0f, 0.0f));
+            graph.AddNode(node ? (node - 1) / 4 : SceneGraph::kNone, local);
+        }
+        return graph;
+    }
+
+    bool RunSceneGraphBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("SceneGraph"))
+            return true;
+
+        const unsigned int nodes = 10000;
+        SceneGraph graph = SyntheticSceneGraph(nodes);
+        graph.Update();
+
+        /* What every frame cost before: all world matrices again. */
+        std::vector<glm::mat4> world(nodes);
+        auto computeAll = [&] {
+            for (SceneGraph::NodeID node = 0; node < nodes; node++)
+            {
+                const SceneGraph::NodeID parent = graph.GetParent(node);
+                world[node] = parent == SceneGraph::kNone ? graph.GetLocalTransform(node) : world[parent] * graph.GetLocalTransform(node);
+            }
+        };
+
+        /* A node two levels down, a sixteenth of the tree hangs below it. */
+        const SceneGraph::NodeID moved = 5;
+        float angle = 0.0f;
+        auto moveNode = [&] {
+            angle += 0.01f;
+            graph.SetLocalTransform(moved, glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 0.0f, 1.0f)));
+        };
+
+        moveNode();
+        const size_t updated = graph.Update();
+        computeAll();
+        for (SceneGraph::NodeID node = 0; node < nodes; node++)
+        {
+            if (world[node] != graph.GetWorldTransform(node))
+            {
+                std::cerr << "SceneGraph: world transform of node " << node << " disagrees with a full pass" << std::endl;
+                return false;
+            }
+        }
+
+        auto& full = suite.Run("SceneGraph::AllNodes/10k", [&] { computeAll(); Benchmark::DoNotOptimize(world.back()); });
+        full.counters["nodes"] = nodes;
+
+        auto& subtree = suite.Run("SceneGraph::Update/subtree", [&] { moveNode(); Benchmark::DoNotOptimize(graph.Update()); });
+        subtree.counters["updated"] = static_cast<double>(updated);
+
+        suite.Run("SceneGraph::Update/clean", [&] { Benchmark::DoNotOptimize(graph.Update()); });
+
+        auto& root = suite.Run("SceneGraph::Update/root", [&] {
+            angle += 0.01f;
+            graph.SetLocalTransform(0, glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+            Benchmark::DoNotOptimize(graph.Update());
+        });
+        root.counters["updated"] = nodes;
+
+        return true;
+    }
+
+    /* 20x20 wall at the origin facing the default camera. */
+    Culling::Occluder WallOccluder()
+    {
+        Culling::Occluder wall;
+        wall.positions = {-10.0f, -10.0f, 0.0f,   10.0f, -10.0f, 0.0f,   10.0f, 10.0f, 0.0f,   -10.0f, 10.0f, 0.0f};
+        wall.indices   = {0, 1, 2,   0, 2, 3};
+        return wall;
+    }
+
+    bool RunOcclusionBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("DepthRasterizer"))
+            return true;
+
+        const glm::mat4 proj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 60.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const Culling::Occluder wall = WallOccluder();
+
+        Culling::DepthRasterizer rasterizer;
+        rasterizer.Clear(proj * view);
+        rasterizer.AddOccluder(wall, glm::mat4(1.0f));
+        rasterizer.Rasterize(&ThreadPool::Shared());
+
+        /* Behind the wall, in front of it, beside it, and straddling the near plane. */
+        const bool hidden     = !rasterizer.IsVisible({glm::vec3(-1.0f, -1.0f, -21.0f), glm::vec3(1.0f, 1.0f, -19.0f)});
+        const bool inFront    =  rasterizer.IsVisible({glm::vec3(-1.0f, -1.0f, 9.0f),   glm::vec3(1.0f, 1.0f, 11.0f)});
+        const bool beside     =  rasterizer.IsVisible({glm::vec3(29.0f, -1.0f, -21.0f), glm::vec3(31.0f, 1.0f, -19.0f)});
+        const bool nearPlane  =  rasterizer.IsVisible({glm::vec3(-1.0f, -1.0f, 55.0f),  glm::vec3(1.0f, 1.0f, 65.0f)});
+        const bool peeksAbove =  rasterizer.IsVisible({glm::vec3(-1.0f, 5.0f, -21.0f),  glm::vec3(1.0f, 40.0f, -19.0f)});
+
+        if (!hidden || !inFront || !beside || !nearPlane || !peeksAbove)
+        {
+            std::cerr << "DepthRasterizer: wrong visibility for the wall test cases" << std::endl;
+            return false;
+        }
+
+        /* Single threaded and pooled results must match pixel for pixel. */
+        const std::string& root = suite.GetOptions().resourceRoot;
+        const TriangleMesh object(root + "Models/Ivysaur_OBJ/Pokemon.obj");
+        const Culling::Occluder lod = Culling::MakeSimplifiedOccluder(object, 32);
+        const glm::mat4 objectMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(5.0f));
+
+        Culling::DepthRasterizer serial;
+        serial.Clear(proj * view);
+        serial.AddOccluder(lod, objectMatrix);
+        serial.AddOccluder(wall, glm::mat4(1.0f));
+        serial.Rasterize(nullptr);
+
+        auto draw = [&](ThreadPool* pool) {
+            rasterizer.Clear(proj * view);
+            rasterizer.AddOccluder(lod, objectMatrix);
+            rasterizer.AddOccluder(wall, glm::mat4(1.0f));
+            rasterizer.Rasterize(pool);
+        };
+
+        draw(&ThreadPool::Shared());
+        for (int y = 0; y < rasterizer.GetHeight(); y++)
+            for (int x = 0; x < rasterizer.GetWidth(); x++)
+                if (rasterizer.GetDepth(x, y) != serial.GetDepth(x, y))
+                {
+                    std::cerr << "DepthRasterizer: threaded depth differs at " << x << ", " << y << std::endl;
+                    return false;
+                }
+
+        auto& pooled = suite.Run("DepthRasterizer::Rasterize/IvysaurLOD", [&] { draw(&ThreadPool::Shared()); });
+        pooled.counters["triangles"]      = static_cast<double>(rasterizer.GetTriangleCount());
+        pooled.counters["threads"]        = ThreadPool::Shared().GetThreadCount() + 1.0;
+        pooled.counters["lod_triangles"]  = lod.indices.size() / 3.0;
+        pooled.counters["full_triangles"] = Culling::MakeOccluder(object).indices.size() / 3.0;
+
+        suite.Run("DepthRasterizer::Rasterize/IvysaurLOD/serial", [&] { draw(nullptr); });
+
+        const std::vector<CommonUtils::BBCoord> boxes = SyntheticBoxes(kSyntheticBoxes);
+        size_t visible = 0;
+        auto& test = suite.Run("DepthRasterizer::IsVisible/100k", [&] {
+            visible = 0;
+            for (const auto& box: boxes)
+                visible += rasterizer.IsVisible(box);
+        });
+        test.counters["culled_fraction"] = 1.0 - double(visible) / boxes.size();
+
+        return true;
+    }
+
+    struct SyntheticMesh
+    {
+        std::vector<float>        positions;
+        std::vector<unsigned int> indices;
+    };
+
+    /* Bumpy sphere of radius ~10, 2 * cells^2 triangles. 708 cells gives just over 1M. */
+    SyntheticMesh SyntheticSphere(unsigned int cells)
+    {
+        SyntheticMesh mesh;
+        mesh.positions.reserve(3 * (cells + 1) * (cells + 1));
+        mesh.indices.reserve(6 * cells * cells);
+
+        for (unsigned int row = 0; row <= cells; row++)
+            for (unsigned int column = 0; column <= cells; column++)
+            {
+                const float theta  = glm::pi<float>() * row / cells;
+                const float phi    = 2.0f * glm::pi<float>() * column / cells;
+                const float radius = 10.0f + 0.5f * std::sin(7.0f * theta) * std::cos(5.0f * phi);
+
+                mesh.positions.insert(mesh.positions.end(), {radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi)});
+            }
+
+        for (unsigned int row = 0; row < cells; row++)
+            for (unsigned int column = 0; column < cells; column++)
+            {
+                const unsigned int a = row * (cells + 1) + column, b = a + 1, c = a + cells + 1, d = c + 1;
+                mesh.indices.insert(mesh.indices.end(), {a, c, b, b, c, d});
+            }
+
+        return mesh;
+    }
+
+    /* All meshes of a model in one triangle list. */
+    SyntheticMesh MergeMeshes(const TriangleMesh& model)
+    {
+        SyntheticMesh merged;
+        for (const auto& entry: model.GetModelMesh())
+        {
+            const unsigned int base = static_cast<unsigned int>(merged.positions.size() / 3);
+            merged.positions.insert(merged.positions.end(), entry.second.mPositions.begin(), entry.second.mPositions.end());
+            for (const auto index: entry.second.mIndices)
+                merged.indices.push_back(base + index);
+        }
+
+        return merged;
+    }
+
+    /* Reference for the BVH, every triangle with the same arithmetic as the traversal. */
+    float IntersectBruteForce(const SyntheticMesh& mesh, const glm::vec3& origin, const glm::vec3& direction)
+    {
+        auto vertex = [&mesh](unsigned int index) {
+            return glm::vec3(mesh.positions[3 * index], mesh.positions[3 * index + 1], mesh.positions[3 * index + 2]);
+        };
+
+        float best = std::numeric_limits<float>::infinity();
+        for (size_t index = 0; index < mesh.indices.size(); index += 3)
+        {
+            const glm::vec3 v0 = vertex(mesh.indices[index]);
+            const glm::vec3 e1 = vertex(mesh.indices[index + 1]) - v0;
+            const glm::vec3 e2 = vertex(mesh.indices[index + 2]) - v0;
+
+            const glm::vec3 p(direction.y * e2.z - direction.z * e2.y, direction.z * e2.x - direction.x * e2.z, direction.x * e2.y - direction.y * e2.x);
+            const float det = e1.x * p.x + e1.y * p.y + e1.z * p.z;
+            if (det == 0.0f)
+                continue;
+
+            const float inverseDet = 1.0f / det;
+            const glm::vec3 s = origin - v0;
+            const float u = (s.x * p.x + s.y * p.y + s.z * p.z) * inverseDet;
+            const glm::vec3 q(s.y * e1.z - s.z * e1.y, s.z * e1.x - s.x * e1.z, s.x * e1.y - s.y * e1.x);
+            const float v = (direction.x * q.x + direction.y * q.y + direction.z * q.z) * inverseDet;
+            const float t = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * inverseDet;
+
+            if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f && t < best)
+                best = t;
+        }
+
+        return best;
+    }
+
+    /* Rays from a shell around the mesh bounds towards random points inside them, same set on every run. */
+    std::vector<std::pair<glm::vec3, glm::vec3>> SyntheticRays(const CommonUtils::BBCoord& bounds, size_t count)
+    {
+        std::mt19937 random(77);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        const glm::vec3 center = CommonUtils::GetBBoxCenter(bounds);
+        const float radius = glm::length(bounds.Max - bounds.Min);
+
+        std::vector<std::pair<glm::vec3, glm::vec3>> rays;
+        rays.reserve(count);
+        for (size_t index = 0; index < count; index++)
+        {
+            const glm::vec3 onSphere = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) - 0.5f);
+            const glm::vec3 target = glm::mix(bounds.Min, bounds.Max, glm::vec3(unit(random), unit(random), unit(random)));
+            const glm::vec3 origin = center + radius * onSphere;
+            rays.emplace_back(origin, glm::normalize(target - origin));
+        }
+
+        return rays;
+    }
+
+    bool RunTriangleBVHBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("TriangleBVH"))
+            return true;
+
+        const std::string& root = suite.GetOptions().resourceRoot;
+        const TriangleMesh object(root + "Models/Ivysaur_OBJ/Pokemon.obj");
+
+        const std::pair<std::string, SyntheticMesh> meshes[] = {
+            {"Ivysaur", MergeMeshes(object)},
+            {"Sphere1M", SyntheticSphere(708)},
+        };
+
+        for (const auto& entry: meshes)
+        {
+            const std::string& name = entry.first;
+            const SyntheticMesh& mesh = entry.second;
+            const size_t triangles = mesh.indices.size() / 3;
+
+            /* One build each, the 1M one takes long enough to time on its own. */
+            TriangleBVH serial;
+            auto start = Benchmark::Clock::now();
+            serial.Build(mesh.positions, mesh.indices, nullptr);
+            suite.Report("TriangleBVH::Build/" + name + "/serial", 1, Benchmark::ElapsedNs(start));
+
+            TriangleBVH bvh;
+            start = Benchmark::Clock::now();
+            bvh.Build(mesh.positions, mesh.indices, &ThreadPool::Shared());
+            auto& build = suite.Report("TriangleBVH::Build/" + name, 1, Benchmark::ElapsedNs(start));
+            build.counters["triangles"] = static_cast<double>(triangles);
+            build.counters["nodes"]     = static_cast<double>(bvh.GetNodeCount());
+            build.counters["threads"]   = ThreadPool::Shared().GetThreadCount() + 1.0;
+
+            const auto rays = SyntheticRays(bvh.GetBounds(), 4096);
+
+            /* Brute force over every triangle is slow on 1M, a few dozen rays are enough there. */
+            const size_t checks = std::min<size_t>(rays.size(), triangles > 100000 ? 32 : 1024);
+            for (size_t index = 0; index < checks; index++)
+            {
+                TriangleBVH::Hit hit, serialHit;
+                bvh.Intersect(rays[index].first, rays[index].second, hit);
+                serial.Intersect(rays[index].first, rays[index].second, serialHit);
+
+                const float expected = IntersectBruteForce(mesh, rays[index].first, rays[index].second);
+                if (hit.distance != expected || serialHit.distance != expected)
+                {
+                    std::cerr << "TriangleBVH: " << name << " ray " << index << " hit at " << hit.distance << ", brute force " << expected << std::endl;
+                    return false;
+                }
+            }
+
+            size_t next = 0, hits = 0;
+            auto& intersect = suite.Run("TriangleBVH::Intersect/" + name, [&] {
+                const auto& ray = rays[next++ % rays.size()];
+                TriangleBVH::Hit hit;
+                hits += bvh.Intersect(ray.first, ray.second, hit);
+            });
+            intersect.counters["rays_per_s"] = 1e9 / intersect.nsPerOp;
+            Benchmark::DoNotOptimize(hits);
+
+            /* World space instance, as the viewer picks. */
+            const glm::mat4 modelMatrix = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(15.0f, 0.0f, 0.0f)), glm::vec3(5.0f));
+            auto& instance = suite.Run("TriangleBVH::Intersect/" + name + "/instance", [&] {
+                const auto& ray = rays[next++ % rays.size()];
+                TriangleBVH::Hit hit;
+                hits += bvh.Intersect(glm::vec3(modelMatrix * glm::vec4(ray.first, 1.0f)), 5.0f * ray.second, modelMatrix, hit);
+            });
+            instance.counters["rays_per_s"] = 1e9 / instance.nsPerOp;
+            Benchmark::DoNotOptimize(hits);
+        }
+
+        return true;
+    }
+
+    /*
+     * Light clustering for the viewer's default view. Pooled and serial builds must agree, and every light that
+     * reaches a sampled point in the frustum must be listed in that point's cluster.
+     */
+    bool RunClusteredLightingBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("ClusterGrid"))
+            return true;
+
+        const int width = 1280, height = 720;
+        const float nearPlane = 0.1f, farPlane = 100.0f;
+        const glm::mat4 proj = glm::perspective(glm::radians(45.0f), float(width) / height, nearPlane, farPlane);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 10.0f, 60.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 inverseView = glm::inverse(view);
+
+        std::mt19937 random(35);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        for (const size_t count: {1, 64, 256, 1024})
+        {
+            std::vector<Lighting::PointLight> lights(count);
+            for (auto& light: lights)
+            {
+                light.position = glm::vec3(100.0f * unit(random) - 50.0f, 20.0f * unit(random), 100.0f * unit(random) - 50.0f);
+                light.radius   = 2.0f + 10.0f * unit(random);
+                light.color    = glm::vec3(1.0f);
+            }
+
+            const std::string name = "ClusterGrid::Build/" + std::to_string(count);
+
+            Lighting::ClusterGrid serial, pooled;
+            suite.Run(name + "/serial", [&] { serial.Build(lights, view, proj, width, height, nullptr); });
+            auto& build = suite.Run(name, [&] { pooled.Build(lights, view, proj, width, height, &ThreadPool::Shared()); });
+            build.counters["entries"] = static_cast<double>(pooled.GetIndices().size());
+            build.counters["threads"] = ThreadPool::Shared().GetThreadCount() + 1.0;
+
+            if (serial.GetGrid() != pooled.GetGrid() || serial.GetIndices() != pooled.GetIndices())
+            {
+                std::cerr << "ClusterGrid: pooled build differs from the serial one, " << count << " lights" << std::endl;
+                return false;
+            }
+
+            for (int sample = 0; sample < 4096; sample++)
+            {
+                const glm::vec2 pixel(unit(random) * width, unit(random) * height);
+                const float depth = nearPlane * std::pow(farPlane / nearPlane, unit(random));
+                const glm::vec3 point = glm::vec3(inverseView * glm::vec4((2.0f * pixel.x / width - 1.0f) * depth / proj[0][0],
+                                                                          (2.0f * pixel.y / height - 1.0f) * depth / proj[1][1], -depth, 1.0f));
+
+                /* Same lookup as ModelObject.shader. */
+                const glm::ivec3 cluster = glm::clamp(glm::ivec3(glm::ivec2(pixel * pooled.GetTileScale()), int(std::log(depth / pooled.GetNear()) * pooled.GetSliceScale())),
+                                                      glm::ivec3(0), glm::ivec3(Lighting::ClusterGrid::kClustersX - 1, Lighting::ClusterGrid::kClustersY - 1, Lighting::ClusterGrid::kClustersZ - 1));
+                const int index = (cluster.z * Lighting::ClusterGrid::kClustersY + cluster.y) * Lighting::ClusterGrid::kClustersX + cluster.x;
+                const auto first = pooled.GetIndices().begin() + pooled.GetGrid()[2 * index];
+                const auto last  = first + pooled.GetGrid()[2 * index + 1];
+
+                for (size_t light = 0; light < count; light++)
+                {
+                    if (glm::length(lights[light].position - point) > lights[light].radius)
+                        continue;
+
+                    if (std::find(first, last, static_cast<unsigned int>(light)) == last)
+                    {
+                        std::cerr << "ClusterGrid: light " << light << " missing from cluster " << index << ", " << count << " lights" << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /*
+     * The CPU side of a viewer frame, what the update thread takes off the GL thread (ViewerBench --update-thread).
+     * Scene as the viewer starts, plus scattered point lights. The clusters must match a direct build.
+     */
+    bool RunScenePrepareBenchmarks(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("SceneRenderer::Prepare"))
+            return true;
+
+        const int width = 1280, height = 720;
+        const glm::vec3 cameraPosition(0.0f, 10.0f, 60.0f);
+        const glm::mat4 proj = glm::perspective(glm::radians(45.0f), float(width) / height, 0.1f, 100.0f);
+        const glm::mat4 view = glm::lookAt(cameraPosition, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        const CommonUtils::BBCoord unitBox{glm::vec3(-1.0f), glm::vec3(1.0f)};
+        Helper::SceneRenderer::Settings settings;
+        settings.objectModelMatrix = CommonUtils::ModelMatrix(unitBox, unitBox);
+        settings.groundModelMatrix = CommonUtils::ModelMatrix(unitBox, unitBox);
+        settings.lightModelMatrix  = CommonUtils::ModelMatrix(unitBox, unitBox);
+        settings.lightModelMatrix.fTranslation = glm::vec3(0.0f, 5.0f, 5.0f);
+
+        std::mt19937 random(48);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        for (const size_t count: {0, 1023})
+        {
+            settings.extraLights.resize(count);
+            for (auto& light: settings.extraLights)
+            {
+                light.position = glm::vec3(100.0f * unit(random) - 50.0f, 20.0f * unit(random), 100.0f * unit(random) - 50.0f);
+                light.radius   = 2.0f + 10.0f * unit(random);
+                light.color    = glm::vec3(1.0f);
+            }
+
+            Helper::SceneState state;
+            auto& prepare = suite.Run("SceneRenderer::Prepare/" + std::to_string(count + 1), [&] {
+                Helper::SceneRenderer::Prepare(settings, proj, view, cameraPosition, width, height, state);
+                Benchmark::DoNotOptimize(state.lightClusters.GetIndices().size());
+            });
+            prepare.counters["lights"] = static_cast<double>(state.pointLights.size());
+
+            Lighting::ClusterGrid reference;
+            reference.Build(state.pointLights, view, proj, width, height, nullptr);
+            if (state.pointLights.size() != count + 1 || reference.GetGrid() != state.lightClusters.GetGrid() ||
+                reference.GetIndices() != state.lightClusters.GetIndices())
+            {
+                std::cerr << "SceneRenderer::Prepare: clusters differ from a direct build, " << count + 1 << " lights" << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void RunImportThroughput(Benchmark::Suite& suite)
+    {
+        if (!suite.Enabled("ImportThroughput"))
+            return;
+
+        std::vector<std::string> models;
+        FindModels(suite.GetOptions().modelsDirectory, models);
+
+        if (models.empty())
+        {
+            std::cerr << "No models found in " << suite.GetOptions().modelsDirectory << std::endl;
+            return;
+        }
+
+        std::uint64_t bytes = 0;
+        const std::uint64_t allocationsBefore = Benchmark::GetAllocationCount();
+        const std::uint64_t allocatedBefore   = Benchmark::GetAllocatedBytes();
+        const auto start = Benchmark::Clock::now();
+
+        for (const std::string& path: models)
+        {
+            TriangleMesh mesh(path);
+            Benchmark::DoNotOptimize(mesh.GetNumberOfMeshes());
+            bytes += FileSize(path);
+        }
+
+        const double elapsed = Benchmark::ElapsedNs(start);
+
+        Benchmark::Result& result = suite.Report("ImportThroughput", models.size(), elapsed);
+        result.counters["files"]           = static_cast<double>(models.size());
+        result.counters["bytes"]           = static_cast<double>(bytes);
+        result.counters["MB_per_s"]        = bytes / (elapsed / 1e9) / (1024.0 * 1024.0);
+        result.counters["allocations"]     = static_cast<double>(Benchmark::GetAllocationCount() - allocationsBefore);
+        result.counters["allocated_bytes"] = static_cast<double>(Benchmark::GetAllocatedBytes() - allocatedBefore);
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    const CommandLine commandLine = ParseOptions(argc, argv);
+
+    Benchmark::Suite suite(commandLine.options);
+
+    RunImportBenchmarks(suite);
+    RunBoundingBoxBenchmarks(suite);
+    RunShaderBenchmarks(suite);
+    RunTextureBenchmarks(suite);
+    const bool cullingPassed = RunCullingBenchmarks(suite);
+    const bool bvhPassed     = RunSceneBVHBenchmarks(suite);
+    const bool graphPassed   = RunSceneGraphBenchmarks(suite);
+    const bool transformsPassed = RunTransformBenchmarks(suite);
+    const bool occlusionPassed = RunOcclusionBenchmarks(suite);
+    const bool trianglesPassed = RunTriangleBVHBenchmarks(suite);
+    const bool clustersPassed  = RunClusteredLightingBenchmarks(suite);
+    const bool preparePassed   = RunScenePrepareBenchmarks(suite);
+    const bool compressionPassed = RunBlockCompressionBenchmarks(suite);
+    const bool mipmapsPassed     = RunMipmapBenchmarks(suite);
+    RunImportThroughput(suite);
+
+    const std::string json = suite.ToJSON(commandLine.label);
+
+    if (commandLine.output.empty())
+        std::cout << json;
+    else
+        std::ofstream(commandLine.output) << json;
+
+    return cullingPassed && bvhPassed && graphPassed && transformsPassed && occlusionPassed && trianglesPassed && clustersPassed && preparePassed && compressionPassed && mipmapsPassed ? 0 : 1;
+}
@@ -0,0 +1,643 @@
+//
+//  BlockCompression.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "BlockCompression.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include "GL/glew.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace BlockCompression
+{
+    namespace
+    {
+        unsigned short To565(int r, int g, int b)
+        {
+            return static_cast<unsigned short>(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+        }
+
+        void Expand565(unsigned short color, int rgb[3])
+        {
+            const int r = color >> 11 & 31, g = color >> 5 & 63, b = color & 31;
+            rgb[0] = r << 3 | r >> 2;
+            rgb[1] = g << 2 | g >> 4;
+            rgb[2] = b << 3 | b >> 2;
+        }
+
+        /* Bounding box endpoints, inset by 1/16 of the range so the extremes don't dominate. False when both are equal. */
+        bool ChooseBC1Endpoints(const int minimum[3], const int maximum[3], unsigned short& color0, unsigned short& color1, int palette[4][3])
+        {
+            int low[3], high[3];
+            for (int channel = 0; channel < 3; channel++)
+            {
+                const int inset = (maximum[channel] - minimum[channel]) >> 4;
+                low[channel]  = minimum[channel] + inset;
+                high[channel] = maximum[channel] - inset;
+            }
+
+            /* Per channel high >= low, so color0 >= color1: four color mode unless they are equal. */
+            color0 = To565(high[0], high[1], high[2]);
+            color1 = To565(low[0], low[1], low[2]);
+            if (color0 == color1)
+                return false;
+
+            Expand565(color0, palette[0]);
+            Expand565(color1, palette[1]);
+            for (int channel = 0; channel < 3; channel++)
+            {
+                palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+                palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+            }
+
+            return true;
+        }
+
+        void WriteBC1(unsigned char block[8], unsigned short color0, unsigned short color1, std::uint32_t indices)
+        {
+            block[0] = color0 & 0xFF; block[1] = color0 >> 8;
+            block[2] = color1 & 0xFF; block[3] = color1 >> 8;
+            for (int byte = 0; byte < 4; byte++)
+                block[4 + byte] = indices >> (8 * byte) & 0xFF;
+        }
+
+        void WriteBC4(unsigned char block[8], int maximum, int minimum, std::uint64_t indices)
+        {
+            block[0] = static_cast<unsigned char>(maximum);
+            block[1] = static_cast<unsigned char>(minimum);
+            for (int byte = 0; byte < 6; byte++)
+                block[2 + byte] = indices >> (8 * byte) & 0xFF;
+        }
+
+        void DecodeBC4Block(const unsigned char block[8], int channel, unsigned char texels[64])
+        {
+            const int a0 = block[0], a1 = block[1];
+            int values[8] = {a0, a1};
+            if (a0 > a1)
+            {
+                for (int index = 2; index < 8; index++)
+                    values[index] = ((8 - index) * a0 + (index - 1) * a1) / 7;
+            }
+            else
+            {
+                for (int index = 2; index < 6; index++)
+                    values[index] = ((6 - index) * a0 + (index - 1) * a1) / 5;
+                values[6] = 0;
+                values[7] = 255;
+            }
+
+            std::uint64_t indices = 0;
+            for (int byte = 0; byte < 6; byte++)
+                indices |= std::uint64_t(block[2 + byte]) << (8 * byte);
+
+            for (int texel = 0; texel < 16; texel++)
+                texels[4 * texel + channel] = static_cast<unsigned char>(values[indices >> (3 * texel) & 7]);
+        }
+
+        void DecodeBC1Block(const unsigned char block[8], unsigned char texels[64])
+        {
+            const unsigned short color0 = static_cast<unsigned short>(block[0] | block[1] << 8);
+            const unsigned short color1 = static_cast<unsigned short>(block[2] | block[3] << 8);
+
+            int palette[4][4];
+            Expand565(color0, palette[0]);
+            Expand565(color1, palette[1]);
+            for (int channel = 0; channel < 3; channel++)
+            {
+                if (color0 > color1)
+                {
+                    palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+                    palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+                }
+                else
+                {
+                    palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+                    palette[3][channel] = 0;
+                }
+            }
+            palette[0][3] = palette[1][3] = palette[2][3] = 255;
+            palette[3][3] = color0 > color1 ? 255 : 0;
+
+            for (int texel = 0; texel < 16; texel++)
+            {
+                const int index = block[4 + texel / 4] >> (2 * (texel % 4)) & 3;
+                for (int channel = 0; channel < 4; channel++)
+                    texels[4 * texel + channel] = static_cast<unsigned char>(palette[index][channel]);
+            }
+        }
+
+        /* One level as RGBA, grey for one channel, missing channels 0 and opaque. */
+        std::vector<unsigned char> ExpandToRGBA(const unsigned char* pixels, int width, int height, int channels)
+        {
+            std::vector<unsigned char> rgba(static_cast<size_t>(width) * height * 4);
+            for (size_t texel = 0; texel < static_cast<size_t>(width) * height; texel++)
+            {
+                const unsigned char* source = pixels + texel * channels;
+                unsigned char* target = &rgba[4 * texel];
+                target[0] = source[0];
+                target[1] = channels == 1 ? source[0] : source[1];
+                target[2] = channels == 1 ? source[0] : channels > 2 ? source[2] : 0;
+                target[3] = channels == 4 ? source[3] : 255;
+            }
+            return rgba;
+        }
+
+        void EncodeLevel(const std::vector<unsigned char>& rgba, Level& level, Format format, ThreadPool* pool)
+        {
+            const int blocksX = (level.width + 3) / 4, blocksY = (level.height + 3) / 4;
+            const size_t blockBytes = GetBlockBytes(format);
+            level.data.resize(blocksX * blocksY * blockBytes);
+
+            auto encodeRows = [&](size_t begin, size_t end) {
+                unsigned char texels[64];
+                for (size_t blockY = begin; blockY < end; blockY++)
+                    for (int blockX = 0; blockX < blocksX; blockX++)
+                    {
+                        for (int row = 0; row < 4; row++)
+                        {
+                            const int y = std::min(static_cast<int>(blockY) * 4 + row, level.height - 1);
+                            for (int column = 0; column < 4; column++)
+                            {
+                                const int x = std::min(blockX * 4 + column, level.width - 1);
+                                std::memcpy(&texels[4 * (4 * row + column)], &rgba[4 * (static_cast<size_t>(y) * level.width + x)], 4);
+                            }
+                        }
+
+                        EncodeBlock(format, texels, &level.data[(blockY * blocksX + blockX) * blockBytes]);
+                    }
+            };
+
+            if (pool)
+                pool->ParallelFor(blocksY, 8, encodeRows);
+            else
+                encodeRows(0, blocksY);
+        }
+
+        /* DDS_HEADER with its pixel format, after the "DDS " magic. */
+        struct DDSHeader
+        {
+            std::uint32_t size = 124;
+            std::uint32_t flags;
+            std::uint32_t height;
+            std::uint32_t width;
+            std::uint32_t linearSize;
+            std::uint32_t depth = 0;
+            std::uint32_t mipMapCount;
+            std::uint32_t reserved1[11] = {};
+            std::uint32_t formatSize = 32;
+            std::uint32_t formatFlags;
+            std::uint32_t fourCC;
+            std::uint32_t formatBits[5] = {};
+            std::uint32_t caps;
+            std::uint32_t caps2[4] = {};
+        };
+        static_assert(sizeof(DDSHeader) == 124, "DDS header layout");
+
+        constexpr std::uint32_t FourCC(const char code[5])
+        {
+            return std::uint32_t(code[0]) | std::uint32_t(code[1]) << 8 | std::uint32_t(code[2]) << 16 | std::uint32_t(code[3]) << 24;
+        }
+    }
+
+    size_t Image::GetByteSize() const
+    {
+        size_t bytes = 0;
+        for (const auto& level: levels)
+            bytes += level.data.size();
+        return bytes;
+    }
+
+    Format ChooseFormat(int channels)
+    {
+        switch (channels)
+        {
+            case 1:  return Format::BC4;
+            case 2:  return Format::BC5;
+            case 3:  return Format::BC1;
+            default: return Format::BC3;
+        }
+    }
+
+    size_t GetBlockBytes(Format format)
+    {
+        return format == Format::BC1 || format == Format::BC4 ? 8 : 16;
+    }
+
+    unsigned int GetGLFormat(Format format)
+    {
+        switch (format)
+        {
+            case Format::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            case Format::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            case Format::BC4: return GL_COMPRESSED_RED_RGTC1;
+            default:          return GL_COMPRESSED_RG_RGTC2;
+        }
+    }
+
+    const char* GetName(Format format)
+    {
+        switch (format)
+        {
+            case Format::BC1: return "BC1";
+            case Format::BC3: return "BC3";
+            case Format::BC4: return "BC4";
+            default:          return "BC5";
+        }
+    }
+
+    void EncodeBC1BlockScalar(const unsigned char texels[64], unsigned char block[8])
+    {
+        int minimum[3] = {255, 255, 255}, maximum[3] = {0, 0, 0};
+        for (int texel = 0; texel < 16; texel++)
+            for (int channel = 0; channel < 3; channel++)
+            {
+                minimum[channel] = std::min<int>(minimum[channel], texels[4 * texel + channel]);
+                maximum[channel] = std::max<int>(maximum[channel], texels[4 * texel + channel]);
+            }
+
+        unsigned short color0, color1;
+        int palette[4][3];
+        if (!ChooseBC1Endpoints(minimum, maximum, color0, color1, palette))
+        {
+            WriteBC1(block, color0, color1, 0);
+            return;
+        }
+
+        /* Closest entry by squared distance, the lower index on ties. */
+        std::uint32_t indices = 0;
+        for (int texel = 0; texel < 16; texel++)
+        {
+            int best = 0, bestDistance = 0;
+            for (int entry = 0; entry < 4; entry++)
+            {
+                int distance = 0;
+                for (int channel = 0; channel < 3; channel++)
+                {
+                    const int delta = texels[4 * texel + channel] - palette[entry][channel];
+                    distance += delta * delta;
+                }
+
+                if (entry == 0 || distance < bestDistance)
+                {
+                    best = entry;
+                    bestDistance = distance;
+                }
+            }
+
+            indices |= std::uint32_t(best) << (2 * texel);
+        }
+
+        WriteBC1(block, color0, color1, indices);
+    }
+
+    void EncodeBC1Block(const unsigned char texels[64], unsigned char block[8])
+    {
+#if defined(__SSE2__)
+        const __m128i* rows = reinterpret_cast<const __m128i*>(texels);
+        const __m128i row0 = _mm_loadu_si128(rows), row1 = _mm_loadu_si128(rows + 1), row2 = _mm_loadu_si128(rows + 2), row3 = _mm_loadu_si128(rows + 3);
+
+        /* Bounding box over the 16 texels: per byte across rows, then across the 4 texels of a row. */
+        __m128i low  = _mm_min_epu8(_mm_min_epu8(row0, row1), _mm_min_epu8(row2, row3));
+        __m128i high = _mm_max_epu8(_mm_max_epu8(row0, row1), _mm_max_epu8(row2, row3));
+        low  = _mm_min_epu8(low,  _mm_shuffle_epi32(low,  _MM_SHUFFLE(2, 3, 0, 1)));
+        low  = _mm_min_epu8(low,  _mm_shuffle_epi32(low,  _MM_SHUFFLE(1, 0, 3, 2)));
+        high = _mm_max_epu8(high, _mm_shuffle_epi32(high, _MM_SHUFFLE(2, 3, 0, 1)));
+        high = _mm_max_epu8(high, _mm_shuffle_epi32(high, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        const std::uint32_t lowBytes = static_cast<std::uint32_t>(_mm_cvtsi128_si32(low));
+        const std::uint32_t highBytes = static_cast<std::uint32_t>(_mm_cvtsi128_si32(high));
+        const int minimum[3] = {int(lowBytes & 0xFF), int(lowBytes >> 8 & 0xFF), int(lowBytes >> 16 & 0xFF)};
+        const int maximum[3] = {int(highBytes & 0xFF), int(highBytes >> 8 & 0xFF), int(highBytes >> 16 & 0xFF)};
+
+        unsigned short color0, color1;
+        int palette[4][3];
+        if (!ChooseBC1Endpoints(minimum, maximum, color0, color1, palette))
+        {
+            WriteBC1(block, color0, color1, 0);
+            return;
+        }
+
+        __m128i entries[4];
+        for (int entry = 0; entry < 4; entry++)
+            entries[entry] = _mm_setr_epi16(short(palette[entry][0]), short(palette[entry][1]), short(palette[entry][2]), 0,
+                                            short(palette[entry][0]), short(palette[entry][1]), short(palette[entry][2]), 0);
+
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+        const __m128i texelRows[4] = {row0, row1, row2, row3};
+
+        std::uint32_t indices = 0;
+        for (int row = 0; row < 4; row++)
+        {
+            /* Alpha dropped, 16 bit lanes: two texels per register. */
+            const __m128i colors = _mm_and_si128(texelRows[row], colorMask);
+            const __m128i texels01 = _mm_unpacklo_epi8(colors, zero);
+            const __m128i texels23 = _mm_unpackhi_epi8(colors, zero);
+
+            __m128i bestDistance = zero, best = zero;
+            for (int entry = 0; entry < 4; entry++)
+            {
+                /* madd gives (dr^2 + dg^2, db^2) per texel, summed into the low lane of each 64 bit half. */
+                const __m128i delta01 = _mm_sub_epi16(texels01, entries[entry]);
+                const __m128i delta23 = _mm_sub_epi16(texels23, entries[entry]);
+                __m128i squares01 = _mm_madd_epi16(delta01, delta01);
+                __m128i squares23 = _mm_madd_epi16(delta23, delta23);
+                squares01 = _mm_add_epi32(squares01, _mm_srli_epi64(squares01, 32));
+                squares23 = _mm_add_epi32(squares23, _mm_srli_epi64(squares23, 32));
+
+                const __m128i distance = _mm_unpacklo_epi64(_mm_shuffle_epi32(squares01, _MM_SHUFFLE(3, 3, 2, 0)),
+                                                            _mm_shuffle_epi32(squares23, _MM_SHUFFLE(3, 3, 2, 0)));
+                if (entry == 0)
+                {
+                    bestDistance = distance;
+                    continue;
+                }
+
+                const __m128i closer = _mm_cmplt_epi32(distance, bestDistance);
+                bestDistance = _mm_or_si128(_mm_and_si128(closer, distance), _mm_andnot_si128(closer, bestDistance));
+                best = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(entry)), _mm_andnot_si128(closer, best));
+            }
+
+            alignas(16) std::uint32_t rowIndices[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(rowIndices), best);
+            for (int column = 0; column < 4; column++)
+                indices |= rowIndices[column] << (2 * (4 * row + column));
+        }
+
+        WriteBC1(block, color0, color1, indices);
+#else
+        EncodeBC1BlockScalar(texels, block);
+#endif
+    }
+
+    void EncodeBC4BlockScalar(const unsigned char texels[64], int channel, unsigned char block[8])
+    {
+        int minimum = 255, maximum = 0;
+        for (int texel = 0; texel < 16; texel++)
+        {
+            minimum = std::min<int>(minimum, texels[4 * texel + channel]);
+            maximum = std::max<int>(maximum, texels[4 * texel + channel]);
+        }
+
+        /* maximum > minimum selects the 8 value ramp: 0 is maximum, 1 minimum, 2..7 in between from the top. */
+        std::uint64_t indices = 0;
+        if (maximum > minimum)
+        {
+            const int range = maximum - minimum;
+            for (int texel = 0; texel < 16; texel++)
+            {
+                const int step = ((texels[4 * texel + channel] - minimum) * 14 + range) / (2 * range);
+                const std::uint64_t index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+                indices |= index << (3 * texel);
+            }
+        }
+
+        WriteBC4(block, maximum, minimum, indices);
+    }
+
+    void EncodeBC4Block(const unsigned char texels[64], int channel, unsigned char block[8])
+    {
+#if defined(__SSE2__)
+        /* The channel's byte of every texel, as 16 bit lanes: texels 0..7 and 8..15. */
+        const __m128i* rows = reinterpret_cast<const __m128i*>(texels);
+        const __m128i byteMask = _mm_set1_epi32(0xFF);
+        const __m128i shift = _mm_cvtsi32_si128(8 * channel);
+        const __m128i row0 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(rows), shift), byteMask);
+        const __m128i row1 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(rows + 1), shift), byteMask);
+        const __m128i row2 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(rows + 2), shift), byteMask);
+        const __m128i row3 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(rows + 3), shift), byteMask);
+        const __m128i values0 = _mm_packs_epi32(row0, row1);
+        const __m128i values1 = _mm_packs_epi32(row2, row3);
+
+        /* Range over the 16 lanes, folded down to lane 0. */
+        __m128i low  = _mm_min_epi16(values0, values1);
+        __m128i high = _mm_max_epi16(values0, values1);
+        low  = _mm_min_epi16(low,  _mm_shuffle_epi32(low,  _MM_SHUFFLE(1, 0, 3, 2)));
+        high = _mm_max_epi16(high, _mm_shuffle_epi32(high, _MM_SHUFFLE(1, 0, 3, 2)));
+        low  = _mm_min_epi16(low,  _mm_shuffle_epi32(low,  _MM_SHUFFLE(2, 3, 0, 1)));
+        high = _mm_max_epi16(high, _mm_shuffle_epi32(high, _MM_SHUFFLE(2, 3, 0, 1)));
+        low  = _mm_min_epi16(low,  _mm_srli_epi32(low, 16));
+        high = _mm_max_epi16(high, _mm_srli_epi32(high, 16));
+
+        const int minimum = _mm_cvtsi128_si32(low) & 0xFFFF;
+        const int maximum = _mm_cvtsi128_si32(high) & 0xFFFF;
+        if (maximum == minimum)
+        {
+            WriteBC4(block, maximum, minimum, 0);
+            return;
+        }
+
+        /*
+         * step = ((value - minimum) * 14 + range) / (2 * range), without a divide: the number of thresholds
+         * 2 * range * k (k = 1..7) it reaches. Everything stays below 4096, 16 bit lanes do.
+         */
+        const int range = maximum - minimum;
+        const __m128i minimumLanes = _mm_set1_epi16(short(minimum));
+        const __m128i scale = _mm_set1_epi16(14);
+        const __m128i rangeLanes = _mm_set1_epi16(short(range));
+        const __m128i scaled0 = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(values0, minimumLanes), scale), rangeLanes);
+        const __m128i scaled1 = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(values1, minimumLanes), scale), rangeLanes);
+
+        __m128i steps0 = _mm_setzero_si128(), steps1 = _mm_setzero_si128();
+        for (int k = 1; k < 8; k++)
+        {
+            const __m128i threshold = _mm_set1_epi16(short(2 * range * k - 1));
+            steps0 = _mm_sub_epi16(steps0, _mm_cmpgt_epi16(scaled0, threshold));
+            steps1 = _mm_sub_epi16(steps1, _mm_cmpgt_epi16(scaled1, threshold));
+        }
+
+        /* Ramp order: (8 - step) & 7 puts step 7 at 1 and step 0 at 0, swapping those two makes it right. */
+        const __m128i eight = _mm_set1_epi16(8), seven = _mm_set1_epi16(7), one = _mm_set1_epi16(1), two = _mm_set1_epi16(2);
+        __m128i indices0 = _mm_and_si128(_mm_sub_epi16(eight, steps0), seven);
+        __m128i indices1 = _mm_and_si128(_mm_sub_epi16(eight, steps1), seven);
+        indices0 = _mm_xor_si128(indices0, _mm_and_si128(_mm_cmplt_epi16(indices0, two), one));
+        indices1 = _mm_xor_si128(indices1, _mm_and_si128(_mm_cmplt_epi16(indices1, two), one));
+
+        alignas(16) std::uint16_t texelIndices[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(texelIndices), indices0);
+        _mm_store_si128(reinterpret_cast<__m128i*>(texelIndices + 8), indices1);
+
+        std::uint64_t indices = 0;
+        for (int texel = 0; texel < 16; texel++)
+            indices |= std::uint64_t(texelIndices[texel]) << (3 * texel);
+
+        WriteBC4(block, maximum, minimum, indices);
+#else
+        EncodeBC4BlockScalar(texels, channel, block);
+#endif
+    }
+
+    void EncodeBlock(Format format, const unsigned char texels[64], unsigned char* block)
+    {
+        switch (format)
+        {
+            case Format::BC1:
+                EncodeBC1Block(texels, block);
+                break;
+            case Format::BC3:
+                EncodeBC4Block(texels, 3, block);
+                EncodeBC1Block(texels, block + 8);
+                break;
+            case Format::BC4:
+                EncodeBC4Block(texels, 0, block);
+                break;
+            case Format::BC5:
+                EncodeBC4Block(texels, 0, block);
+                EncodeBC4Block(texels, 1, block + 8);
+                break;
+        }
+    }
+
+    void DecodeBlock(Format format, const unsigned char* block, unsigned char texels[64])
+    {
+        switch (format)
+        {
+            case Format::BC1:
+                DecodeBC1Block(block, texels);
+                break;
+            case Format::BC3:
+                DecodeBC1Block(block + 8, texels);
+                DecodeBC4Block(block, 3, texels);
+                break;
+            case Format::BC4:
+                std::memset(texels, 0, 64);
+                DecodeBC4Block(block, 0, texels);
+                break;
+            case Format::BC5:
+                std::memset(texels, 0, 64);
+                DecodeBC4Block(block, 0, texels);
+                DecodeBC4Block(block + 8, 1, texels);
+                break;
+        }
+    }
+
+    Image Compress(const unsigned char* chain, const std::vector<Mipmap::Level>& levels, int channels, Format format, ThreadPool* pool)
+    {
+        PROFILE_FUNCTION();
+
+        Image image;
+        image.format = format;
+        image.levels.resize(levels.size());
+
+        for (size_t index = 0; index < levels.size(); index++)
+        {
+            Level& level = image.levels[index];
+            level.width  = levels[index].width;
+            level.height = levels[index].height;
+            EncodeLevel(ExpandToRGBA(chain + levels[index].offset, level.width, level.height, channels), level, format, pool);
+        }
+
+        return image;
+    }
+
+    bool WriteDDS(const std::string& path, const Image& image)
+    {
+        if (image.levels.empty())
+            return false;
+
+        static const char* kCodes[] = {"DXT1", "DXT5", "ATI1", "ATI2"};
+
+        DDSHeader header;
+        header.flags       = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;    /* Caps, height, width, format, mip count, linear size. */
+        header.height      = static_cast<std::uint32_t>(image.levels[0].height);
+        header.width       = static_cast<std::uint32_t>(image.levels[0].width);
+        header.linearSize  = static_cast<std::uint32_t>(image.levels[0].data.size());
+        header.mipMapCount = static_cast<std::uint32_t>(image.levels.size());
+        header.formatFlags = 0x4;                                               /* Four character code. */
+        header.fourCC      = FourCC(kCodes[static_cast<int>(image.format)]);
+        header.caps        = 0x1000 | 0x400000 | 0x8;                            /* Texture, mipmap, complex. */
+
+        /* Written aside and renamed, a reader never sees half a file. */
+        const std::string partial = path + ".partial";
+        {
+            std::ofstream file(partial, std::ios::binary);
+            if (!file)
+                return false;
+
+            file.write("DDS ", 4);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const auto& level: image.levels)
+                file.write(reinterpret_cast<const char*>(level.data.data()), level.data.size());
+            if (!file)
+                return false;
+        }
+
+        return std::rename(partial.c_str(), path.c_str()) == 0;
+    }
+
+    bool ReadDDS(const std::string& path, Image& image)
+    {
+        std::ifstream file(path, std::ios::binary);
+        char magic[4];
+        DDSHeader header;
+        if (!file.read(magic, 4) || std::memcmp(magic, "DDS ", 4) != 0 || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return false;
+
+        if (!(header.formatFlags & 0x4))
+            return false;
+
+        if (header.fourCC == FourCC("DXT1"))                                        image.format = Format::BC1;
+        else if (header.fourCC == FourCC("DXT5"))                                   image.format = Format::BC3;
+        else if (header.fourCC == FourCC("ATI1") || header.fourCC == FourCC("BC4U")) image.format = Format::BC4;
+        else if (header.fourCC == FourCC("ATI2") || header.fourCC == FourCC("BC5U")) image.format = Format::BC5;
+        else return false;
+
+        /* Nothing is allocated before the header is known to match the file, a corrupt one just fails. */
+        const std::uint32_t kMaxSize = 1u << 16;
+        if (header.width == 0 || header.height == 0 || header.width > kMaxSize || header.height > kMaxSize)
+            return false;
+
+        std::uint32_t maxLevels = 1;
+        while ((std::max(header.width, header.height) >> maxLevels) != 0)
+            maxLevels++;
+
+        const std::uint32_t levels = std::max<std::uint32_t>(1, header.mipMapCount);
+        if (levels > maxLevels)
+            return false;
+
+        const std::streamoff dataStart = file.tellg();
+        file.seekg(0, std::ios::end);
+        const std::uint64_t available = static_cast<std::uint64_t>(file.tellg() - dataStart);
+        file.seekg(dataStart);
+
+        std::uint64_t needed = 0;
+        for (std::uint32_t level = 0, width = header.width, height = header.height; level < levels; level++)
+        {
+            needed += std::uint64_t((width + 3) / 4) * ((height + 3) / 4) * GetBlockBytes(image.format);
+            width  = std::max(1u, width / 2);
+            height = std::max(1u, height / 2);
+        }
+        if (!file || needed > available)
+            return false;
+
+        int width = static_cast<int>(header.width), height = static_cast<int>(header.height);
+        image.levels.resize(levels);
+        for (auto& level: image.levels)
+        {
+            level.width  = width;
+            level.height = height;
+            level.data.resize(static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * GetBlockBytes(image.format));
+            if (!file.read(reinterpret_cast<char*>(level.data.data()), level.data.size()))
+                return false;
+
+            width  = std::max(1, width / 2);
+            height = std::max(1, height / 2);
+        }
+
+        return true;
+    }
+}
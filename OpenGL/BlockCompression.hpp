@@ -0,0 +1,83 @@
+//
+//  BlockCompression.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef BlockCompression_hpp
+#define BlockCompression_hpp
+
+#include "Mipmap.hpp"
+
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/*
+ * CPU encoder for the GPU block formats, 4x4 texels per block:
+ *   BC1 (DXT1)  RGB, 8 bytes         BC4 (RGTC1)  one channel, 8 bytes
+ *   BC3 (DXT5)  RGB + alpha, 16      BC5 (RGTC2)  two channels, 16
+ * Endpoints come from the block's bounding box, inset a little, texels take the closest palette entry. Not the
+ * best possible quality, but fast enough to encode a model's textures on first load and cache them as DDS.
+ */
+namespace BlockCompression
+{
+    enum class Format
+    {
+        BC1,
+        BC3,
+        BC4,
+        BC5
+    };
+
+    struct Level
+    {
+        int                        width  = 0;
+        int                        height = 0;
+        std::vector<unsigned char> data;
+    };
+
+    struct Image
+    {
+        Format             format = Format::BC1;
+        std::vector<Level> levels;      /* Full mip chain down to 1x1, level 0 first. */
+
+        size_t GetByteSize() const;
+    };
+
+    /* BC4 for 1 channel, BC5 for 2, BC1 for 3 and BC3 for 4. */
+    Format ChooseFormat(int channels);
+    size_t GetBlockBytes(Format format);
+    /* The GL_COMPRESSED_* internal format. */
+    unsigned int GetGLFormat(Format format);
+    const char* GetName(Format format);
+
+    /* Texels are 4x4 RGBA, row by row. BC4 reads the red channel, BC5 red and green. */
+    void EncodeBlock(Format format, const unsigned char texels[64], unsigned char* block);
+    void DecodeBlock(Format format, const unsigned char* block, unsigned char texels[64]);
+
+    /* BC1 color block, SSE2 when available. EncodeBC1BlockScalar is the reference, both give the same bytes. */
+    void EncodeBC1Block(const unsigned char texels[64], unsigned char block[8]);
+    void EncodeBC1BlockScalar(const unsigned char texels[64], unsigned char block[8]);
+    /* BC4 block of one channel (0..3), also the alpha of BC3 and both halves of BC5. Same split as BC1. */
+    void EncodeBC4Block(const unsigned char texels[64], int channel, unsigned char block[8]);
+    void EncodeBC4BlockScalar(const unsigned char texels[64], int channel, unsigned char block[8]);
+
+    /*
+     * Encodes a mip chain of 8 bit pixels with 1 to 4 channels (see Mipmap.hpp), each level in rows of blocks on
+     * the pool (may be null). Rows stay in the order given, edge blocks repeat the last row and column.
+     */
+    Image Compress(const unsigned char* chain, const std::vector<Mipmap::Level>& levels, int channels, Format format, ThreadPool* pool);
+
+    /*
+     * DDS with a DXT1, DXT5, ATI1 or ATI2 four character code and all levels. Reading fails on a header that
+     * does not match the file: bad sizes, too many levels, data cut short.
+     */
+    bool WriteDDS(const std::string& path, const Image& image);
+    bool ReadDDS(const std::string& path, Image& image);
+}
+
+#endif /* BlockCompression_hpp */
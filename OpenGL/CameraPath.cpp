@@ -0,0 +1,135 @@
+//
+//  CameraPath.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "CameraPath.hpp"
+#include "gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+CameraPath CameraPath::Orbit(const glm::vec3& center, float radius, float duration, unsigned int keyframes)
+{
+    CameraPath path;
+    path.mKeyframes.reserve(keyframes + 1);
+
+    for (unsigned int index = 0; index <= keyframes; index++)
+        path.mKeyframes.push_back(OrbitKeyframe(center, radius, duration * index / keyframes));
+
+    return path;
+}
+
+CameraPath::Keyframe CameraPath::OrbitKeyframe(const glm::vec3& center, float radius, float time)
+{
+    Keyframe keyframe;
+    keyframe.time   = time;
+    keyframe.eye    = glm::vec3(std::sin(time) * radius, 0.0f, std::cos(time) * radius);
+    keyframe.center = center;
+    return keyframe;
+}
+
+CameraPath CameraPath::Load(const std::string& path)
+{
+    std::ifstream stream(path);
+    if (!stream.good())
+        throw std::runtime_error("Can't open camera path " + path);
+
+    CameraPath cameraPath;
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream ss(line);
+        Keyframe keyframe;
+        ss >> keyframe.time
+           >> keyframe.eye.x >> keyframe.eye.y >> keyframe.eye.z
+           >> keyframe.center.x >> keyframe.center.y >> keyframe.center.z
+           >> keyframe.viewTranslate.x >> keyframe.viewTranslate.y >> keyframe.viewTranslate.z;
+
+        if (ss.fail())
+            throw std::runtime_error("Bad camera keyframe: " + line);
+
+        cameraPath.AddKeyframe(keyframe);
+    }
+
+    return cameraPath;
+}
+
+void CameraPath::Save(const std::string& path) const
+{
+    std::ofstream stream(path);
+    stream << "# time eye.xyz center.xyz viewTranslate.xyz\n";
+
+    for (const auto& keyframe: mKeyframes)
+    {
+        stream << keyframe.time << ' '
+               << keyframe.eye.x << ' ' << keyframe.eye.y << ' ' << keyframe.eye.z << ' '
+               << keyframe.center.x << ' ' << keyframe.center.y << ' ' << keyframe.center.z << ' '
+               << keyframe.viewTranslate.x << ' ' << keyframe.viewTranslate.y << ' ' << keyframe.viewTranslate.z << '\n';
+    }
+}
+
+void CameraPath::AddKeyframe(const Keyframe& keyframe)
+{
+    /* Keep keyframes sorted, Sample() relies on it. */
+    auto position = std::upper_bound(mKeyframes.begin(), mKeyframes.end(), keyframe.time,
+                                     [](float time, const Keyframe& other){ return time < other.time; });
+    mKeyframes.insert(position, keyframe);
+}
+
+void CameraPath::Clear()
+{
+    mKeyframes.clear();
+}
+
+CameraPath::Keyframe CameraPath::Sample(float time) const
+{
+    if (mKeyframes.empty())
+        throw std::runtime_error("Sampling empty camera path!");
+
+    if (time <= mKeyframes.front().time)
+        return mKeyframes.front();
+
+    if (time >= mKeyframes.back().time)
+        return mKeyframes.back();
+
+    auto next = std::upper_bound(mKeyframes.begin(), mKeyframes.end(), time,
+                                 [](float t, const Keyframe& other){ return t < other.time; });
+    const Keyframe& b = *next;
+    const Keyframe& a = *(next - 1);
+
+    const float span   = b.time - a.time;
+    const float factor = span > 0.0f ? (time - a.time) / span : 0.0f;
+
+    Keyframe result;
+    result.time          = time;
+    result.eye           = glm::mix(a.eye, b.eye, factor);
+    result.center        = glm::mix(a.center, b.center, factor);
+    result.viewTranslate = glm::mix(a.viewTranslate, b.viewTranslate, factor);
+    return result;
+}
+
+glm::mat4 CameraPath::GetViewMatrix(const Keyframe& keyframe)
+{
+    return glm::translate(glm::identity<glm::mat4>(), keyframe.viewTranslate) *
+           glm::lookAt(keyframe.eye, keyframe.center, glm::vec3(0.0, 1.0, 0.0));
+}
+
+glm::mat4 CameraPath::GetViewMatrix(float time) const
+{
+    return GetViewMatrix(Sample(time));
+}
+
+float CameraPath::GetDuration() const
+{
+    return mKeyframes.empty() ? 0.0f : mKeyframes.back().time - mKeyframes.front().time;
+}
@@ -0,0 +1,54 @@
+//
+//  CameraPath.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef CameraPath_hpp
+#define CameraPath_hpp
+
+#include <string>
+#include <vector>
+
+#include "glm.hpp"
+
+/* Keyframed camera, sampled by time so that playback doesn't depend on the frame rate. */
+class CameraPath
+{
+public:
+    struct Keyframe
+    {
+        float     time{};
+        glm::vec3 eye{};
+        glm::vec3 center{};
+        glm::vec3 viewTranslate{};   /* Extra view-space offset, same as the "View Translate" slider. */
+    };
+
+    /* Same circle the viewer has always flown around `center`, one revolution every 2*pi seconds. */
+    static CameraPath Orbit(const glm::vec3& center, float radius, float duration, unsigned int keyframes = 256);
+    static Keyframe   OrbitKeyframe(const glm::vec3& center, float radius, float time);
+
+    /* Text file, one keyframe per line: time eye.xyz center.xyz viewTranslate.xyz */
+    static CameraPath Load(const std::string& path);
+    void Save(const std::string& path) const;
+
+    void AddKeyframe(const Keyframe& keyframe);
+    void Clear();
+
+    /* Linear interpolation between keyframes, clamped to the ends. */
+    Keyframe Sample(float time) const;
+    glm::mat4 GetViewMatrix(float time) const;
+
+    static glm::mat4 GetViewMatrix(const Keyframe& keyframe);
+
+    float GetDuration() const;
+    bool  Empty() const { return mKeyframes.empty(); }
+    const std::vector<Keyframe>& GetKeyframes() const { return mKeyframes; }
+
+private:
+    std::vector<Keyframe> mKeyframes;
+};
+
+#endif /* CameraPath_hpp */
@@ -0,0 +1,296 @@
+//
+//  ClusteredLighting.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "ClusteredLighting.hpp"
+#include "ErrorHandler.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Lighting
+{
+    namespace
+    {
+        constexpr int kTilesPerSlice = ClusterGrid::kClustersX * ClusterGrid::kClustersY;
+        static_assert(kTilesPerSlice <= 0xFFFF, "cluster in slice is packed into 16 bits");
+
+        /* Light indices are packed next to the cluster in 16 bits too. */
+        constexpr size_t kMaxLights = 0xFFFF;
+
+        /* Same constants as ModelObject.shader. */
+        constexpr float kConstant  = 1.0f;
+        constexpr float kLinear    = 0.0022f;
+        constexpr float kQuadratic = 0.000018f;
+
+        bool SphereOverlapsBox(const glm::vec4& sphere, const CommonUtils::BBCoord& box)
+        {
+            const glm::vec3 center(sphere);
+            const glm::vec3 closest = glm::clamp(center, box.Min, box.Max);
+            const glm::vec3 offset  = closest - center;
+            return glm::dot(offset, offset) <= sphere.w * sphere.w;
+        }
+    }
+
+    float AttenuationRadius(const glm::vec3& color)
+    {
+        /* kq d^2 + kl d + kc = 256 * brightest channel. */
+        const float brightest = std::max(std::max(color.r, color.g), std::max(color.b, 1e-4f));
+        const float c = kConstant - 256.0f * brightest;
+        return (-kLinear + std::sqrt(kLinear * kLinear - 4.0f * kQuadratic * c)) / (2.0f * kQuadratic);
+    }
+
+    ClusterGrid::~ClusterGrid()
+    {
+        if (mBuffers[0])
+        {
+            GLCall(glDeleteTextures(3, mTextures));
+            GLCall(glDeleteBuffers(3, mBuffers));
+        }
+
+        for (const auto resource: mBufferResources)
+            GLResources::Release(resource);
+    }
+
+    void ClusterGrid::ComputeClusterBounds()
+    {
+        mClusterBounds.resize(kClusterCount);
+
+        for (int slice = 0; slice < kClustersZ; slice++)
+        {
+            const float sliceNear = mNear * std::pow(mFar / mNear, float(slice) / kClustersZ);
+            const float sliceFar  = mNear * std::pow(mFar / mNear, float(slice + 1) / kClustersZ);
+
+            for (int y = 0; y < kClustersY; y++)
+                for (int x = 0; x < kClustersX; x++)
+                {
+                    const glm::vec2 ndcMin(2.0f * x / kClustersX - 1.0f, 2.0f * y / kClustersY - 1.0f);
+                    const glm::vec2 ndcMax(2.0f * (x + 1) / kClustersX - 1.0f, 2.0f * (y + 1) / kClustersY - 1.0f);
+
+                    /* The tile's view space rectangle grows linearly with depth, its box spans both ends. */
+                    CommonUtils::BBCoord box{glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max())};
+                    for (const float depth: {sliceNear, sliceFar})
+                        for (const glm::vec2& ndc: {ndcMin, ndcMax})
+                        {
+                            const glm::vec3 point(ndc.x * depth / mProj[0][0], ndc.y * depth / mProj[1][1], -depth);
+                            box.Min = glm::min(box.Min, point);
+                            box.Max = glm::max(box.Max, point);
+                        }
+
+                    mClusterBounds[(slice * kClustersY + y) * kClustersX + x] = box;
+                }
+        }
+    }
+
+    void ClusterGrid::Build(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& proj, int width, int height, ThreadPool* pool)
+    {
+        PROFILE_FUNCTION();
+
+        if (proj != mProj || width != mWidth || height != mHeight)
+        {
+            mProj   = proj;
+            mWidth  = std::max(width, 1);
+            mHeight = std::max(height, 1);
+            mNear   = proj[3][2] / (proj[2][2] - 1.0f);
+            mFar    = proj[3][2] / (proj[2][2] + 1.0f);
+            mSliceScale = kClustersZ / std::log(mFar / mNear);
+            ComputeClusterBounds();
+        }
+
+        const size_t lightCount = std::min(lights.size(), kMaxLights);
+
+        mLightData.resize(8 * lightCount);
+        mViewLights.resize(lightCount);
+        mLightTiles.resize(lightCount);
+
+        for (size_t index = 0; index < lightCount; index++)
+        {
+            const PointLight& light = lights[index];
+            float* texels = &mLightData[8 * index];
+            texels[0] = light.position.x; texels[1] = light.position.y; texels[2] = light.position.z; texels[3] = light.radius;
+            texels[4] = light.color.r;    texels[5] = light.color.g;    texels[6] = light.color.b;    texels[7] = 0.0f;
+
+            const glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+            mViewLights[index] = glm::vec4(center, light.radius);
+
+            /* Screen tiles under the projected view space box of the sphere. Crossing the near plane covers everything. */
+            glm::ivec4& tiles = mLightTiles[index];
+            if (center.z + light.radius > -mNear)
+            {
+                tiles = glm::ivec4(0, 0, kClustersX - 1, kClustersY - 1);
+                continue;
+            }
+
+            glm::vec2 ndcMin(std::numeric_limits<float>::max()), ndcMax(-std::numeric_limits<float>::max());
+            for (int corner = 0; corner < 8; corner++)
+            {
+                const glm::vec3 offset((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f);
+                const glm::vec4 clip = proj * glm::vec4(center + light.radius * offset, 1.0f);
+                const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                ndcMin = glm::min(ndcMin, ndc);
+                ndcMax = glm::max(ndcMax, ndc);
+            }
+
+            tiles.x = static_cast<int>(std::floor((ndcMin.x * 0.5f + 0.5f) * kClustersX));
+            tiles.y = static_cast<int>(std::floor((ndcMin.y * 0.5f + 0.5f) * kClustersY));
+            tiles.z = static_cast<int>(std::floor((ndcMax.x * 0.5f + 0.5f) * kClustersX));
+            tiles.w = static_cast<int>(std::floor((ndcMax.y * 0.5f + 0.5f) * kClustersY));
+            tiles = glm::clamp(tiles, glm::ivec4(0), glm::ivec4(kClustersX - 1, kClustersY - 1, kClustersX - 1, kClustersY - 1));
+
+            /* Fully off screen, clamping alone would keep a border column. */
+            if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f)
+                tiles = glm::ivec4(1, 1, 0, 0);
+        }
+
+        mSlicePairs.resize(kClustersZ);
+        mSliceIndices.resize(kClustersZ);
+        mGrid.resize(2 * kClusterCount);
+
+        /* Slices are independent: each writes its own pairs, indices and part of the grid. */
+        auto buildSlices = [&](size_t begin, size_t end) {
+            for (size_t slice = begin; slice < end; slice++)
+            {
+                const float sliceNear = mNear * std::pow(mFar / mNear, float(slice) / kClustersZ);
+                const float sliceFar  = mNear * std::pow(mFar / mNear, float(slice + 1) / kClustersZ);
+                const CommonUtils::BBCoord* bounds = &mClusterBounds[slice * kTilesPerSlice];
+
+                std::vector<unsigned int>& pairs = mSlicePairs[slice];
+                pairs.clear();
+
+                for (size_t light = 0; light < lightCount; light++)
+                {
+                    const glm::vec4& sphere = mViewLights[light];
+                    const float depth = -sphere.z;
+                    if (depth + sphere.w < sliceNear || depth - sphere.w > sliceFar)
+                        continue;
+
+                    const glm::ivec4& tiles = mLightTiles[light];
+                    for (int y = tiles.y; y <= tiles.w; y++)
+                        for (int x = tiles.x; x <= tiles.z; x++)
+                        {
+                            const unsigned int cluster = y * kClustersX + x;
+                            if (SphereOverlapsBox(sphere, bounds[cluster]))
+                                pairs.push_back(cluster << 16 | static_cast<unsigned int>(light));
+                        }
+                }
+
+                /* Counting sort by cluster, stable, so every cluster lists its lights in ascending order. */
+                unsigned int counts[kTilesPerSlice] = {};
+                for (const auto pair: pairs)
+                    counts[pair >> 16]++;
+
+                unsigned int* grid = &mGrid[2 * slice * kTilesPerSlice];
+                unsigned int offset = 0;
+                for (int cluster = 0; cluster < kTilesPerSlice; cluster++)
+                {
+                    grid[2 * cluster]     = offset;
+                    grid[2 * cluster + 1] = counts[cluster];
+                    offset += counts[cluster];
+                }
+
+                std::vector<unsigned int>& indices = mSliceIndices[slice];
+                indices.resize(pairs.size());
+                for (int cluster = 0; cluster < kTilesPerSlice; cluster++)
+                    counts[cluster] = grid[2 * cluster];
+                for (const auto pair: pairs)
+                    indices[counts[pair >> 16]++] = pair & 0xFFFF;
+            }
+        };
+
+        if (pool)
+            pool->ParallelFor(kClustersZ, 1, buildSlices);
+        else
+            buildSlices(0, kClustersZ);
+
+        /* Slice local offsets become global. */
+        size_t total = 0;
+        for (int slice = 0; slice < kClustersZ; slice++)
+        {
+            for (int cluster = 0; cluster < kTilesPerSlice; cluster++)
+                mGrid[2 * (slice * kTilesPerSlice + cluster)] += static_cast<unsigned int>(total);
+
+            total += mSliceIndices[slice].size();
+        }
+
+        mIndices.resize(total);
+        size_t offset = 0;
+        for (const auto& indices: mSliceIndices)
+        {
+            std::copy(indices.begin(), indices.end(), mIndices.begin() + offset);
+            offset += indices.size();
+        }
+    }
+
+    void ClusterGrid::Upload()
+    {
+        PROFILE_FUNCTION();
+
+        if (!mBuffers[0])
+        {
+            GLCall(glGenBuffers(3, mBuffers));
+            GLCall(glGenTextures(3, mTextures));
+
+            const char* labels[3] = {"cluster lights", "cluster grid", "cluster light indices"};
+            for (int buffer = 0; buffer < 3; buffer++)
+                mBufferResources[buffer] = GLResources::Register(GLResources::Type::Buffer, mBuffers[buffer], 0, labels[buffer], GL_RESOURCE_SITE);
+
+            GLint maxTexels = 0;
+            GLCall(glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels));
+            mMaxIndices = static_cast<size_t>(maxTexels);
+        }
+
+        /* Rare, the guaranteed minimum is 64k texels: clusters past the limit lose their tail. */
+        mDropped = 0;
+        if (mIndices.size() > mMaxIndices)
+        {
+            for (int cluster = 0; cluster < kClusterCount; cluster++)
+            {
+                unsigned int& first = mGrid[2 * cluster];
+                unsigned int& count = mGrid[2 * cluster + 1];
+                const unsigned int kept = first >= mMaxIndices ? 0 : static_cast<unsigned int>(std::min<size_t>(count, mMaxIndices - first));
+                mDropped += count - kept;
+                count = kept;
+            }
+            mIndices.resize(mMaxIndices);
+        }
+
+        /* glBufferData every frame orphans the old store, no waiting on draws still reading it. */
+        auto upload = [this](int buffer, GLenum format, const void* data, size_t bytes) {
+            static const unsigned int kEmpty[4] = {};
+            if (bytes == 0)
+            {
+                data  = kEmpty;
+                bytes = sizeof(kEmpty);
+            }
+
+            GLCall(glBindBuffer(GL_TEXTURE_BUFFER, mBuffers[buffer]));
+            GLCall(glBufferData(GL_TEXTURE_BUFFER, bytes, data, GL_STREAM_DRAW));
+            GLResources::SetByteSize(mBufferResources[buffer], bytes);
+            GLCall(glBindTexture(GL_TEXTURE_BUFFER, mTextures[buffer]));
+            GLCall(glTexBuffer(GL_TEXTURE_BUFFER, format, mBuffers[buffer]));
+        };
+
+        upload(0, GL_RGBA32F, mLightData.data(), mLightData.size() * sizeof(float));
+        upload(1, GL_RG32UI,  mGrid.data(),      mGrid.size() * sizeof(unsigned int));
+        upload(2, GL_R32UI,   mIndices.data(),   mIndices.size() * sizeof(unsigned int));
+
+        GLCall(glBindTexture(GL_TEXTURE_BUFFER, 0));
+        GLCall(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+    }
+
+    void ClusterGrid::Bind(unsigned int lightsSlot, unsigned int gridSlot, unsigned int indicesSlot) const
+    {
+        const unsigned int slots[3] = {lightsSlot, gridSlot, indicesSlot};
+        for (int index = 0; index < 3; index++)
+        {
+            GLCall(glActiveTexture(GL_TEXTURE0 + slots[index]));
+            GLCall(glBindTexture(GL_TEXTURE_BUFFER, mTextures[index]));
+        }
+    }
+}
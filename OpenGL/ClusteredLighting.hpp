@@ -0,0 +1,97 @@
+//
+//  ClusteredLighting.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef ClusteredLighting_hpp
+#define ClusteredLighting_hpp
+
+#include "CommonUtils.hpp"
+#include "GLResources.hpp"
+
+#include <vector>
+
+class ThreadPool;
+
+namespace Lighting
+{
+    struct PointLight
+    {
+        glm::vec3 position;
+        float     radius;       /* No contribution past this distance. */
+        glm::vec3 color;
+    };
+
+    /* Distance at which the viewer's attenuation curve drops a light of this color below 1/256. */
+    float AttenuationRadius(const glm::vec3& color);
+
+    /*
+     * Froxel grid over the view frustum (screen tiles, exponential depth slices) listing the point lights that
+     * reach each cluster. Built on the CPU, one depth slice per task, then uploaded as texture buffers since
+     * GL 3.2 has no storage buffers:
+     *   lights  RGBA32F, 2 texels per light (position, radius) (color, 0)
+     *   grid    RG32UI, per cluster (first index, count), x fastest then y then z
+     *   indices R32UI, light indices, each cluster's range in ascending light order
+     */
+    class ClusterGrid
+    {
+    public:
+        static constexpr int kClustersX = 16;
+        static constexpr int kClustersY = 9;
+        static constexpr int kClustersZ = 24;
+        static constexpr int kClusterCount = kClustersX * kClustersY * kClustersZ;
+
+        /* GL objects are created by the first Upload, Build alone works without a context. */
+        ClusterGrid() = default;
+        ~ClusterGrid();
+
+        ClusterGrid(const ClusterGrid&) = delete;
+        ClusterGrid& operator=(const ClusterGrid&) = delete;
+
+        /* proj from glm::perspective, width and height of the viewport in pixels. pool may be null. */
+        void Build(const std::vector<PointLight>& lights, const glm::mat4& view, const glm::mat4& proj, int width, int height, ThreadPool* pool);
+        void Upload();
+        void Bind(unsigned int lightsSlot, unsigned int gridSlot, unsigned int indicesSlot) const;
+
+        /* Shader side: cluster = floor(fragCoord.xy * tileScale), slice = floor(log(depth / near) * sliceScale). */
+        glm::vec2 GetTileScale() const { return glm::vec2(kClustersX / float(mWidth), kClustersY / float(mHeight)); }
+        float GetNear() const { return mNear; }
+        float GetSliceScale() const { return mSliceScale; }
+
+        const std::vector<unsigned int>& GetGrid() const { return mGrid; }
+        const std::vector<unsigned int>& GetIndices() const { return mIndices; }
+        size_t GetLightCount() const { return mLightData.size() / 8; }
+        /* Entries dropped because the index buffer hit GL_MAX_TEXTURE_BUFFER_SIZE. */
+        size_t GetDroppedCount() const { return mDropped; }
+
+    private:
+        void ComputeClusterBounds();
+
+        int       mWidth  = 0;
+        int       mHeight = 0;
+        float     mNear   = 0.1f;
+        float     mFar    = 100.0f;
+        float     mSliceScale = 0.0f;
+        glm::mat4 mProj{0.0f};
+
+        std::vector<CommonUtils::BBCoord>      mClusterBounds;     /* View space, rebuilt when proj or size change. */
+        std::vector<float>                     mLightData;
+        std::vector<glm::vec4>                 mViewLights;         /* View space center, radius. */
+        std::vector<glm::ivec4>                mLightTiles;         /* Screen tile range, x0 y0 x1 y1. */
+        std::vector<std::vector<unsigned int>> mSlicePairs;         /* Per slice, cluster in slice << 16 | light. */
+        std::vector<std::vector<unsigned int>> mSliceIndices;       /* Per slice, pairs sorted by cluster. */
+        std::vector<unsigned int>              mGrid;
+        std::vector<unsigned int>              mIndices;
+        size_t                                 mDropped = 0;
+        size_t                                 mMaxIndices = 0;    /* Known after the first Upload. */
+
+        unsigned int mBuffers[3]{};
+        unsigned int mTextures[3]{};
+        GLResources::Handle mBufferResources[3]{};
+    };
+}
+
+#endif /* ClusteredLighting_hpp */
@@ -10,6 +10,11 @@
 #define CommonUtils_h
 
 #include "gtx/euler_angles.hpp"
+#include "TriangleMesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace CommonUtils
 {
@@ -19,7 +24,7 @@ namespace CommonUtils
         glm::vec3 Max;
     };
     
-    BBCoord GetBBox(const std::vector<BBCoord>& vertices)
+    inline BBCoord GetBBox(const std::vector<BBCoord>& vertices)
     {
         BBCoord boundingBox = vertices[0];
         
@@ -37,7 +42,7 @@ namespace CommonUtils
         return boundingBox;
     }
     
-    BBCoord GetBBox(const std::vector<float>& serializedVertices)
+    inline BBCoord GetBBox(const std::vector<float>& serializedVertices)
     {
         BBCoord boundingBox{};
         
@@ -63,19 +68,46 @@ namespace CommonUtils
         return boundingBox;
     }
     
-    BBCoord GetBBox(const TriangleMesh& model)
+    /* Bounds of the transformed box (Arvo), matrix must be affine. */
+    inline BBCoord TransformBBox(const BBCoord& bbox, const glm::mat4& matrix)
     {
-        std::vector<CommonUtils::BBCoord> objectBBs;
-        auto modelMeshes = model.GetModelMesh();
-        objectBBs.reserve(modelMeshes.size());
+        BBCoord transformed{glm::vec3(matrix[3]), glm::vec3(matrix[3])};
+        
+        for (int column = 0; column < 3; column++)
+        {
+            for (int row = 0; row < 3; row++)
+            {
+                const float a = matrix[column][row] * bbox.Min[column];
+                const float b = matrix[column][row] * bbox.Max[column];
+                transformed.Min[row] += std::min(a, b);
+                transformed.Max[row] += std::max(a, b);
+            }
+        }
+        
+        return transformed;
+    }
+
+    /* Every mesh where the model's node hierarchy puts it. */
+    inline BBCoord GetBBox(const TriangleMesh& model)
+    {
+        std::vector<CommonUtils::BBCoord> meshBBs;
+        const auto& modelMeshes = model.GetModelMesh();
+        meshBBs.reserve(modelMeshes.size());
         
         for (const auto& mesh: modelMeshes)
-            objectBBs.emplace_back(CommonUtils::GetBBox(mesh.second.mPositions));
+            meshBBs.emplace_back(CommonUtils::GetBBox(mesh.second.mPositions));
+        
+        const SceneGraph& graph = model.GetSceneGraph();
+        std::vector<CommonUtils::BBCoord> objectBBs;
+        objectBBs.reserve(graph.GetMeshInstances().size());
+        
+        for (const auto& instance: graph.GetMeshInstances())
+            objectBBs.emplace_back(TransformBBox(meshBBs[instance.mesh], graph.GetWorldTransform(instance.node)));
         
         return CommonUtils::GetBBox(objectBBs);
     }
     
-    BBCoord GetBBox(const std::vector<TriangleMesh>& meshes)
+    inline BBCoord GetBBox(const std::vector<TriangleMesh>& meshes)
     {
         std::vector<BBCoord> boundingBoxes;
         boundingBoxes.reserve(meshes.size());
@@ -88,7 +120,7 @@ namespace CommonUtils
         return GetBBox(boundingBoxes);
     }
     
-    BBCoord GetBBox(const std::vector<std::vector<float>>& serializedVerticesVec)
+    inline BBCoord GetBBox(const std::vector<std::vector<float>>& serializedVerticesVec)
     {
         std::vector<BBCoord> boundingBoxes;
         boundingBoxes.reserve(serializedVerticesVec.size());
@@ -101,7 +133,7 @@ namespace CommonUtils
         return GetBBox(boundingBoxes);
     }
     
-    glm::vec3 GetBBoxCenter(const BBCoord& bbox)
+    inline glm::vec3 GetBBoxCenter(const BBCoord& bbox)
     {
         return glm::vec3 {
             (bbox.Min.x + bbox.Max.x)/2.0f,
@@ -110,17 +142,17 @@ namespace CommonUtils
         };
     }
 
-    float GetBBoxHeight(const BBCoord& bbox)
+    inline float GetBBoxHeight(const BBCoord& bbox)
     {
         return (bbox.Max.y - bbox.Min.y);
     }
 
-    float GetBBoxWidth(const BBCoord& bbox)
+    inline float GetBBoxWidth(const BBCoord& bbox)
     {
         return (bbox.Max.x - bbox.Min.x);
     }
 
-    glm::mat4 GenerateOrthoMatrix(BBCoord span, float aspectRatio)
+    inline glm::mat4 GenerateOrthoMatrix(BBCoord span, float aspectRatio)
     {
         float width  = std::fabs(span.Min.x - span.Max.x);
         float height = std::fabs(span.Min.y - span.Max.y);
@@ -143,6 +175,7 @@ namespace CommonUtils
     
     struct ModelMatrix
     {
+        ModelMatrix() = default;
         ModelMatrix(const BBCoord& completeSpan, const BBCoord& meshSpan)
         {
             fLocalCenter.x = ( completeSpan.Min.x + completeSpan.Max.x ) / 2.0f;
@@ -158,22 +191,53 @@ namespace CommonUtils
         glm::vec3 fTranslation {0.0f, 0.0f, 0.0f};
         glm::vec3 fScale       {1.0f, 1.0f, 1.0f};
         
-        glm::mat4 GetMatrix()
+        /* Composed once for every change of fAngle, fTranslation or fScale. Not for concurrent use, copy it. */
+        const glm::mat4& GetMatrix() const
         {
-            /* TODO: Optimise and organise*/
-            auto TranslateToOrigin  = glm::translate(glm::identity<glm::mat4>(), -fMeshCenter);
-            auto Scale              = glm::scale(glm::identity<glm::mat4>(), glm::vec3(fScale.x, fScale.y, fScale.z));
-            auto Rotate             = glm::eulerAngleXYZ(fAngle.x, fAngle.y, fAngle.z);
-            auto Translate          = glm::translate(glm::identity<glm::mat4>(), fTranslation);
-            auto TranslateToInitial = glm::translate(glm::identity<glm::mat4>(), fMeshCenter);
-            
-            return TranslateToInitial * Translate * Rotate * Scale * TranslateToOrigin;
+            Update();
+            return mMatrix;
+        }
+        
+        /* Inverse transpose of the upper 3x3, for normals. */
+        const glm::mat3& GetNormalMatrix() const
+        {
+            Update();
+            return mNormalMatrix;
         }
         
     private:
         glm::vec3 fMeshCenter{};
         glm::vec3 fLocalCenter{};
         glm::vec3 fWorldCenter{0.0f, 0.0f, 0.0f};
+        
+        /* Of the fAngle, fTranslation and fScale the matrices were composed from. */
+        mutable bool      mCached = false;
+        mutable glm::vec3 mCachedAngle{};
+        mutable glm::vec3 mCachedTranslation{};
+        mutable glm::vec3 mCachedScale{};
+        mutable glm::mat4 mMatrix{1.0f};
+        mutable glm::mat3 mNormalMatrix{1.0f};
+        
+        void Update() const
+        {
+            if (mCached && fAngle == mCachedAngle && fTranslation == mCachedTranslation && fScale == mCachedScale)
+                return;
+            
+            /* Translate(center + t) * Rotate * Scale * Translate(-center), without the 4x4 products. */
+            const glm::mat3 rotate(glm::eulerAngleXYZ(fAngle.x, fAngle.y, fAngle.z));
+            const glm::mat3 rotateScale(rotate[0] * fScale.x, rotate[1] * fScale.y, rotate[2] * fScale.z);
+            
+            mMatrix = glm::mat4(rotateScale);
+            mMatrix[3] = glm::vec4(fMeshCenter + fTranslation - rotateScale * fMeshCenter, 1.0f);
+            
+            /* The rotation is orthonormal, (R S)^-T = R S^-1. */
+            mNormalMatrix = glm::mat3(rotate[0] / fScale.x, rotate[1] / fScale.y, rotate[2] / fScale.z);
+            
+            mCachedAngle       = fAngle;
+            mCachedTranslation = fTranslation;
+            mCachedScale       = fScale;
+            mCached            = true;
+        }
     };
     
 }
@@ -0,0 +1,460 @@
+//
+//  FrameGraph.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "FrameGraph.hpp"
+#include "ErrorHandler.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+FrameGraph::Resource FrameGraph::Builder::Create(const std::string& name, const FramebufferPool::Format& format)
+{
+    ResourceNode resource;
+    resource.name   = name;
+    resource.format = format;
+    mGraph.mResources.push_back(resource);
+    return mGraph.mResources.size() - 1;
+}
+
+void FrameGraph::Builder::Read(Resource resource)
+{
+    mGraph.mPasses[mPass].reads.push_back(resource);
+}
+
+void FrameGraph::Builder::Write(Resource resource, bool overwritesAll)
+{
+    ASSERT(mGraph.mResources[resource].kind != Kind::Imported);
+    mGraph.mPasses[mPass].writes.push_back({resource, overwritesAll});
+}
+
+void FrameGraph::Builder::SideEffect()
+{
+    mGraph.mPasses[mPass].sideEffect = true;
+}
+
+FrameGraph::FrameGraph(FramebufferPool& pool): mPool(pool)
+{
+}
+
+FrameGraph::~FrameGraph()
+{
+    Reset();
+}
+
+void FrameGraph::Reset()
+{
+    for (auto& resource: mResources)
+        mPool.Release(resource.attachment);
+
+    mResources.clear();
+    mPasses.clear();
+    mCompiled = false;
+    mPeakTransientBytes = mTransientBytes = 0;
+}
+
+FrameGraph::Resource FrameGraph::ImportBackbuffer(const std::string& name, int width, int height)
+{
+    ResourceNode resource;
+    resource.name   = name;
+    resource.kind   = Kind::Backbuffer;
+    resource.format = {width, height, GL_RGBA8, 1};
+    mResources.push_back(resource);
+    return mResources.size() - 1;
+}
+
+FrameGraph::Resource FrameGraph::ImportTexture(const std::string& name, unsigned int texture, int width, int height)
+{
+    ResourceNode resource;
+    resource.name    = name;
+    resource.kind    = Kind::Imported;
+    resource.format  = {width, height, GL_RGBA8, 1};
+    resource.texture = texture;
+    mResources.push_back(resource);
+    return mResources.size() - 1;
+}
+
+void FrameGraph::SetOutput(Resource resource)
+{
+    mResources[resource].output = true;
+}
+
+void FrameGraph::AddPass(const std::string& name, const Setup& setup, const Execute& execute)
+{
+    PassNode pass;
+    pass.name    = name;
+    pass.execute = execute;
+    mPasses.push_back(pass);
+
+    Builder builder(*this, mPasses.size() - 1);
+    setup(builder);
+}
+
+void FrameGraph::Compile()
+{
+    PROFILE_SCOPE("FrameGraph::Compile");
+
+    /* Cull from the unread resources backwards, a pass goes once nothing reads any of what it writes. */
+    for (auto& resource: mResources)
+    {
+        resource.writers.clear();
+        resource.readers = 0;
+        resource.firstUse = resource.lastUse = resource.slot = kNone;
+    }
+    for (size_t index = 0; index < mPasses.size(); index++)
+    {
+        PassNode& pass = mPasses[index];
+        pass.culled     = false;
+        pass.references = pass.writes.size();
+        for (const auto resource: pass.reads)
+            mResources[resource].readers++;
+        for (const auto& write: pass.writes)
+        {
+            mResources[write.resource].writers.push_back(index);
+            if (mResources[write.resource].kind == Kind::Backbuffer || mResources[write.resource].output)
+                pass.sideEffect = true;
+        }
+    }
+
+    /* Nothing to show for it at all. */
+    for (auto& pass: mPasses)
+    {
+        if (!pass.writes.empty() || pass.sideEffect)
+            continue;
+
+        pass.culled = true;
+        for (const auto resource: pass.reads)
+            mResources[resource].readers--;
+    }
+
+    std::vector<Resource> unread;
+    for (Resource index = 0; index < mResources.size(); index++)
+        if (!mResources[index].readers && !mResources[index].output && mResources[index].kind != Kind::Backbuffer)
+            unread.push_back(index);
+
+    while (!unread.empty())
+    {
+        const Resource resource = unread.back();
+        unread.pop_back();
+
+        for (const auto writer: mResources[resource].writers)
+        {
+            PassNode& pass = mPasses[writer];
+            if (pass.sideEffect || pass.culled || --pass.references)
+                continue;
+
+            pass.culled = true;
+            for (const auto read: pass.reads)
+                if (!--mResources[read].readers && !mResources[read].output && mResources[read].kind != Kind::Backbuffer)
+                    unread.push_back(read);
+        }
+    }
+
+    /* Lifetimes over the kept passes, outputs live to the end of the frame. */
+    for (size_t index = 0; index < mPasses.size(); index++)
+    {
+        PassNode& pass = mPasses[index];
+        pass.backbuffer = false;
+        pass.colors.clear();
+        pass.depth = kNone;
+        pass.invalidates.clear();
+        if (pass.culled)
+            continue;
+
+        auto use = [&](Resource resource) {
+            ResourceNode& node = mResources[resource];
+            node.firstUse = std::min(node.firstUse, index);
+            node.lastUse  = node.output ? mPasses.size() : index;
+        };
+
+        for (const auto resource: pass.reads)
+            use(resource);
+
+        for (auto& write: pass.writes)
+        {
+            ResourceNode& node = mResources[write.resource];
+            write.clear = !IsAlive(node) && !write.overwritesAll;
+            use(write.resource);
+
+            if (node.kind == Kind::Backbuffer)
+                pass.backbuffer = true;
+            else if (FramebufferPool::IsDepthFormat(node.format.internalFormat))
+                pass.depth = write.resource;
+            else
+                pass.colors.push_back(write.resource);
+        }
+
+        /* One framebuffer per pass: the default one or transients. */
+        ASSERT(!pass.backbuffer || (pass.colors.empty() && pass.depth == kNone));
+    }
+
+    for (size_t index = 0; index < mPasses.size(); index++)
+        for (const auto& write: mPasses[index].writes)
+            if (mResources[write.resource].kind == Kind::Transient && mResources[write.resource].lastUse == index)
+                mPasses[index].invalidates.push_back(write.resource);
+
+    /*
+     * The pool hands a released attachment to the next request of its format: a transient shares the slot of one
+     * whose last use was an earlier pass. Same walk as Run, for the numbers.
+     */
+    struct Slot
+    {
+        FramebufferPool::Format format;
+        size_t                  lastUse;
+    };
+    std::vector<Slot> slots;
+
+    mTransientBytes = mPeakTransientBytes = 0;
+    for (size_t index = 0; index < mPasses.size(); index++)
+    {
+        if (mPasses[index].culled)
+            continue;
+
+        size_t liveBytes = 0;
+        for (auto& resource: mResources)
+        {
+            if (resource.kind != Kind::Transient || !IsAlive(resource) || resource.firstUse > index || resource.lastUse < index)
+                continue;
+            liveBytes += FramebufferPool::GetByteSize(resource.format);
+
+            if (resource.firstUse != index)
+                continue;
+            mTransientBytes += FramebufferPool::GetByteSize(resource.format);
+
+            const auto free = std::find_if(slots.begin(), slots.end(), [&](const Slot& slot) { return slot.format == resource.format && slot.lastUse < index; });
+            if (free == slots.end())
+            {
+                resource.slot = slots.size();
+                slots.push_back({resource.format, resource.lastUse});
+            }
+            else
+            {
+                resource.slot = free - slots.begin();
+                free->lastUse = resource.lastUse;
+            }
+        }
+
+        mPeakTransientBytes = std::max(mPeakTransientBytes, liveBytes);
+    }
+
+    mCompiled = true;
+}
+
+void FrameGraph::Run()
+{
+    PROFILE_SCOPE("FrameGraph::Run");
+    ASSERT(mCompiled);
+
+    int viewPort[4]{};
+    GLCall(glGetIntegerv(GL_VIEWPORT, viewPort));
+
+    for (size_t index = 0; index < mPasses.size(); index++)
+    {
+        if (mPasses[index].culled)
+            continue;
+
+        Begin(index);
+        mPasses[index].execute(*this);
+        End(index);
+    }
+
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    GLCall(glViewport(viewPort[0], viewPort[1], viewPort[2], viewPort[3]));
+}
+
+void FrameGraph::Begin(size_t index)
+{
+    const PassNode& pass = mPasses[index];
+
+    for (auto& resource: mResources)
+        if (resource.kind == Kind::Transient && resource.firstUse == index)
+            resource.attachment = mPool.Acquire(resource.format);
+
+    if (pass.backbuffer)
+    {
+        const ResourceNode& backbuffer = mResources[pass.writes.front().resource];
+        GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+        GLCall(glViewport(0, 0, backbuffer.format.width, backbuffer.format.height));
+
+        if (std::any_of(pass.writes.begin(), pass.writes.end(), [](const Write& write) { return write.clear; }))
+        {
+            GLCall(glClearColor(fClearColor.r, fClearColor.g, fClearColor.b, fClearColor.a));
+            GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
+        }
+        return;
+    }
+
+    if (pass.colors.empty() && pass.depth == kNone)
+        return;
+
+    std::vector<size_t> colors;
+    for (const auto resource: pass.colors)
+        colors.push_back(mResources[resource].attachment);
+    const size_t depth = pass.depth == kNone ? FramebufferPool::kNone : mResources[pass.depth].attachment;
+
+    const ResourceNode& target = mResources[pass.colors.empty() ? pass.depth : pass.colors.front()];
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, mPool.GetFramebuffer(colors, depth)));
+    GLCall(glViewport(0, 0, target.format.width, target.format.height));
+
+    /* Only what a pooled attachment held before is undefined, no clear for what this frame already drew. */
+    for (const auto& write: pass.writes)
+    {
+        if (!write.clear)
+            continue;
+
+        if (write.resource == pass.depth)
+        {
+            if (FramebufferPool::HasStencil(mResources[write.resource].format.internalFormat))
+            {
+                GLCall(glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0));
+            }
+            else
+            {
+                const float one = 1.0f;
+                GLCall(glClearBufferfv(GL_DEPTH, 0, &one));
+            }
+        }
+        else
+        {
+            const auto drawBuffer = std::find(pass.colors.begin(), pass.colors.end(), write.resource) - pass.colors.begin();
+            GLCall(glClearBufferfv(GL_COLOR, static_cast<GLint>(drawBuffer), &fClearColor.r));
+        }
+    }
+}
+
+void FrameGraph::End(size_t index)
+{
+    const PassNode& pass = mPasses[index];
+
+    if (!pass.invalidates.empty() && (GLEW_VERSION_4_3 || GLEW_ARB_invalidate_subdata))
+    {
+        std::vector<GLenum> attachments;
+        for (const auto resource: pass.invalidates)
+        {
+            if (resource == pass.depth)
+                attachments.push_back(FramebufferPool::HasStencil(mResources[resource].format.internalFormat) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT);
+            else
+                attachments.push_back(static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + (std::find(pass.colors.begin(), pass.colors.end(), resource) - pass.colors.begin())));
+        }
+
+        /* The pass may have drawn elsewhere in between, e.g. into the shadow map. */
+        std::vector<size_t> colors;
+        for (const auto resource: pass.colors)
+            colors.push_back(mResources[resource].attachment);
+        const size_t depth = pass.depth == kNone ? FramebufferPool::kNone : mResources[pass.depth].attachment;
+
+        GLCall(glBindFramebuffer(GL_FRAMEBUFFER, mPool.GetFramebuffer(colors, depth)));
+        GLCall(glInvalidateFramebuffer(GL_FRAMEBUFFER, static_cast<GLsizei>(attachments.size()), attachments.data()));
+    }
+
+    for (auto& resource: mResources)
+    {
+        if (resource.kind == Kind::Transient && resource.lastUse == index)
+        {
+            mPool.Release(resource.attachment);
+            resource.attachment = FramebufferPool::kNone;
+        }
+    }
+}
+
+unsigned int FrameGraph::GetTexture(Resource resource) const
+{
+    const ResourceNode& node = mResources[resource];
+    if (node.kind == Kind::Imported)
+        return node.texture;
+    if (node.kind == Kind::Backbuffer || node.attachment == FramebufferPool::kNone)
+        return 0;
+    return mPool.GetAttachment(node.attachment).name;
+}
+
+void FrameGraph::BindTexture(Resource resource, unsigned int slot) const
+{
+    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+    GLCall(glBindTexture(GL_TEXTURE_2D, GetTexture(resource)));
+}
+
+unsigned int FrameGraph::GetFramebuffer(Resource resource) const
+{
+    const ResourceNode& node = mResources[resource];
+    if (node.kind != Kind::Transient || node.attachment == FramebufferPool::kNone)
+        return 0;
+
+    const bool depth = FramebufferPool::IsDepthFormat(node.format.internalFormat);
+    return mPool.GetFramebuffer(depth ? std::vector<size_t>() : std::vector<size_t>{node.attachment}, depth ? node.attachment : FramebufferPool::kNone);
+}
+
+size_t FrameGraph::GetCulledPassCount() const
+{
+    return std::count_if(mPasses.begin(), mPasses.end(), [](const PassNode& pass) { return pass.culled; });
+}
+
+void FrameGraph::Print(std::ostream& stream) const
+{
+    auto megabytes = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+
+    stream << "Frame graph, " << mPasses.size() << " passes, " << GetCulledPassCount() << " culled" << std::endl;
+    for (const auto& pass: mPasses)
+    {
+        stream << "    " << pass.name << (pass.culled ? " (culled)" : "");
+
+        if (!pass.reads.empty())
+        {
+            stream << ", reads";
+            for (size_t index = 0; index < pass.reads.size(); index++)
+                stream << (index ? ", " : " ") << mResources[pass.reads[index]].name;
+        }
+
+        if (!pass.writes.empty())
+        {
+            stream << ", writes";
+            for (size_t index = 0; index < pass.writes.size(); index++)
+            {
+                const Write& write = pass.writes[index];
+                const bool invalidated = std::find(pass.invalidates.begin(), pass.invalidates.end(), write.resource) != pass.invalidates.end();
+                stream << (index ? ", " : " ") << mResources[write.resource].name;
+                if (write.clear || invalidated)
+                    stream << " (" << (write.clear ? "clear" : "") << (write.clear && invalidated ? ", " : "") << (invalidated ? "invalidate" : "") << ")";
+            }
+        }
+
+        if (pass.sideEffect)
+            stream << ", kept";
+        stream << std::endl;
+    }
+
+    stream << "Transients" << std::endl;
+    for (const auto& resource: mResources)
+    {
+        if (resource.kind != Kind::Transient)
+            continue;
+
+        stream << "    " << resource.name << " " << resource.format.width << "x" << resource.format.height << " 0x" << std::hex
+               << resource.format.internalFormat << std::dec;
+        if (resource.format.samples > 1)
+            stream << " x" << resource.format.samples;
+        stream << std::fixed << std::setprecision(2) << ", " << megabytes(FramebufferPool::GetByteSize(resource.format)) << " MB";
+
+        if (IsAlive(resource))
+        {
+            stream << ", passes " << resource.firstUse << " to ";
+            if (resource.output)
+                stream << "end";
+            else
+                stream << resource.lastUse;
+            stream << ", slot " << resource.slot;
+        }
+        else
+        {
+            stream << ", unused";
+        }
+        stream << std::endl;
+    }
+
+    stream << std::fixed << std::setprecision(2) << "Transient memory " << megabytes(mPeakTransientBytes) << " MB at peak, "
+           << megabytes(mTransientBytes) << " MB without aliasing" << std::endl;
+}
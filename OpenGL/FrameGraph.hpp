@@ -0,0 +1,150 @@
+//
+//  FrameGraph.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef FrameGraph_hpp
+#define FrameGraph_hpp
+
+#include "FramebufferPool.hpp"
+#include "glm.hpp"
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * The passes of a frame, declared each frame with what they read and write, then compiled and run in declaration
+ * order. Compile culls passes nothing kept reads from (passes writing the backbuffer or an output, or marked as
+ * having side effects, are kept), and works out when each transient texture is first and last used. Run takes
+ * a transient's attachment from the FramebufferPool just before its first use and gives it back right after its
+ * last, so later transients of the same size and format share its memory within the frame.
+ *
+ * A transient is cleared by its first writer unless that pass overwrites all of it. Attachments whose content is
+ * dead when their last writing pass ends are invalidated (glInvalidateFramebuffer, when supported), so a tiler
+ * need not store them.
+ */
+class FrameGraph
+{
+public:
+    using Resource = size_t;
+    static constexpr Resource kNone = static_cast<Resource>(-1);
+
+    class Builder
+    {
+    public:
+        /* A texture living only within this frame, its first writer should be this pass. */
+        Resource Create(const std::string& name, const FramebufferPool::Format& format);
+        void     Read(Resource resource);
+        /* overwritesAll skips the clear of a first write, e.g. a full screen pass. */
+        void     Write(Resource resource, bool overwritesAll = false);
+        /* Kept even when nothing reads what it writes, e.g. a readback. */
+        void     SideEffect();
+
+    private:
+        friend class FrameGraph;
+        Builder(FrameGraph& graph, size_t pass): mGraph(graph), mPass(pass) {}
+
+        FrameGraph& mGraph;
+        size_t      mPass;
+    };
+
+    using Setup   = std::function<void(Builder&)>;
+    using Execute = std::function<void(const FrameGraph&)>;
+
+    explicit FrameGraph(FramebufferPool& pool);
+    ~FrameGraph();
+
+    FrameGraph(const FrameGraph&) = delete;
+    FrameGraph& operator=(const FrameGraph&) = delete;
+
+    /* Drops the previous frame's passes and gives back its outputs. */
+    void Reset();
+
+    /* The default framebuffer, what writes it is never culled. */
+    Resource ImportBackbuffer(const std::string& name, int width, int height);
+    /* A texture made elsewhere, e.g. the shadow map, read only. */
+    Resource ImportTexture(const std::string& name, unsigned int texture, int width, int height);
+    /* Kept after Run until the next Reset, e.g. for a readback. */
+    void     SetOutput(Resource resource);
+
+    void AddPass(const std::string& name, const Setup& setup, const Execute& execute);
+
+    void Compile();
+    void Run();
+
+    /* Texture of a resource, valid while the pass reading or writing it runs. */
+    unsigned int GetTexture(Resource resource) const;
+    void         BindTexture(Resource resource, unsigned int slot) const;
+    /* Framebuffer with just the resource attached, e.g. to read it back. 0 for the backbuffer. */
+    unsigned int GetFramebuffer(Resource resource) const;
+    const FramebufferPool::Format& GetFormat(Resource resource) const { return mResources[resource].format; }
+
+    /* Passes, their resources and clears, invalidations and aliasing, as compiled. */
+    void Print(std::ostream& stream) const;
+
+    size_t GetPassCount() const { return mPasses.size(); }
+    size_t GetCulledPassCount() const;
+    /* Most transient bytes alive at once, and what the transients would take without sharing. */
+    size_t GetPeakTransientBytes() const { return mPeakTransientBytes; }
+    size_t GetTransientBytes() const { return mTransientBytes; }
+
+    glm::vec4 fClearColor{0.0f, 0.0f, 0.0f, 1.0f};
+
+private:
+    enum class Kind { Transient, Backbuffer, Imported };
+
+    struct ResourceNode
+    {
+        std::string             name;
+        Kind                    kind = Kind::Transient;
+        FramebufferPool::Format format;
+        unsigned int            texture = 0;            /* Imported ones only. */
+        bool                    output = false;
+        std::vector<size_t>     writers;
+        size_t                  readers = 0;            /* Kept passes reading it, counted down while culling. */
+        size_t                  firstUse = kNone;       /* Kept passes, kNone when culled away. */
+        size_t                  lastUse = kNone;
+        size_t                  slot = kNone;           /* Transients sharing a slot share memory. */
+        size_t                  attachment = FramebufferPool::kNone;
+    };
+
+    struct Write
+    {
+        Resource resource;
+        bool     overwritesAll;
+        bool     clear = false;                         /* First kept writer of the resource. */
+    };
+
+    struct PassNode
+    {
+        std::string           name;
+        Execute               execute;
+        std::vector<Resource> reads;
+        std::vector<Write>    writes;
+        bool                  sideEffect = false;
+        size_t                references = 0;          /* Written resources still read, counted down while culling. */
+        bool                  culled = false;
+        bool                  backbuffer = false;      /* Draws into the default framebuffer, */
+        std::vector<Resource> colors;                  /* or into these, */
+        Resource              depth = kNone;           /* and this. */
+        std::vector<Resource> invalidates;             /* Written and dead once the pass ends. */
+    };
+
+    bool IsAlive(const ResourceNode& resource) const { return resource.firstUse != kNone; }
+    void Begin(size_t pass);
+    void End(size_t pass);
+
+    FramebufferPool&          mPool;
+    std::vector<ResourceNode> mResources;
+    std::vector<PassNode>     mPasses;
+    bool                      mCompiled = false;
+    size_t                    mPeakTransientBytes = 0;
+    size_t                    mTransientBytes = 0;
+};
+
+#endif /* FrameGraph_hpp */
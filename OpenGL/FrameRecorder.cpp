@@ -0,0 +1,230 @@
+//
+//  FrameRecorder.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "FrameRecorder.hpp"
+#include "ImageWriter.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace
+{
+    bool EndsWith(const std::string& text, const std::string& suffix)
+    {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    unsigned char ToByte(float value)
+    {
+        return static_cast<unsigned char>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+    }
+}
+
+FrameRecorder::Format FrameRecorder::GetFormat(const std::string& path)
+{
+    if (EndsWith(path, ".y4m"))
+        return Format::Y4M;
+    if (EndsWith(path, ".raw"))
+        return Format::Raw;
+    return Format::PNG;
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    Stop();
+}
+
+bool FrameRecorder::Start(const std::string& path, int width, int height, float fps)
+{
+    Stop();
+
+    mPath   = path;
+    mFormat = GetFormat(path);
+    mWidth  = width;
+    mHeight = height;
+    mFps    = fps;
+    mCaptured = 0;
+    mEncoded  = 0;
+    mEncodeNanoseconds = 0;
+    mBackpressureTime  = 0.0;
+
+    if (mFormat != Format::PNG)
+    {
+        mFile.open(path, std::ios::binary);
+        if (!mFile)
+        {
+            std::cout << "Can't record to " << path << std::endl;
+            return false;
+        }
+    }
+
+    if (mFormat == Format::Y4M)
+    {
+        /* Frame rate as a ratio, 29.97 is 29970:1000. */
+        const bool whole = std::fabs(fps - std::round(fps)) < 1e-3f;
+        mFile << "YUV4MPEG2 W" << width << " H" << height << " F" << (whole ? static_cast<long>(std::lround(fps)) : std::lround(fps * 1000.0f))
+              << ":" << (whole ? 1 : 1000) << " Ip A1:1 C420jpeg XCOLORRANGE=FULL\n";
+    }
+
+    mStopping  = false;
+    mRecording = true;
+    mEncoder   = std::thread(&FrameRecorder::EncoderLoop, this);
+    return true;
+}
+
+void FrameRecorder::Stop()
+{
+    if (!mRecording)
+        return;
+
+    /* Everything read back goes into the queue first, the encoder drains it before it stops. */
+    mReadback.Flush();
+    mStopping = true;
+    mEncoder.join();
+    mRecording = false;
+
+    if (mFile.is_open())
+        mFile.close();
+}
+
+void FrameRecorder::Capture(unsigned int framebuffer)
+{
+    PROFILE_FUNCTION();
+
+    if (!mRecording)
+        return;
+
+    /* Every read still in flight on the GPU, wait for the oldest rather than drop the frame. */
+    while (!mReadback.Read(framebuffer, mWidth, mHeight, 3, mCaptured, [this](PixelReadback::Image& image) { Push(image); }))
+    {
+        mReadback.Update();
+        std::this_thread::yield();
+    }
+
+    mCaptured++;
+}
+
+void FrameRecorder::Update()
+{
+    if (mRecording)
+        mReadback.Update();
+}
+
+void FrameRecorder::Push(PixelReadback::Image& image)
+{
+    if (mQueue.TryPush(image))
+        return;
+
+    PROFILE_SCOPE("FrameRecorder::Backpressure");
+
+    const auto start = std::chrono::steady_clock::now();
+    while (!mQueue.TryPush(image))
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    mBackpressureTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void FrameRecorder::EncoderLoop()
+{
+    PixelReadback::Image image;
+
+    for (;;)
+    {
+        /* Read before the pop: once stopping, everything pushed is already visible. */
+        const bool stopping = mStopping.load(std::memory_order_acquire);
+        if (!mQueue.TryPop(image))
+        {
+            if (stopping)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        Encode(image);
+        mEncodeNanoseconds += static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        mEncoded++;
+    }
+}
+
+void FrameRecorder::Encode(const PixelReadback::Image& image)
+{
+    PROFILE_FUNCTION();
+
+    switch (mFormat)
+    {
+        case Format::PNG:
+        {
+            char suffix[16];
+            std::snprintf(suffix, sizeof(suffix), "_%05llu.png", image.frame);
+            const std::string path = (EndsWith(mPath, ".png") ? mPath.substr(0, mPath.size() - 4) : mPath) + suffix;
+            if (!ImageWriter::WritePNG(path, image.pixels.data(), image.width, image.height, image.channels))
+                std::cout << "Failed to write " << path << std::endl;
+            break;
+        }
+        case Format::Y4M:
+            WriteY4MFrame(image);
+            break;
+        case Format::Raw:
+            mFile.write(reinterpret_cast<const char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size()));
+            break;
+    }
+}
+
+void FrameRecorder::WriteY4MFrame(const PixelReadback::Image& image)
+{
+    const int width = image.width, height = image.height, channels = image.channels;
+    const int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    const size_t lumaSize = static_cast<size_t>(width) * height, chromaSize = static_cast<size_t>(chromaWidth) * chromaHeight;
+
+    mPlanes.resize(lumaSize + 2 * chromaSize);
+    unsigned char* luma = mPlanes.data();
+    unsigned char* cb   = luma + lumaSize;
+    unsigned char* cr   = cb + chromaSize;
+
+    const unsigned char* pixels = image.pixels.data();
+    for (size_t index = 0; index < lumaSize; index++)
+    {
+        const unsigned char* rgb = pixels + index * channels;
+        luma[index] = ToByte(0.299f * rgb[0] + 0.587f * rgb[1] + 0.114f * rgb[2]);
+    }
+
+    /* Chroma of the 2x2 average, odd edges repeat the last row or column. */
+    for (int y = 0; y < chromaHeight; y++)
+    {
+        const int y0 = 2 * y, y1 = std::min(2 * y + 1, height - 1);
+        for (int x = 0; x < chromaWidth; x++)
+        {
+            const int x0 = 2 * x, x1 = std::min(2 * x + 1, width - 1);
+            float r = 0.0f, g = 0.0f, b = 0.0f;
+            for (const int row: {y0, y1})
+                for (const int column: {x0, x1})
+                {
+                    const unsigned char* rgb = pixels + (static_cast<size_t>(row) * width + column) * channels;
+                    r += rgb[0]; g += rgb[1]; b += rgb[2];
+                }
+            r *= 0.25f; g *= 0.25f; b *= 0.25f;
+
+            cb[y * chromaWidth + x] = ToByte(128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b);
+            cr[y * chromaWidth + x] = ToByte(128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b);
+        }
+    }
+
+    mFile << "FRAME\n";
+    mFile.write(reinterpret_cast<const char*>(mPlanes.data()), static_cast<std::streamsize>(mPlanes.size()));
+}
+
+double FrameRecorder::GetAverageEncodeTime() const
+{
+    const unsigned long long encoded = mEncoded.load(std::memory_order_relaxed);
+    return encoded ? mEncodeNanoseconds.load(std::memory_order_relaxed) / 1e6 / encoded : 0.0;
+}
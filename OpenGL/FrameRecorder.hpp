@@ -0,0 +1,95 @@
+//
+//  FrameRecorder.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef FrameRecorder_hpp
+#define FrameRecorder_hpp
+
+#include "PixelReadback.hpp"
+#include "SPSCQueue.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+
+/*
+ * Records frames to a PNG sequence, a Y4M video or raw RGB at a fixed frame rate, whatever the wall clock does:
+ * animate with GetTime() while recording. Frames are read back asynchronously and go through a bounded lock-free
+ * queue to an encoder thread. Nothing is dropped, when the encoder falls behind Capture waits for it (backpressure).
+ */
+class FrameRecorder
+{
+public:
+    enum class Format
+    {
+        PNG,        /* <name>_00000.png, <name>_00001.png ... */
+        Y4M,        /* 4:2:0, full range BT.601, plays in ffplay and mpv. */
+        Raw         /* rgb24 frames back to back, ffmpeg -f rawvideo -pix_fmt rgb24 -s WxH -r fps. */
+    };
+
+    static constexpr size_t kQueueSize = 8;
+
+    /* From the extension: .y4m, .raw, anything else is a PNG sequence. */
+    static Format GetFormat(const std::string& path);
+
+    FrameRecorder() = default;
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    /* Every frame must be width by height. False when the file can't be opened. */
+    bool Start(const std::string& path, int width, int height, float fps);
+    /* Waits for what is in flight, encoded and written when it returns. */
+    void Stop();
+    bool IsRecording() const { return mRecording; }
+
+    /* Reads back colour attachment 0 of the framebuffer (0 for the window) as the next frame. */
+    void Capture(unsigned int framebuffer);
+    /* Once a frame, hands finished reads to the encoder. */
+    void Update();
+
+    /* Seconds into the recording of the next frame, frames / fps. */
+    double GetTime() const { return mFps > 0.0f ? mCaptured / static_cast<double>(mFps) : 0.0; }
+    const std::string& GetPath() const { return mPath; }
+    Format GetFormat() const { return mFormat; }
+    int GetWidth() const { return mWidth; }
+    int GetHeight() const { return mHeight; }
+
+    unsigned long long GetCapturedCount() const { return mCaptured; }
+    unsigned long long GetEncodedCount() const { return mEncoded.load(std::memory_order_relaxed); }
+    size_t GetQueueDepth() const { return mQueue.GetSize(); }
+    /* Milliseconds: encoding and writing a frame, on average, and the time spent waiting for room in the queue. */
+    double GetAverageEncodeTime() const;
+    double GetBackpressureTime() const { return mBackpressureTime; }
+
+private:
+    void Push(PixelReadback::Image& image);
+    void EncoderLoop();
+    void Encode(const PixelReadback::Image& image);
+    void WriteY4MFrame(const PixelReadback::Image& image);
+
+    PixelReadback                     mReadback;        /* Delivers in order on this thread. */
+    SPSCQueue<PixelReadback::Image>   mQueue{kQueueSize};
+    std::thread                       mEncoder;
+    std::atomic<bool>                 mStopping{false};
+    bool                              mRecording = false;
+    std::string                       mPath;
+    Format                            mFormat = Format::PNG;
+    std::ofstream                     mFile;            /* Y4M and raw, encoder thread only while recording. */
+    int                               mWidth = 0;
+    int                               mHeight = 0;
+    float                             mFps = 0.0f;
+    unsigned long long                mCaptured = 0;
+    std::atomic<unsigned long long>   mEncoded{0};
+    std::atomic<unsigned long long>   mEncodeNanoseconds{0};
+    double                            mBackpressureTime = 0.0;
+    std::vector<unsigned char>        mPlanes;          /* Y4M frame being written. */
+};
+
+#endif /* FrameRecorder_hpp */
@@ -9,41 +9,82 @@
 #include "Framebuffer.hpp"
 #include "ErrorHandler.hpp"
 
-Framebuffer::Framebuffer()
+Framebuffer::Framebuffer(FramebufferPool& pool, int width, int height, unsigned int colorFormat, int samples):
+    mPool(pool), mWidth(width), mHeight(height), mColorFormat(colorFormat), mSamples(samples)
 {
-    GLCall(glGenFramebuffers(1, &mFramebufferID));
-    GLCall(glGenRenderbuffers(1, &mRenderbufferID));
+    Acquire();
 }
 
 Framebuffer::~Framebuffer()
 {
-    GLCall(glDeleteBuffers(1, &mFramebufferID));
-    GLCall(glDeleteBuffers(1, &mRenderbufferID));
+    Release();
 }
 
-void Framebuffer::Bind(const Texture& texture)
+void Framebuffer::Acquire()
 {
-    GLCall(glGetIntegerv(GL_VIEWPORT, mViewPort));
-    
-    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, mFramebufferID));
-    GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.GetTextureID(), 0));
+    mColor = mPool.Acquire({mWidth, mHeight, mColorFormat, mSamples});
+    mDepth = mPool.Acquire({mWidth, mHeight, GL_DEPTH24_STENCIL8, mSamples});
+    mFramebufferID = mPool.GetFramebuffer({mColor}, mDepth);
+
+    if (mSamples > 1)
+    {
+        mResolve = mPool.Acquire({mWidth, mHeight, mColorFormat, 1});
+        mResolveFramebufferID = mPool.GetFramebuffer({mResolve}, FramebufferPool::kNone);
+    }
+}
+
+void Framebuffer::Release()
+{
+    mPool.Release(mColor);
+    mPool.Release(mDepth);
+    mPool.Release(mResolve);
+    mColor = mDepth = mResolve = FramebufferPool::kNone;
+    mFramebufferID = mResolveFramebufferID = 0;
+}
 
-    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, mRenderbufferID));
-    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, texture.GetWidth(), texture.GetHeight()));
-    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, mRenderbufferID));
+void Framebuffer::Resize(int width, int height)
+{
+    if (width == mWidth && height == mHeight)
+        return;
+
+    Release();
+    mWidth  = width;
+    mHeight = height;
+    Acquire();
+}
 
-    ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+void Framebuffer::Bind()
+{
+    GLCall(glGetIntegerv(GL_VIEWPORT, mViewPort));
 
-    GLCall(glViewport(0, 0, texture.GetWidth(), texture.GetHeight()));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, mFramebufferID));
+    GLCall(glViewport(0, 0, mWidth, mHeight));
     GLCall(glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
-    GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
     GLCall(glEnable(GL_DEPTH_TEST));
 }
 
 void Framebuffer::Unbind()
 {
-    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+    if (mSamples > 1)
+    {
+        GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, mFramebufferID));
+        GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mResolveFramebufferID));
+        GLCall(glBlitFramebuffer(0, 0, mWidth, mHeight, 0, 0, mWidth, mHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+    }
+
     GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
     GLCall(glClear(GL_COLOR_BUFFER_BIT));
     GLCall(glViewport(mViewPort[0], mViewPort[1], mViewPort[2], mViewPort[3]));
 }
+
+bool Framebuffer::ReadPixels(PixelReadback& readback, unsigned long long frame, const PixelReadback::Callback& callback) const
+{
+    const int channels = mColorFormat == GL_RGBA8 ? 4 : 3;
+    return readback.Read(mSamples > 1 ? mResolveFramebufferID : mFramebufferID, mWidth, mHeight, channels, frame, callback);
+}
+
+unsigned int Framebuffer::GetColorTexture() const
+{
+    return mPool.GetAttachment(mSamples > 1 ? mResolve : mColor).name;
+}
@@ -9,22 +9,50 @@
 #ifndef Framebuffer_hpp
 #define Framebuffer_hpp
 
-#include <vector>
-#include "Texture.hpp"
+#include "FramebufferPool.hpp"
+#include "PixelReadback.hpp"
 
-/* ToDo: support bufferwidth height changing functionality */
+/*
+ * Offscreen colour and depth stencil target, attachments from a FramebufferPool. Multisampled targets resolve into
+ * a single sampled colour texture on Unbind.
+ */
 class Framebuffer
 {
 public:
-    Framebuffer();
+    Framebuffer(FramebufferPool& pool, int width, int height, unsigned int colorFormat = GL_RGB8, int samples = 1);
     ~Framebuffer();
 
-    void Bind(const Texture& texture);
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    /* Only a changed size swaps the attachments, same sized ones come back from the pool. */
+    void Resize(int width, int height);
+
+    /* Clears the target and makes it the viewport. Unbind restores the previous viewport. */
+    void Bind();
     void Unbind();
+
+    /* What was drawn, single sampled. */
+    unsigned int GetColorTexture() const;
+    /* Queues a read of what was drawn, the callback gets it some frames later. False when the ring is full. */
+    bool ReadPixels(PixelReadback& readback, unsigned long long frame, const PixelReadback::Callback& callback) const;
+    int GetWidth() const { return mWidth; }
+    int GetHeight() const { return mHeight; }
+
 private:
-    
+    void Acquire();
+    void Release();
+
+    FramebufferPool& mPool;
+    int          mWidth;
+    int          mHeight;
+    unsigned int mColorFormat;
+    int          mSamples;
+    size_t       mColor   = FramebufferPool::kNone;
+    size_t       mDepth   = FramebufferPool::kNone;
+    size_t       mResolve = FramebufferPool::kNone;
     unsigned int mFramebufferID{};
-    unsigned int mRenderbufferID{};
+    unsigned int mResolveFramebufferID{};
     int          mViewPort[4]{};
 };
 
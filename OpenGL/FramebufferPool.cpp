@@ -0,0 +1,248 @@
+//
+//  FramebufferPool.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "FramebufferPool.hpp"
+#include "ErrorHandler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    /* Format, type and bytes per texel of an internal format, for allocating a texture of it without data. */
+    struct PixelFormat
+    {
+        unsigned int format;
+        unsigned int type;
+        size_t       bytes;
+    };
+
+    PixelFormat GetPixelFormat(unsigned int internalFormat)
+    {
+        switch (internalFormat)
+        {
+            case GL_R8:                 return {GL_RED,           GL_UNSIGNED_BYTE,              1};
+            case GL_RG8:                return {GL_RG,            GL_UNSIGNED_BYTE,              2};
+            case GL_RGB8:               return {GL_RGB,           GL_UNSIGNED_BYTE,              3};
+            case GL_RGBA8:              return {GL_RGBA,          GL_UNSIGNED_BYTE,              4};
+            case GL_R16F:               return {GL_RED,           GL_HALF_FLOAT,                 2};
+            case GL_RG16F:              return {GL_RG,            GL_HALF_FLOAT,                 4};
+            case GL_RGBA16F:            return {GL_RGBA,          GL_HALF_FLOAT,                 8};
+            case GL_R32F:               return {GL_RED,           GL_FLOAT,                      4};
+            case GL_RGBA32F:            return {GL_RGBA,          GL_FLOAT,                      16};
+            case GL_R11F_G11F_B10F:     return {GL_RGB,           GL_FLOAT,                      4};
+            case GL_DEPTH_COMPONENT24:  return {GL_DEPTH_COMPONENT, GL_UNSIGNED_INT,              4};
+            case GL_DEPTH_COMPONENT32F: return {GL_DEPTH_COMPONENT, GL_FLOAT,                    4};
+            case GL_DEPTH24_STENCIL8:   return {GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8,          4};
+            case GL_DEPTH32F_STENCIL8:  return {GL_DEPTH_STENCIL, GL_FLOAT_32_UNSIGNED_INT_24_8_REV, 8};
+            default:
+                throw std::runtime_error("Unsupported render target format " + std::to_string(internalFormat));
+        }
+    }
+}
+
+FramebufferPool::~FramebufferPool()
+{
+    for (size_t index = 0; index < mAttachments.size(); index++)
+        if (mAttachments[index].name)
+            Free(index);
+}
+
+bool FramebufferPool::IsDepthFormat(unsigned int internalFormat)
+{
+    return GetPixelFormat(internalFormat).format == GL_DEPTH_COMPONENT || HasStencil(internalFormat);
+}
+
+bool FramebufferPool::HasStencil(unsigned int internalFormat)
+{
+    return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+
+size_t FramebufferPool::GetByteSize(const Format& format)
+{
+    return static_cast<size_t>(format.width) * format.height * std::max(1, format.samples) * GetPixelFormat(format.internalFormat).bytes;
+}
+
+size_t FramebufferPool::Acquire(const Format& format)
+{
+    size_t freeSlot = kNone;
+    for (size_t index = 0; index < mAttachments.size(); index++)
+    {
+        Attachment& attachment = mAttachments[index];
+        if (!attachment.name)
+        {
+            freeSlot = std::min(freeSlot, index);
+            continue;
+        }
+
+        if (!attachment.inUse && attachment.format == format)
+        {
+            attachment.inUse    = true;
+            attachment.lastUsed = mFrame;
+            mReuses++;
+            return index;
+        }
+    }
+
+    if (freeSlot == kNone)
+    {
+        freeSlot = mAttachments.size();
+        mAttachments.emplace_back();
+    }
+
+    Attachment& attachment = mAttachments[freeSlot];
+    attachment.format       = format;
+    attachment.renderbuffer = format.samples > 1;
+    attachment.inUse        = true;
+    attachment.lastUsed     = mFrame;
+    attachment.bytes        = GetByteSize(format);
+
+    if (attachment.renderbuffer)
+    {
+        GLCall(glGenRenderbuffers(1, &attachment.name));
+        GLCall(glBindRenderbuffer(GL_RENDERBUFFER, attachment.name));
+        GLCall(glRenderbufferStorageMultisample(GL_RENDERBUFFER, format.samples, format.internalFormat, format.width, format.height));
+        GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+    }
+    else
+    {
+        const PixelFormat pixelFormat = GetPixelFormat(format.internalFormat);
+        GLCall(glGenTextures(1, &attachment.name));
+        GLCall(glBindTexture(GL_TEXTURE_2D, attachment.name));
+        GLCall(glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, format.width, format.height, 0, pixelFormat.format, pixelFormat.type, nullptr));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    }
+
+    attachment.resource = GLResources::Register(attachment.renderbuffer ? GLResources::Type::Renderbuffer : GLResources::Type::Texture, attachment.name,
+                                                attachment.bytes, "pooled " + std::to_string(format.width) + "x" + std::to_string(format.height),
+                                                GL_RESOURCE_SITE);
+    mAllocations++;
+    return freeSlot;
+}
+
+void FramebufferPool::Release(size_t attachment)
+{
+    if (attachment == kNone)
+        return;
+
+    mAttachments[attachment].inUse    = false;
+    mAttachments[attachment].lastUsed = mFrame;
+}
+
+unsigned int FramebufferPool::GetFramebuffer(const std::vector<size_t>& colors, size_t depth)
+{
+    std::vector<size_t> attachments(colors);
+    attachments.push_back(depth);
+
+    for (const auto& framebuffer: mFramebuffers)
+        if (framebuffer.attachments == attachments)
+            return framebuffer.name;
+
+    Framebuffer framebuffer;
+    framebuffer.attachments = attachments;
+
+    int previousFramebuffer = 0;
+    GLCall(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer));
+    GLCall(glGenFramebuffers(1, &framebuffer.name));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, framebuffer.name));
+
+    auto attach = [this](unsigned int point, size_t index) {
+        const Attachment& attachment = mAttachments[index];
+        if (attachment.renderbuffer)
+        {
+            GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, point, GL_RENDERBUFFER, attachment.name));
+        }
+        else
+        {
+            GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, point, GL_TEXTURE_2D, attachment.name, 0));
+        }
+    };
+
+    std::vector<GLenum> drawBuffers;
+    for (size_t index = 0; index < colors.size(); index++)
+    {
+        attach(static_cast<unsigned int>(GL_COLOR_ATTACHMENT0 + index), colors[index]);
+        drawBuffers.push_back(static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + index));
+    }
+    if (depth != kNone)
+        attach(HasStencil(mAttachments[depth].format.internalFormat) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, depth);
+
+    /* Depth only targets draw no colour. */
+    if (drawBuffers.empty())
+    {
+        GLCall(glDrawBuffer(GL_NONE));
+        GLCall(glReadBuffer(GL_NONE));
+    }
+    else
+    {
+        GLCall(glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data()));
+    }
+
+    ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer));
+
+    framebuffer.resource = GLResources::Register(GLResources::Type::Framebuffer, framebuffer.name, 0, "pooled", GL_RESOURCE_SITE);
+    mFramebuffers.push_back(framebuffer);
+    return framebuffer.name;
+}
+
+void FramebufferPool::BeginFrame()
+{
+    mFrame++;
+
+    for (size_t index = 0; index < mAttachments.size(); index++)
+    {
+        const Attachment& attachment = mAttachments[index];
+        if (attachment.name && !attachment.inUse && attachment.lastUsed + kIdleFrames < mFrame)
+            Free(index);
+    }
+}
+
+void FramebufferPool::Free(size_t attachment)
+{
+    /* Framebuffers made with it go too, the slot may be handed out again. Partition keeps them intact at the end. */
+    auto stale = std::stable_partition(mFramebuffers.begin(), mFramebuffers.end(), [attachment](const Framebuffer& framebuffer) {
+        return std::find(framebuffer.attachments.begin(), framebuffer.attachments.end(), attachment) == framebuffer.attachments.end();
+    });
+    for (auto framebuffer = stale; framebuffer != mFramebuffers.end(); ++framebuffer)
+    {
+        GLCall(glDeleteFramebuffers(1, &framebuffer->name));
+        GLResources::Release(framebuffer->resource);
+    }
+    mFramebuffers.erase(stale, mFramebuffers.end());
+
+    Attachment& freed = mAttachments[attachment];
+    if (freed.renderbuffer)
+    {
+        GLCall(glDeleteRenderbuffers(1, &freed.name));
+    }
+    else
+    {
+        GLCall(glDeleteTextures(1, &freed.name));
+    }
+    GLResources::Release(freed.resource);
+    freed = Attachment{};
+}
+
+size_t FramebufferPool::GetAttachmentCount() const
+{
+    return std::count_if(mAttachments.begin(), mAttachments.end(), [](const Attachment& attachment) { return attachment.name != 0; });
+}
+
+size_t FramebufferPool::GetByteSize() const
+{
+    size_t bytes = 0;
+    for (const auto& attachment: mAttachments)
+        bytes += attachment.bytes;
+    return bytes;
+}
@@ -0,0 +1,101 @@
+//
+//  FramebufferPool.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef FramebufferPool_hpp
+#define FramebufferPool_hpp
+
+#include "GL/glew.h"
+#include "GLResources.hpp"
+
+#include <vector>
+
+/*
+ * Render target attachments keyed by size, internal format and sample count, and the framebuffer objects built from
+ * them. Storage is allocated once per attachment: a released attachment goes back to the pool and is handed out
+ * again to the next request of the same key, in this frame or a later one. Attachments nobody asked for in
+ * kIdleFrames are deleted, so after a resize only the targets whose size changed are reallocated and the old sizes
+ * drain away.
+ *
+ * Single sampled attachments are textures and can be sampled, multisampled ones are renderbuffers.
+ */
+class FramebufferPool
+{
+public:
+    static constexpr size_t             kNone       = static_cast<size_t>(-1);
+    static constexpr unsigned long long kIdleFrames = 60;
+
+    struct Format
+    {
+        int          width          = 0;
+        int          height         = 0;
+        unsigned int internalFormat = GL_RGBA8;
+        int          samples        = 1;
+
+        bool operator==(const Format& other) const
+        {
+            return width == other.width && height == other.height && internalFormat == other.internalFormat && samples == other.samples;
+        }
+    };
+
+    struct Attachment
+    {
+        Format              format;
+        unsigned int        name = 0;               /* 0 for a free slot. */
+        bool                renderbuffer = false;
+        bool                inUse = false;
+        unsigned long long  lastUsed = 0;           /* Frame of the last acquire or release. */
+        size_t              bytes = 0;
+        GLResources::Handle resource = 0;
+    };
+
+    FramebufferPool() = default;
+    ~FramebufferPool();
+
+    FramebufferPool(const FramebufferPool&) = delete;
+    FramebufferPool& operator=(const FramebufferPool&) = delete;
+
+    /* Index of a free attachment of the format, allocated when there is none. Held until released. */
+    size_t Acquire(const Format& format);
+    void   Release(size_t attachment);
+    const Attachment& GetAttachment(size_t attachment) const { return mAttachments[attachment]; }
+
+    /* Framebuffer with the colour attachments in order and the depth one (kNone for none), made on first use. */
+    unsigned int GetFramebuffer(const std::vector<size_t>& colors, size_t depth);
+
+    /* Deletes attachments idle for kIdleFrames, with their framebuffers. */
+    void BeginFrame();
+
+    static bool IsDepthFormat(unsigned int internalFormat);
+    static bool HasStencil(unsigned int internalFormat);
+    static size_t GetByteSize(const Format& format);
+
+    unsigned long long GetFrame() const { return mFrame; }
+    /* Attachments allocated in total, and requests served by one already allocated. */
+    size_t GetAllocations() const { return mAllocations; }
+    size_t GetReuses() const { return mReuses; }
+    size_t GetAttachmentCount() const;
+    size_t GetByteSize() const;
+
+private:
+    struct Framebuffer
+    {
+        std::vector<size_t> attachments;            /* Colours, then depth or kNone. */
+        unsigned int        name = 0;
+        GLResources::Handle resource = 0;
+    };
+
+    void Free(size_t attachment);
+
+    std::vector<Attachment>  mAttachments;
+    std::vector<Framebuffer> mFramebuffers;
+    unsigned long long       mFrame = 1;
+    size_t                   mAllocations = 0;
+    size_t                   mReuses = 0;
+};
+
+#endif /* FramebufferPool_hpp */
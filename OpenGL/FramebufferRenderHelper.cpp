@@ -7,10 +7,11 @@
 //
 
 #include "FramebufferRenderHelper.hpp"
+#include "ErrorHandler.hpp"
 
 namespace Helper
 {
-    FramebufferRenderer::FramebufferRenderer(int ScreenWidth, int ScreenHeight): mFramebufferTexture(ScreenWidth, ScreenHeight, 3)
+    FramebufferRenderer::FramebufferRenderer(FramebufferPool& pool, int ScreenWidth, int ScreenHeight, int samples): mFramebuffer(pool, ScreenWidth, ScreenHeight, GL_RGB8, samples)
     {
         InitBuffers();
         mQuadVA.CreateVBuffer2f(mScreenVertices);
@@ -25,7 +26,8 @@ namespace Helper
     
     void FramebufferRenderer::Draw(const Renderer& renderer, const Shader& shader) const
     {
-        mFramebufferTexture.Bind();
+        GLCall(glActiveTexture(GL_TEXTURE0));
+        GLCall(glBindTexture(GL_TEXTURE_2D, mFramebuffer.GetColorTexture()));
         renderer.DisableDepth(); // disable depth test so screen-space quad isn't discarded due to depth test.
         renderer.Draw(mQuadVA, shader);
         renderer.EnableDepth(GL_LESS);
@@ -74,11 +76,16 @@ namespace Helper
     
     void FramebufferRenderer::Bind()
     {
-        mFramebuffer.Bind(mFramebufferTexture);
+        mFramebuffer.Bind();
     }
     
     void FramebufferRenderer::Unbind()
     {
         mFramebuffer.Unbind();
     }
+
+    void FramebufferRenderer::Resize(int ScreenWidth, int ScreenHeight)
+    {
+        mFramebuffer.Resize(ScreenWidth, ScreenHeight);
+    }
 }
@@ -13,25 +13,25 @@
 #include "VertexArray.hpp"
 #include "Renderer.hpp"
 #include "Framebuffer.hpp"
-#include "Texture.hpp"
 
 namespace Helper
 {
     class FramebufferRenderer
     {
     public:
-        FramebufferRenderer(int ScreenWidth, int ScreenHeight);
+        FramebufferRenderer(FramebufferPool& pool, int ScreenWidth, int ScreenHeight, int samples = 1);
         ~FramebufferRenderer();
         void Draw(const Renderer& renderer, const Shader& shader) const;
         void Bind();
         void Unbind();
+        /* Call with the window's framebuffer size, nothing is reallocated while it stays the same. */
+        void Resize(int ScreenWidth, int ScreenHeight);
     private:
         void InitBuffers();
         std::vector<float> mScreenVertices;
         std::vector<float> mTexCoords;
         std::vector<unsigned int> mIndices;
         Framebuffer mFramebuffer;
-        Texture     mFramebufferTexture;
         VertexArray mQuadVA;
     };
 }
@@ -0,0 +1,218 @@
+//
+//  Frustum.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "Frustum.hpp"
+
+#if defined(__AVX__) || defined(__SSE2__)
+    #include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
+namespace Culling
+{
+    Frustum Frustum::FromMatrix(const glm::mat4& viewProj)
+    {
+        /* glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i]). */
+        auto row = [&viewProj](int index) {
+            return glm::vec4(viewProj[0][index], viewProj[1][index], viewProj[2][index], viewProj[3][index]);
+        };
+
+        Frustum frustum;
+        frustum.planes[0] = row(3) + row(0);
+        frustum.planes[1] = row(3) - row(0);
+        frustum.planes[2] = row(3) + row(1);
+        frustum.planes[3] = row(3) - row(1);
+        frustum.planes[4] = row(3) + row(2);
+        frustum.planes[5] = row(3) - row(2);
+
+        for (auto& plane: frustum.planes)
+            plane /= glm::length(glm::vec3(plane));
+
+        return frustum;
+    }
+
+    Frustum::Containment Frustum::Test(const CommonUtils::BBCoord& box) const
+    {
+        Containment result = Containment::Inside;
+
+        /* Same arithmetic as the batched kernels, so both agree on boxes touching a plane. */
+        auto distance = [](const glm::vec4& plane, float x, float y, float z) {
+            return plane.w + plane.x * x + plane.y * y + plane.z * z;
+        };
+
+        for (const auto& plane: planes)
+        {
+            const bool px = plane.x >= 0.0f, py = plane.y >= 0.0f, pz = plane.z >= 0.0f;
+
+            if (distance(plane, px ? box.Max.x : box.Min.x, py ? box.Max.y : box.Min.y, pz ? box.Max.z : box.Min.z) < 0.0f)
+                return Containment::Outside;
+
+            if (distance(plane, px ? box.Min.x : box.Max.x, py ? box.Min.y : box.Max.y, pz ? box.Min.z : box.Max.z) < 0.0f)
+                result = Containment::Intersecting;
+        }
+
+        return result;
+    }
+
+    void AABBList::Clear()
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            mMin[axis].clear();
+            mMax[axis].clear();
+        }
+
+        mSize = 0;
+    }
+
+    void AABBList::Reserve(size_t count)
+    {
+        const size_t padded = (count + kLanes - 1) / kLanes * kLanes;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            mMin[axis].reserve(padded);
+            mMax[axis].reserve(padded);
+        }
+    }
+
+    size_t AABBList::Add(const CommonUtils::BBCoord& box)
+    {
+        if (mSize == mMin[0].size())
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                mMin[axis].resize(mSize + kLanes, 0.0f);
+                mMax[axis].resize(mSize + kLanes, 0.0f);
+            }
+        }
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            mMin[axis][mSize] = box.Min[axis];
+            mMax[axis][mSize] = box.Max[axis];
+        }
+
+        return mSize++;
+    }
+
+    namespace
+    {
+        /* Per plane, the corner furthest along the normal is max on positive axes and min on negative ones. */
+        struct PlaneCorners
+        {
+            const float* axis[3];
+        };
+
+        PlaneCorners GetPositiveCorner(const glm::vec4& plane, const AABBList& boxes)
+        {
+            PlaneCorners corners;
+            for (int axis = 0; axis < 3; axis++)
+                corners.axis[axis] = plane[axis] >= 0.0f ? boxes.Max(axis) : boxes.Min(axis);
+
+            return corners;
+        }
+
+        size_t CountVisible(const std::vector<unsigned char>& visible, size_t count)
+        {
+            size_t visibleCount = 0;
+            for (size_t index = 0; index < count; index++)
+                visibleCount += visible[index];
+
+            return visibleCount;
+        }
+    }
+
+    size_t CullAABBsScalar(const Frustum& frustum, const AABBList& boxes, std::vector<unsigned char>& visible)
+    {
+        visible.assign(boxes.Size(), 1);
+
+        for (const auto& plane: frustum.planes)
+        {
+            const PlaneCorners corner = GetPositiveCorner(plane, boxes);
+
+            for (size_t index = 0; index < boxes.Size(); index++)
+            {
+                const float distance = plane.w + plane.x * corner.axis[0][index] + plane.y * corner.axis[1][index] + plane.z * corner.axis[2][index];
+                visible[index] &= distance >= 0.0f;
+            }
+        }
+
+        return CountVisible(visible, boxes.Size());
+    }
+
+    size_t CullAABBs(const Frustum& frustum, const AABBList& boxes, std::vector<unsigned char>& visible)
+    {
+#if defined(__AVX__) || defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+        const size_t padded = (boxes.Size() + AABBList::kLanes - 1) / AABBList::kLanes * AABBList::kLanes;
+        visible.resize(padded);
+
+        PlaneCorners corners[6];
+        for (int plane = 0; plane < 6; plane++)
+            corners[plane] = GetPositiveCorner(frustum.planes[plane], boxes);
+
+    #if defined(__AVX__)
+        constexpr size_t kWidth = 8;
+    #else
+        constexpr size_t kWidth = 4;
+    #endif
+
+        for (size_t index = 0; index < padded; index += kWidth)
+        {
+    #if defined(__AVX__)
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int plane = 0; plane < 6; plane++)
+            {
+                const glm::vec4& p = frustum.planes[plane];
+                __m256 distance = _mm256_set1_ps(p.w);
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(p.x), _mm256_loadu_ps(corners[plane].axis[0] + index)));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(p.y), _mm256_loadu_ps(corners[plane].axis[1] + index)));
+                distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(p.z), _mm256_loadu_ps(corners[plane].axis[2] + index)));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+            const int mask = _mm256_movemask_ps(inside);
+    #elif defined(__SSE2__)
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int plane = 0; plane < 6; plane++)
+            {
+                const glm::vec4& p = frustum.planes[plane];
+                __m128 distance = _mm_set1_ps(p.w);
+                distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(p.x), _mm_loadu_ps(corners[plane].axis[0] + index)));
+                distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(p.y), _mm_loadu_ps(corners[plane].axis[1] + index)));
+                distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(p.z), _mm_loadu_ps(corners[plane].axis[2] + index)));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+            }
+            const int mask = _mm_movemask_ps(inside);
+    #else
+            /* Apple silicon, same unfused sums as SSE. */
+            uint32x4_t inside = vdupq_n_u32(~0u);
+            for (int plane = 0; plane < 6; plane++)
+            {
+                const glm::vec4& p = frustum.planes[plane];
+                float32x4_t distance = vdupq_n_f32(p.w);
+                distance = vmlaq_f32(distance, vdupq_n_f32(p.x), vld1q_f32(corners[plane].axis[0] + index));
+                distance = vmlaq_f32(distance, vdupq_n_f32(p.y), vld1q_f32(corners[plane].axis[1] + index));
+                distance = vmlaq_f32(distance, vdupq_n_f32(p.z), vld1q_f32(corners[plane].axis[2] + index));
+                inside = vandq_u32(inside, vcgeq_f32(distance, vdupq_n_f32(0.0f)));
+            }
+
+            /* One bit a lane, like movemask. */
+            const uint32x4_t bits = {1, 2, 4, 8};
+            const int mask = static_cast<int>(vaddvq_u32(vandq_u32(inside, bits)));
+    #endif
+            for (size_t lane = 0; lane < kWidth; lane++)
+                visible[index + lane] = (mask >> lane) & 1;
+        }
+
+        visible.resize(boxes.Size());
+        return CountVisible(visible, boxes.Size());
+#else
+        return CullAABBsScalar(frustum, boxes, visible);
+#endif
+    }
+}
@@ -0,0 +1,70 @@
+//
+//  Frustum.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef Frustum_hpp
+#define Frustum_hpp
+
+#include "CommonUtils.hpp"
+
+#include <vector>
+
+namespace Culling
+{
+    /* Six planes (left, right, bottom, top, near, far) as normal.xyz + distance. A point is inside when dot >= 0. */
+    struct Frustum
+    {
+        enum class Containment
+        {
+            Outside,
+            Intersecting,
+            Inside
+        };
+
+        glm::vec4 planes[6];
+
+        /* Gribb/Hartmann extraction, pass proj * view for world space planes. */
+        static Frustum FromMatrix(const glm::mat4& viewProj);
+
+        /* Single box test, for hierarchies where a fully inside node skips the tests of its children. */
+        Containment Test(const CommonUtils::BBCoord& box) const;
+    };
+
+    /*
+     * Boxes stored as structure of arrays, so the kernel tests 4 (SSE) or 8 (AVX) boxes per instruction.
+     * Arrays are padded to a multiple of kLanes, the kernels never need a scalar tail.
+     */
+    class AABBList
+    {
+    public:
+        static constexpr size_t kLanes = 8;
+
+        void   Clear();
+        void   Reserve(size_t count);
+        size_t Add(const CommonUtils::BBCoord& box);
+        size_t Size() const { return mSize; }
+
+        const float* Min(int axis) const { return mMin[axis].data(); }
+        const float* Max(int axis) const { return mMax[axis].data(); }
+
+    private:
+        std::vector<float> mMin[3];
+        std::vector<float> mMax[3];
+        size_t             mSize = 0;
+    };
+
+    /*
+     * Writes 1 to visible[i] when box i intersects (or might intersect) the frustum, returns the visible count.
+     * Boxes are tested against the "positive vertex" of every plane, conservative near the frustum corners.
+     */
+    size_t CullAABBs(const Frustum& frustum, const AABBList& boxes, std::vector<unsigned char>& visible);
+
+    /* Reference implementation, one box at a time. Same results as CullAABBs. */
+    size_t CullAABBsScalar(const Frustum& frustum, const AABBList& boxes, std::vector<unsigned char>& visible);
+}
+
+#endif /* Frustum_hpp */
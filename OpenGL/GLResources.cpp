@@ -0,0 +1,249 @@
+//
+//  GLResources.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "GLResources.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace GLResources
+{
+    namespace
+    {
+        constexpr size_t kTypeCount = static_cast<size_t>(Type::Count);
+
+        struct Registry
+        {
+            std::mutex                         mutex;
+            std::unordered_map<Handle, Record> records;
+            Handle                             nextHandle = 1;
+            Totals                             totals[kTypeCount];
+            Totals                             all;
+        };
+
+        Registry& GetRegistry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        thread_local std::string tOwner;
+
+        void Add(Totals& totals, std::int64_t count, std::int64_t bytes)
+        {
+            totals.count = static_cast<size_t>(static_cast<std::int64_t>(totals.count) + count);
+            totals.bytes = static_cast<size_t>(static_cast<std::int64_t>(totals.bytes) + bytes);
+            totals.peakCount = std::max(totals.peakCount, totals.count);
+            totals.peakBytes = std::max(totals.peakBytes, totals.bytes);
+        }
+
+        void WriteEscaped(std::ostream& stream, const std::string& text)
+        {
+            for (const char character: text)
+            {
+                if (character == '"' || character == '\\')
+                    stream << '\\';
+                stream << character;
+            }
+        }
+
+        void ReportAtExit()
+        {
+            ReportLeaks(std::cerr);
+        }
+    }
+
+    Handle Register(Type type, unsigned int name, size_t bytes, const std::string& label, const char* file, int line)
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        const Handle handle = registry.nextHandle++;
+        registry.records.emplace(handle, Record{type, name, bytes, label, tOwner, file, line});
+
+        Add(registry.totals[static_cast<size_t>(type)], 1, static_cast<std::int64_t>(bytes));
+        Add(registry.all, 1, static_cast<std::int64_t>(bytes));
+        return handle;
+    }
+
+    void SetByteSize(Handle handle, size_t bytes)
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        const auto found = registry.records.find(handle);
+        if (found == registry.records.end())
+            return;
+
+        const std::int64_t change = static_cast<std::int64_t>(bytes) - static_cast<std::int64_t>(found->second.bytes);
+        found->second.bytes = bytes;
+
+        Add(registry.totals[static_cast<size_t>(found->second.type)], 0, change);
+        Add(registry.all, 0, change);
+    }
+
+    void SetName(Handle handle, unsigned int name)
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        const auto found = registry.records.find(handle);
+        if (found != registry.records.end())
+            found->second.name = name;
+    }
+
+    void Release(Handle handle)
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        const auto found = registry.records.find(handle);
+        if (found == registry.records.end())
+            return;
+
+        Add(registry.totals[static_cast<size_t>(found->second.type)], -1, -static_cast<std::int64_t>(found->second.bytes));
+        Add(registry.all, -1, -static_cast<std::int64_t>(found->second.bytes));
+        registry.records.erase(found);
+    }
+
+    ScopedOwner::ScopedOwner(const std::string& owner): mPrevious(tOwner)
+    {
+        tOwner = owner;
+    }
+
+    ScopedOwner::~ScopedOwner()
+    {
+        tOwner = mPrevious;
+    }
+
+    const char* GetTypeName(Type type)
+    {
+        switch (type)
+        {
+            case Type::Buffer:       return "buffer";
+            case Type::VertexArray:  return "vertex_array";
+            case Type::Texture:      return "texture";
+            case Type::Renderbuffer: return "renderbuffer";
+            case Type::Framebuffer:  return "framebuffer";
+            case Type::Shader:       return "shader";
+            default:                 return "unknown";
+        }
+    }
+
+    Totals GetTotals(Type type)
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        return registry.totals[static_cast<size_t>(type)];
+    }
+
+    Totals GetTotals()
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        return registry.all;
+    }
+
+    std::vector<Record> GetLiveResources()
+    {
+        Registry& registry = GetRegistry();
+        std::vector<Record> records;
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            records.reserve(registry.records.size());
+            for (const auto& entry: registry.records)
+                records.push_back(entry.second);
+        }
+
+        /* Biggest first. */
+        std::sort(records.begin(), records.end(), [](const Record& first, const Record& second) { return first.bytes > second.bytes; });
+        return records;
+    }
+
+    void WriteJSON(std::ostream& stream, bool withObjects)
+    {
+        const Totals all = GetTotals();
+        stream << "{\"count\": " << all.count << ", \"bytes\": " << all.bytes << ", \"peak_count\": " << all.peakCount
+               << ", \"peak_bytes\": " << all.peakBytes << ", \"types\": {";
+
+        for (size_t index = 0; index < kTypeCount; index++)
+        {
+            const Totals totals = GetTotals(static_cast<Type>(index));
+            stream << (index ? ", " : "") << "\"" << GetTypeName(static_cast<Type>(index)) << "\": {\"count\": " << totals.count
+                   << ", \"bytes\": " << totals.bytes << ", \"peak_count\": " << totals.peakCount << ", \"peak_bytes\": " << totals.peakBytes << "}";
+        }
+        stream << "}";
+
+        if (withObjects)
+        {
+            stream << ", \"objects\": [";
+            const auto records = GetLiveResources();
+            for (size_t index = 0; index < records.size(); index++)
+            {
+                const Record& record = records[index];
+                stream << (index ? ",\n    " : "\n    ") << "{\"type\": \"" << GetTypeName(record.type) << "\", \"name\": " << record.name
+                       << ", \"bytes\": " << record.bytes << ", \"label\": \"";
+                WriteEscaped(stream, record.label);
+                stream << "\", \"owner\": \"";
+                WriteEscaped(stream, record.owner);
+                stream << "\", \"site\": \"";
+                WriteEscaped(stream, record.file);
+                stream << ":" << record.line << "\"}";
+            }
+            stream << "]";
+        }
+
+        stream << "}";
+    }
+
+    bool DumpJSON(const std::string& path)
+    {
+        std::ofstream file(path);
+        if (!file)
+            return false;
+
+        WriteJSON(file, true);
+        file << "\n";
+        return static_cast<bool>(file);
+    }
+
+    size_t ReportLeaks(std::ostream& stream)
+    {
+        const auto records = GetLiveResources();
+        if (records.empty())
+            return 0;
+
+        stream << records.size() << " GL objects leaked:" << std::endl;
+        for (const auto& record: records)
+        {
+            stream << "    " << GetTypeName(record.type) << " " << record.name << ", " << record.bytes << " bytes";
+            if (!record.label.empty())
+                stream << ", " << record.label;
+            if (!record.owner.empty())
+                stream << ", owned by " << record.owner;
+            stream << ", created at " << record.file << ":" << record.line << std::endl;
+        }
+
+        return records.size();
+    }
+
+    void EnableLeakReportAtExit()
+    {
+        /* Handlers run before the statics constructed ahead of them are destroyed, the registry outlives the report. */
+        GetRegistry();
+
+        static bool enabled = false;
+        if (!enabled)
+            std::atexit(ReportAtExit);
+        enabled = true;
+    }
+}
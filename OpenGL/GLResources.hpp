@@ -0,0 +1,97 @@
+//
+//  GLResources.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef GLResources_hpp
+#define GLResources_hpp
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* Where a GL object is created, for GLResources::Register. */
+#define GL_RESOURCE_SITE __FILE__, __LINE__
+
+/*
+ * Registry of the GL objects alive: every wrapper registers on creation and releases on destruction, with its type,
+ * GPU byte size (an estimate, what the texels or buffer data take), creation site and owner. Keeps per type totals
+ * and high-water marks, and reports whatever is still registered when the process exits as leaked.
+ */
+namespace GLResources
+{
+    enum class Type : unsigned int
+    {
+        Buffer = 0,
+        VertexArray,
+        Texture,
+        Renderbuffer,
+        Framebuffer,
+        Shader,
+        Count
+    };
+
+    /* 0 is no resource, Release and SetByteSize ignore it. */
+    using Handle = std::uint64_t;
+
+    /* label says which one it is (a file path, "shadow map", ...), the owner comes from the innermost ScopedOwner. */
+    Handle Register(Type type, unsigned int name, size_t bytes, const std::string& label, const char* file, int line);
+    void   SetByteSize(Handle handle, size_t bytes);
+    /* The wrapper took over another GL object of the same type, e.g. a streamed texture replacing its placeholder. */
+    void   SetName(Handle handle, unsigned int name);
+    void   Release(Handle handle);
+
+    /* Objects registered on this thread while one is alive are owned by it. Nests. */
+    class ScopedOwner
+    {
+    public:
+        explicit ScopedOwner(const std::string& owner);
+        ~ScopedOwner();
+
+        ScopedOwner(const ScopedOwner&) = delete;
+        ScopedOwner& operator=(const ScopedOwner&) = delete;
+
+    private:
+        std::string mPrevious;
+    };
+
+    struct Record
+    {
+        Type         type;
+        unsigned int name;
+        size_t       bytes;
+        std::string  label;
+        std::string  owner;
+        const char*  file;
+        int          line;
+    };
+
+    struct Totals
+    {
+        size_t count = 0;
+        size_t bytes = 0;
+        size_t peakCount = 0;
+        size_t peakBytes = 0;
+    };
+
+    const char* GetTypeName(Type type);
+    Totals GetTotals(Type type);
+    /* Over all types, peaks of the sum. */
+    Totals GetTotals();
+    std::vector<Record> GetLiveResources();
+
+    /* Totals, peaks and the live objects as one JSON object. */
+    void WriteJSON(std::ostream& stream, bool withObjects);
+    bool DumpJSON(const std::string& path);
+
+    /* Lists every object still alive, returns their count. */
+    size_t ReportLeaks(std::ostream& stream);
+    /* The report goes to stderr at exit, after main's objects are gone. */
+    void EnableLeakReportAtExit();
+}
+
+#endif /* GLResources_hpp */
@@ -13,13 +13,30 @@
 #include "IndexBuffer.hpp"
 #include "VertexArray.hpp"
 #include "Shader.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include <string>
+#include <thread>
 #include <vector>
 
 class GLFWInitWindow
 {
 public:
-    GLFWInitWindow(const int ScreenWidth, const int ScreenHeight, const std::string& WindowName): mScreenWidth(ScreenWidth), mScreenHeight(ScreenHeight), mWindowName(WindowName)
+    /* Adaptive syncs like VSync but swaps late frames right away, where the driver supports it. */
+    enum class PresentMode
+    {
+        Immediate,
+        VSync,
+        Adaptive
+    };
+
+    /* Input leaves ImGui a few frames to settle (hover, popups, key repeat). */
+    static constexpr int kInputRedrawFrames = 3;
+
+    /* Headless: invisible window, software context (OSMesa, or EGL with VIEWER_CONTEXT_API=egl) off macOS. Render into a Framebuffer. */
+    GLFWInitWindow(const int ScreenWidth, const int ScreenHeight, const std::string& WindowName, bool Headless = false): mScreenWidth(ScreenWidth), mScreenHeight(ScreenHeight), mWindowName(WindowName)
     {
         /* Initialize the library */
         if (!glfwInit())
@@ -30,6 +47,15 @@ public:
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
         glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
         
+        if (Headless)
+        {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifndef __APPLE__
+            const char* contextAPI = std::getenv("VIEWER_CONTEXT_API");
+            const bool  useEGL     = contextAPI && std::string(contextAPI) == "egl";
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, useEGL ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API);
+#endif
+        }
 
         /* Create a windowed mode window and its OpenGL context */
         mWindow = glfwCreateWindow(mScreenWidth, mScreenHeight, mWindowName.c_str(), NULL, NULL);
@@ -41,13 +67,26 @@ public:
         
         /* Make the window's context current */
         glfwMakeContextCurrent(mWindow);
-        glfwSwapInterval(1);
+        SetPresentMode(Headless ? PresentMode::Immediate : PresentMode::VSync);
+
+        /* Before ImGui installs its own, which call these in turn. */
+        glfwSetWindowUserPointer(mWindow, this);
+        glfwSetKeyCallback(mWindow, [](GLFWwindow* window, int, int, int, int) { OnInput(window); });
+        glfwSetCharCallback(mWindow, [](GLFWwindow* window, unsigned int) { OnInput(window); });
+        glfwSetMouseButtonCallback(mWindow, [](GLFWwindow* window, int, int, int) { OnInput(window); });
+        glfwSetCursorPosCallback(mWindow, [](GLFWwindow* window, double, double) { OnInput(window); });
+        glfwSetScrollCallback(mWindow, [](GLFWwindow* window, double, double) { OnInput(window); });
+        glfwSetFramebufferSizeCallback(mWindow, [](GLFWwindow* window, int, int) { OnInput(window); });
+        glfwSetWindowRefreshCallback(mWindow, [](GLFWwindow* window) { OnInput(window); });
+        glfwSetWindowFocusCallback(mWindow, [](GLFWwindow* window, int) { OnInput(window); });
         
+        glewExperimental = GL_TRUE;     /* Core profile contexts outside macOS need it for VAO entry points. */
         GLenum err = glewInit();
         if (GLEW_OK != err)
             std::cout << "Glew Not Okay" << std::endl;
 
         std::cout << "OpenGL Version: => " << glGetString(GL_VERSION) << std::endl;
+        std::cout << "OpenGL Renderer: => " << glGetString(GL_RENDERER) << std::endl;
     }
     
     
@@ -83,6 +122,16 @@ public:
         return std::make_pair(clamp(cursor.first), clamp(cursor.second));
     }
     
+    /* In pixels, differs from the window size on high DPI screens. */
+    std::pair<int, int> GetFramebufferSize()
+    {
+        int width;
+        int height;
+
+        glfwGetFramebufferSize(mWindow, &width, &height);
+        return std::make_pair(width, height);
+    }
+    
     void HideCursor()
     {
         glfwSetInputMode(mWindow, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
@@ -90,12 +139,75 @@ public:
     
     void SwapBuffersAndPollEvents()
     {
+        PROFILE_SCOPE("GLFWInitWindow::SwapBuffersAndPollEvents");
         /* Swap front and back buffers */
-        glfwSwapBuffers(mWindow);
+        SwapBuffers();
         
         /* Poll for and process events */
         glfwPollEvents();
     }
+
+    /* Waits out the frame rate cap, if any, then presents. */
+    void SwapBuffers()
+    {
+        PROFILE_SCOPE("GLFWInitWindow::SwapBuffers");
+
+        if (mFrameRateCap > 0.0)
+        {
+            const auto next = mLastSwap + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / mFrameRateCap));
+            std::this_thread::sleep_until(next);
+        }
+
+        glfwSwapBuffers(mWindow);
+        mLastSwap = std::chrono::steady_clock::now();
+    }
+
+    /*
+     * On demand rendering: sleeps in glfwWaitEventsTimeout until input or Invalidate asks for a frame, or timeout
+     * seconds pass. Returns whether a frame was asked for. Events are processed either way.
+     */
+    bool WaitForRedraw(double timeout)
+    {
+        PROFILE_SCOPE("GLFWInitWindow::WaitForRedraw");
+
+        const double deadline = glfwGetTime() + timeout;
+        glfwPollEvents();
+        while (mRedrawFrames == 0 && !ShouldCloseWindow())
+        {
+            const double remaining = deadline - glfwGetTime();
+            if (remaining <= 0.0)
+                break;
+            glfwWaitEventsTimeout(remaining);
+        }
+
+        if (mRedrawFrames == 0)
+            return false;
+
+        mRedrawFrames--;
+        return true;
+    }
+
+    /* Asks WaitForRedraw for the next `frames` frames. Main thread only. */
+    void Invalidate(int frames = 1)
+    {
+        mRedrawFrames = std::max(mRedrawFrames, frames);
+    }
+
+    /* Swap interval. Adaptive falls back to VSync without the swap tear extension. */
+    void SetPresentMode(PresentMode mode)
+    {
+        if (mode == PresentMode::Adaptive && !glfwExtensionSupported("WGL_EXT_swap_control_tear") && !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+            mode = PresentMode::VSync;
+
+        glfwSwapInterval(mode == PresentMode::Immediate ? 0 : mode == PresentMode::VSync ? 1 : -1);
+        mPresentMode = mode;
+    }
+
+    PresentMode GetPresentMode() const { return mPresentMode; }
+
+    /* Frames per second at most, 0 for no cap. Applies on top of the present mode. */
+    void SetFrameRateCap(double framesPerSecond) { mFrameRateCap = std::max(framesPerSecond, 0.0); }
+    double GetFrameRateCap() const { return mFrameRateCap; }
     
     GLFWwindow* GetWindowContext()
     {
@@ -112,4 +224,13 @@ private:
     int mScreenHeight = 720;
     std::string mWindowName = "OpenGL Window";
     GLFWwindow* mWindow;
+    PresentMode mPresentMode = PresentMode::VSync;
+    double      mFrameRateCap = 0.0;
+    int         mRedrawFrames = 1;       /* The first frame is always drawn. */
+    std::chrono::steady_clock::time_point mLastSwap = std::chrono::steady_clock::now();
+
+    static void OnInput(GLFWwindow* window)
+    {
+        static_cast<GLFWInitWindow*>(glfwGetWindowUserPointer(window))->Invalidate(kInputRedrawFrames);
+    }
 };
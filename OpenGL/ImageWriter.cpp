@@ -0,0 +1,302 @@
+//
+//  ImageWriter.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "ImageWriter.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+namespace ImageWriter
+{
+    namespace
+    {
+        /* Deflate bits go out least significant first, Huffman codes most significant first. */
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::vector<unsigned char>& output): mOutput(output) {}
+
+            void PutBits(std::uint32_t value, int count)
+            {
+                mBuffer |= value << mCount;
+                mCount  += count;
+                while (mCount >= 8)
+                {
+                    mOutput.push_back(static_cast<unsigned char>(mBuffer));
+                    mBuffer >>= 8;
+                    mCount   -= 8;
+                }
+            }
+
+            void PutCode(std::uint32_t code, int length)
+            {
+                std::uint32_t reversed = 0;
+                for (int bit = 0; bit < length; bit++)
+                    reversed |= ((code >> bit) & 1u) << (length - 1 - bit);
+                PutBits(reversed, length);
+            }
+
+            void Flush()
+            {
+                if (mCount)
+                    mOutput.push_back(static_cast<unsigned char>(mBuffer));
+                mBuffer = 0;
+                mCount  = 0;
+            }
+
+        private:
+            std::vector<unsigned char>& mOutput;
+            std::uint32_t               mBuffer = 0;
+            int                         mCount = 0;
+        };
+
+        const int kLengthBase[29]  = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        const int kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        const int kDistanceBase[30]  = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+                                        4097, 6145, 8193, 12289, 16385, 24577};
+        const int kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+        void PutLiteral(BitWriter& bits, int symbol)
+        {
+            if (symbol < 144)
+                bits.PutCode(0x30 + symbol, 8);
+            else if (symbol < 256)
+                bits.PutCode(0x190 + symbol - 144, 9);
+            else if (symbol < 280)
+                bits.PutCode(symbol - 256, 7);
+            else
+                bits.PutCode(0xC0 + symbol - 280, 8);
+        }
+
+        void PutMatch(BitWriter& bits, int length, int distance)
+        {
+            int code = 28;
+            while (kLengthBase[code] > length)
+                code--;
+            PutLiteral(bits, 257 + code);
+            bits.PutBits(length - kLengthBase[code], kLengthExtra[code]);
+
+            code = 29;
+            while (kDistanceBase[code] > distance)
+                code--;
+            bits.PutCode(code, 5);
+            bits.PutBits(distance - kDistanceBase[code], kDistanceExtra[code]);
+        }
+
+        /* One final block of fixed codes. Matches are checked against the last position with the same 3 bytes. */
+        void Deflate(const std::vector<unsigned char>& data, std::vector<unsigned char>& output)
+        {
+            constexpr int kWindow = 32768, kMaxMatch = 258, kHashBits = 15;
+            std::vector<int> head(1 << kHashBits, -1);
+            auto hash = [&data](size_t at) {
+                return ((data[at] << 10) ^ (data[at + 1] << 5) ^ data[at + 2]) & ((1 << kHashBits) - 1);
+            };
+
+            BitWriter bits(output);
+            bits.PutBits(1, 1);     /* Final block, */
+            bits.PutBits(1, 2);     /* fixed codes. */
+
+            size_t at = 0;
+            while (at < data.size())
+            {
+                int length = 0, distance = 0;
+                if (at + 3 <= data.size())
+                {
+                    const int key       = hash(at);
+                    const int candidate = head[key];
+                    head[key] = static_cast<int>(at);
+
+                    if (candidate >= 0 && at - candidate <= kWindow)
+                    {
+                        const size_t limit = std::min<size_t>(kMaxMatch, data.size() - at);
+                        while (static_cast<size_t>(length) < limit && data[candidate + length] == data[at + length])
+                            length++;
+                        distance = static_cast<int>(at - candidate);
+                    }
+                }
+
+                if (length >= 3)
+                {
+                    PutMatch(bits, length, distance);
+                    /* Positions inside the match go into the table too, runs and repeats chain on. */
+                    for (size_t skipped = at + 1; skipped < at + length && skipped + 3 <= data.size(); skipped++)
+                        head[hash(skipped)] = static_cast<int>(skipped);
+                    at += length;
+                }
+                else
+                {
+                    PutLiteral(bits, data[at]);
+                    at++;
+                }
+            }
+
+            PutLiteral(bits, 256);
+            bits.Flush();
+        }
+
+        std::uint32_t Crc32(const unsigned char* data, size_t size, std::uint32_t crc = 0)
+        {
+            static const auto table = [] {
+                std::vector<std::uint32_t> entries(256);
+                for (std::uint32_t index = 0; index < 256; index++)
+                {
+                    std::uint32_t value = index;
+                    for (int bit = 0; bit < 8; bit++)
+                        value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                    entries[index] = value;
+                }
+                return entries;
+            }();
+
+            crc = ~crc;
+            for (size_t index = 0; index < size; index++)
+                crc = table[(crc ^ data[index]) & 0xFF] ^ (crc >> 8);
+            return ~crc;
+        }
+
+        std::uint32_t Adler32(const std::vector<unsigned char>& data)
+        {
+            std::uint32_t a = 1, b = 0;
+            for (const auto byte: data)
+            {
+                a = (a + byte) % 65521;
+                b = (b + a) % 65521;
+            }
+            return (b << 16) | a;
+        }
+
+        void PutBigEndian(std::vector<unsigned char>& output, std::uint32_t value)
+        {
+            for (int shift = 24; shift >= 0; shift -= 8)
+                output.push_back(static_cast<unsigned char>(value >> shift));
+        }
+
+        void PutChunk(std::vector<unsigned char>& output, const char* type, const std::vector<unsigned char>& data)
+        {
+            PutBigEndian(output, static_cast<std::uint32_t>(data.size()));
+            const size_t start = output.size();
+            output.insert(output.end(), type, type + 4);
+            output.insert(output.end(), data.begin(), data.end());
+            PutBigEndian(output, Crc32(output.data() + start, output.size() - start));
+        }
+
+        int Paeth(int left, int up, int upLeft)
+        {
+            const int estimate = left + up - upLeft;
+            const int toLeft = std::abs(estimate - left), toUp = std::abs(estimate - up), toUpLeft = std::abs(estimate - upLeft);
+            if (toLeft <= toUp && toLeft <= toUpLeft)
+                return left;
+            return toUp <= toUpLeft ? up : upLeft;
+        }
+
+        bool WriteFile(const std::string& path, const unsigned char* data, size_t size)
+        {
+            /* Written aside and renamed, a reader never sees half an image. */
+            const std::string partial = path + ".partial";
+            {
+                std::ofstream file(partial, std::ios::binary);
+                if (!file)
+                    return false;
+
+                file.write(reinterpret_cast<const char*>(data), size);
+                if (!file)
+                    return false;
+            }
+
+            return std::rename(partial.c_str(), path.c_str()) == 0;
+        }
+    }
+
+    std::vector<unsigned char> EncodePNG(const unsigned char* pixels, int width, int height, int channels)
+    {
+        PROFILE_FUNCTION();
+
+        if (channels < 1 || channels > 4)
+            throw std::runtime_error("Bad Channel!");
+
+        /* Each row gets the filter leaving the smallest sum of bytes taken as signed, the usual heuristic. */
+        const size_t stride = static_cast<size_t>(width) * channels;
+        std::vector<unsigned char> filtered;
+        filtered.reserve((stride + 1) * height);
+        std::vector<unsigned char> candidate(stride), best(stride);
+
+        for (int y = 0; y < height; y++)
+        {
+            const unsigned char* row  = pixels + y * stride;
+            const unsigned char* prev = y ? row - stride : nullptr;
+
+            long bestScore = -1;
+            int  bestFilter = 0;
+            for (int filter = 0; filter < 5; filter++)
+            {
+                long score = 0;
+                for (size_t x = 0; x < stride; x++)
+                {
+                    const int left   = x >= static_cast<size_t>(channels) ? row[x - channels] : 0;
+                    const int up     = prev ? prev[x] : 0;
+                    const int upLeft = prev && x >= static_cast<size_t>(channels) ? prev[x - channels] : 0;
+
+                    int predicted = 0;
+                    if (filter == 1)
+                        predicted = left;
+                    else if (filter == 2)
+                        predicted = up;
+                    else if (filter == 3)
+                        predicted = (left + up) / 2;
+                    else if (filter == 4)
+                        predicted = Paeth(left, up, upLeft);
+
+                    candidate[x] = static_cast<unsigned char>(row[x] - predicted);
+                    score += std::abs(static_cast<int>(static_cast<signed char>(candidate[x])));
+                }
+
+                if (bestScore < 0 || score < bestScore)
+                {
+                    bestScore  = score;
+                    bestFilter = filter;
+                    best.swap(candidate);
+                }
+            }
+
+            filtered.push_back(static_cast<unsigned char>(bestFilter));
+            filtered.insert(filtered.end(), best.begin(), best.end());
+        }
+
+        std::vector<unsigned char> compressed = {0x78, 0x01};
+        Deflate(filtered, compressed);
+        PutBigEndian(compressed, Adler32(filtered));
+
+        const unsigned char colorTypes[4] = {0, 4, 2, 6};
+        std::vector<unsigned char> header;
+        PutBigEndian(header, static_cast<std::uint32_t>(width));
+        PutBigEndian(header, static_cast<std::uint32_t>(height));
+        header.insert(header.end(), {8, colorTypes[channels - 1], 0, 0, 0});
+
+        std::vector<unsigned char> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        PutChunk(png, "IHDR", header);
+        PutChunk(png, "IDAT", compressed);
+        PutChunk(png, "IEND", {});
+        return png;
+    }
+
+    bool WritePNG(const std::string& path, const unsigned char* pixels, int width, int height, int channels)
+    {
+        const std::vector<unsigned char> png = EncodePNG(pixels, width, height, channels);
+        return WriteFile(path, png.data(), png.size());
+    }
+
+    bool WriteRaw(const std::string& path, const unsigned char* pixels, int width, int height, int channels)
+    {
+        return WriteFile(path, pixels, static_cast<size_t>(width) * height * channels);
+    }
+}
@@ -0,0 +1,30 @@
+//
+//  ImageWriter.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef ImageWriter_hpp
+#define ImageWriter_hpp
+
+#include <string>
+#include <vector>
+
+/*
+ * 8 bit images to PNG or raw bytes, rows top first and tightly packed. The PNG encoder picks a filter per row
+ * and deflates with the fixed Huffman codes and a single candidate LZ77 match: much smaller than stored blocks,
+ * not as small as zlib.
+ */
+namespace ImageWriter
+{
+    /* 1 to 4 channels: grey, grey alpha, RGB, RGBA. */
+    std::vector<unsigned char> EncodePNG(const unsigned char* pixels, int width, int height, int channels);
+
+    /* Written to a temporary file then renamed, a reader never sees half an image. */
+    bool WritePNG(const std::string& path, const unsigned char* pixels, int width, int height, int channels);
+    bool WriteRaw(const std::string& path, const unsigned char* pixels, int width, int height, int channels);
+}
+
+#endif /* ImageWriter_hpp */
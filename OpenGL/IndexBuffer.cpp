@@ -16,11 +16,13 @@ IndexBuffer::IndexBuffer(const std::vector<unsigned int>& indices) : mCount(stat
     GLCall(glGenBuffers(1, &mRendererId));
     GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mRendererId));
     GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), static_cast<const void *>(indices.data()), GL_STATIC_DRAW));
+    mResource = GLResources::Register(GLResources::Type::Buffer, mRendererId, indices.size() * sizeof(unsigned int), "index buffer", GL_RESOURCE_SITE);
 }
 
 IndexBuffer::~IndexBuffer()
 {
     GLCall(glDeleteBuffers(1, &mRendererId));
+    GLResources::Release(mResource);
 }
 
 void IndexBuffer::Bind() const
@@ -10,12 +10,14 @@
 #define IndexBuffer_hpp
 
 #include <vector>
+#include "GLResources.hpp"
 
 class IndexBuffer
 {
 private:
     unsigned int mRendererId;
     unsigned int mCount;
+    GLResources::Handle mResource;
 public:
     IndexBuffer(const std::vector<unsigned int>& data);
     ~IndexBuffer();
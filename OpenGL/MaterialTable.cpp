@@ -0,0 +1,341 @@
+//
+//  MaterialTable.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "MaterialTable.hpp"
+#include "ErrorHandler.hpp"
+#include "Profiler.hpp"
+#include "Texture.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+MaterialTable::~MaterialTable()
+{
+    Clear();
+}
+
+unsigned int MaterialTable::Add(const Material& material)
+{
+    const auto found = std::find(mMaterials.begin(), mMaterials.end(), material);
+    if (found != mMaterials.end())
+        return static_cast<unsigned int>(found - mMaterials.begin());
+
+    mMaterials.push_back(material);
+    mMaterialArrays.emplace_back();
+    return static_cast<unsigned int>(mMaterials.size() - 1);
+}
+
+void MaterialTable::Clear()
+{
+    DeleteArrays();
+
+    if (mTableBuffer)
+    {
+        GLCall(glDeleteTextures(1, &mTableTexture));
+        GLCall(glDeleteBuffers(1, &mTableBuffer));
+        GLCall(glDeleteBuffers(1, &mStagingBuffer));
+    }
+
+    GLResources::Release(mTableResource);
+    GLResources::Release(mStagingResource);
+    mTableResource = mStagingResource = 0;
+
+    mTableBuffer = mTableTexture = mStagingBuffer = 0;
+    mMaterials.clear();
+    mMaterialArrays.clear();
+    mMaterialArrayIndices.clear();
+}
+
+void MaterialTable::DeleteArrays()
+{
+    for (const auto& array: mArrayInfo)
+    {
+        GLCall(glDeleteTextures(1, &array.name));
+        GLResources::Release(array.resource);
+    }
+
+    mArrayInfo.clear();
+}
+
+void MaterialTable::Build(const std::deque<Texture>& textures)
+{
+    PROFILE_FUNCTION();
+
+    DeleteArrays();
+
+    if (!mTableBuffer)
+    {
+        GLCall(glGenBuffers(1, &mTableBuffer));
+        GLCall(glGenBuffers(1, &mStagingBuffer));
+        GLCall(glGenTextures(1, &mTableTexture));
+
+        mTableResource   = GLResources::Register(GLResources::Type::Buffer, mTableBuffer, 0, "material table", GL_RESOURCE_SITE);
+        mStagingResource = GLResources::Register(GLResources::Type::Buffer, mStagingBuffer, 0, "material staging", GL_RESOURCE_SITE);
+    }
+
+    /* Layers of an array share size, format, mip count and the levels held. */
+    std::vector<std::vector<unsigned int>> groups;
+    std::vector<int> textureArray(textures.size()), textureLayer(textures.size());
+
+    for (unsigned int index = 0; index < textures.size(); index++)
+    {
+        const Texture& texture = textures[index];
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const std::vector<unsigned int>& members) {
+            const Texture& first = textures[members[0]];
+            return first.GetWidth() == texture.GetWidth() && first.GetHeight() == texture.GetHeight() &&
+                   first.GetInternalFormat() == texture.GetInternalFormat() && first.GetLevelCount() == texture.GetLevelCount() &&
+                   first.GetBaseLevel() == texture.GetBaseLevel();
+        });
+
+        if (group == groups.end())
+            group = groups.insert(groups.end(), std::vector<unsigned int>());
+
+        textureArray[index] = static_cast<int>(group - groups.begin());
+        textureLayer[index] = static_cast<int>(group->size());
+        group->push_back(index);
+    }
+
+    mArrayInfo.resize(groups.size());
+    for (auto& array: mArrayInfo)
+    {
+        GLCall(glGenTextures(1, &array.name));
+    }
+
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+    for (size_t index = 0; index < groups.size(); index++)
+    {
+        const std::vector<unsigned int>& members = groups[index];
+        const Texture& first = textures[members[0]];
+        const unsigned int format = Texture::GetFormat(first.GetChannels());
+        const bool compressed = Texture::IsCompressedFormat(first.GetInternalFormat());
+        const GLsizei layers = static_cast<GLsizei>(members.size());
+
+        Array& array = mArrayInfo[index];
+        array.width          = first.GetWidth();
+        array.height         = first.GetHeight();
+        array.channels       = first.GetChannels();
+        array.internalFormat = first.GetInternalFormat();
+        array.levels         = first.GetLevelCount();
+        array.layers         = layers;
+        array.residentLevel  = array.requestedLevel = first.GetBaseLevel();
+        array.streamable     = true;
+        for (const auto member: members)
+        {
+            const Texture& texture = textures[member];
+            array.paths.push_back(texture.GetTexturePath());
+            array.srgb.push_back(texture.IsSRGB());
+            array.streamable = array.streamable && texture.IsLoaded() && !texture.GetTexturePath().empty();
+        }
+
+        GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, array.name));
+
+        for (int level = array.residentLevel; level < array.levels; level++)
+        {
+            const int width  = std::max(1, array.width >> level);
+            const int height = std::max(1, array.height >> level);
+            const GLsizei levelBytes = static_cast<GLsizei>(Texture::GetLevelByteSize(array.internalFormat, array.channels, width, height));
+
+            if (compressed)
+            {
+                GLCall(glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, array.internalFormat, width, height, layers, 0, levelBytes * layers, nullptr));
+            }
+            else
+            {
+                GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, level, array.internalFormat, width, height, layers, 0, format, GL_UNSIGNED_BYTE, nullptr));
+            }
+
+            /* Read back into the staging buffer and straight out of it again, the texels never leave the GPU. */
+            for (GLsizei layer = 0; layer < layers; layer++)
+            {
+                GLCall(glBindTexture(GL_TEXTURE_2D, textures[members[layer]].GetTextureID()));
+                GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, mStagingBuffer));
+                GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, levelBytes, nullptr, GL_STREAM_COPY));
+                GLResources::SetByteSize(mStagingResource, levelBytes);
+
+                if (compressed)
+                {
+                    GLCall(glGetCompressedTexImage(GL_TEXTURE_2D, level, nullptr));
+                }
+                else
+                {
+                    GLCall(glGetTexImage(GL_TEXTURE_2D, level, format, GL_UNSIGNED_BYTE, nullptr));
+                }
+
+                GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+                GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mStagingBuffer));
+
+                if (compressed)
+                {
+                    GLCall(glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, width, height, 1, array.internalFormat, levelBytes, nullptr));
+                }
+                else
+                {
+                    GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, width, height, 1, format, GL_UNSIGNED_BYTE, nullptr));
+                }
+
+                GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+            }
+        }
+
+        GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, array.residentLevel));
+        GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, array.levels - 1));
+
+        array.resource = GLResources::Register(GLResources::Type::Texture, array.name, GetByteSize(index, array.residentLevel), array.paths[0], GL_RESOURCE_SITE);
+        GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    }
+
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+
+    std::vector<float> table;
+    table.reserve(4 * mMaterials.size());
+    mMaterialArrayIndices.assign(mMaterials.size(), {-1, -1});
+    for (size_t index = 0; index < mMaterials.size(); index++)
+    {
+        const Material& material = mMaterials[index];
+        const bool diffuse  = material.diffuse  >= 0 && material.diffuse  < static_cast<int>(textures.size());
+        const bool specular = material.specular >= 0 && material.specular < static_cast<int>(textures.size());
+
+        mMaterialArrayIndices[index].first  = diffuse  ? textureArray[material.diffuse]  : -1;
+        mMaterialArrayIndices[index].second = specular ? textureArray[material.specular] : -1;
+
+        mMaterialArrays[index].diffuse  = diffuse  ? mArrayInfo[textureArray[material.diffuse]].name  : 0;
+        mMaterialArrays[index].specular = specular ? mArrayInfo[textureArray[material.specular]].name : 0;
+
+        table.push_back(diffuse  ? static_cast<float>(textureLayer[material.diffuse])  : -1.0f);
+        table.push_back(specular ? static_cast<float>(textureLayer[material.specular]) : -1.0f);
+        table.push_back(material.shininess);
+        table.push_back(0.0f);
+    }
+
+    if (table.empty())
+        table.resize(4, -1.0f);
+
+    GLCall(glBindBuffer(GL_TEXTURE_BUFFER, mTableBuffer));
+    GLCall(glBufferData(GL_TEXTURE_BUFFER, table.size() * sizeof(float), table.data(), GL_STATIC_DRAW));
+    GLResources::SetByteSize(mTableResource, table.size() * sizeof(float));
+    GLCall(glBindTexture(GL_TEXTURE_BUFFER, mTableTexture));
+    GLCall(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, mTableBuffer));
+    GLCall(glBindTexture(GL_TEXTURE_BUFFER, 0));
+    GLCall(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+}
+
+void MaterialTable::Request(unsigned int material, float uvPerPixel, unsigned long long frame)
+{
+    if (material >= mMaterialArrayIndices.size())
+        return;
+
+    for (const int index: {mMaterialArrayIndices[material].first, mMaterialArrayIndices[material].second})
+    {
+        if (index < 0)
+            continue;
+
+        /* Texels per pixel at level 0, each level halves them. */
+        Array& array = mArrayInfo[index];
+        const float texelsPerPixel = std::max(array.width, array.height) * uvPerPixel;
+        const int level = texelsPerPixel > 1.0f ? std::min(static_cast<int>(std::log2(texelsPerPixel)), array.levels - 1) : 0;
+
+        /* The finest over all meshes drawn this frame. */
+        array.requestedLevel = array.requestFrame == frame ? std::min(array.requestedLevel, level) : level;
+        array.requestFrame   = frame;
+    }
+}
+
+void MaterialTable::AllocateLevel(size_t index, int level)
+{
+    const Array& array = mArrayInfo[index];
+    const int width  = std::max(1, array.width >> level);
+    const int height = std::max(1, array.height >> level);
+
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, array.name));
+    if (Texture::IsCompressedFormat(array.internalFormat))
+    {
+        const size_t levelBytes = Texture::GetLevelByteSize(array.internalFormat, array.channels, width, height) * array.layers;
+        GLCall(glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, array.internalFormat, width, height, array.layers, 0, static_cast<GLsizei>(levelBytes), nullptr));
+    }
+    else
+    {
+        GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, level, array.internalFormat, width, height, array.layers, 0, Texture::GetFormat(array.channels), GL_UNSIGNED_BYTE, nullptr));
+    }
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+
+    GLResources::SetByteSize(array.resource, GetByteSize(index, level));
+}
+
+void MaterialTable::SetResidentLevel(size_t index, int level, unsigned long long frame)
+{
+    Array& array = mArrayInfo[index];
+
+    /* Sampling moves off the levels before they are dropped, a zero sized level frees its storage. */
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, array.name));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, level));
+    for (int dropped = array.residentLevel; dropped < level; dropped++)
+    {
+        if (Texture::IsCompressedFormat(array.internalFormat))
+        {
+            GLCall(glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, dropped, array.internalFormat, 0, 0, 0, 0, 0, nullptr));
+        }
+        else
+        {
+            GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, dropped, array.internalFormat, 0, 0, 0, 0, Texture::GetFormat(array.channels), GL_UNSIGNED_BYTE, nullptr));
+        }
+    }
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+
+    array.residentLevel = level;
+    array.changeFrame   = frame;
+    GLResources::SetByteSize(array.resource, GetByteSize(index, level));
+}
+
+size_t MaterialTable::GetByteSize(size_t index, int level) const
+{
+    const Array& array = mArrayInfo[index];
+
+    size_t bytes = 0;
+    for (int current = level; current < array.levels; current++)
+        bytes += Texture::GetLevelByteSize(array.internalFormat, array.channels, std::max(1, array.width >> current), std::max(1, array.height >> current));
+    return bytes * array.layers;
+}
+
+size_t MaterialTable::GetByteSize() const
+{
+    size_t bytes = 0;
+    for (size_t index = 0; index < mArrayInfo.size(); index++)
+        bytes += GetByteSize(index, mArrayInfo[index].residentLevel);
+    return bytes;
+}
+
+size_t MaterialTable::GetUncompressedByteSize() const
+{
+    size_t bytes = 0;
+    for (const auto& array: mArrayInfo)
+        for (int level = array.residentLevel; level < array.levels; level++)
+            bytes += static_cast<size_t>(std::max(1, array.width >> level)) * std::max(1, array.height >> level) * array.channels * array.layers;
+    return bytes;
+}
+
+void MaterialTable::BindArrays(const Arrays& arrays, unsigned int diffuseSlot, unsigned int specularSlot) const
+{
+    GLCall(glActiveTexture(GL_TEXTURE0 + diffuseSlot));
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, arrays.diffuse));
+    GLCall(glActiveTexture(GL_TEXTURE0 + specularSlot));
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, arrays.specular));
+}
+
+void MaterialTable::BindTable(unsigned int slot) const
+{
+    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+    GLCall(glBindTexture(GL_TEXTURE_BUFFER, mTableTexture));
+}
@@ -0,0 +1,127 @@
+//
+//  MaterialTable.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef MaterialTable_hpp
+#define MaterialTable_hpp
+
+#include "GLResources.hpp"
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Texture;
+
+/*
+ * Materials of a model and its textures packed into GL_TEXTURE_2D_ARRAYs, one array per size, format and mip count.
+ * The table goes up as a texture buffer (RGBA32F, per material: diffuse layer, specular layer, shininess, 0, layer
+ * -1 for no map), so a draw only passes its material index. Arrays are rebound only between materials whose maps
+ * live in different arrays.
+ *
+ * An array may hold only its coarser levels: the finest one held is its GL_TEXTURE_BASE_LEVEL, the levels above it
+ * are empty. Draws report the level each array needs and TextureStreamer moves the base level within its budget.
+ */
+class MaterialTable
+{
+public:
+    struct Material
+    {
+        int   diffuse   = -1;       /* Index into the model's textures, -1 for none. */
+        int   specular  = -1;
+        float shininess = 32.0f;
+
+        bool operator==(const Material& other) const
+        {
+            return diffuse == other.diffuse && specular == other.specular && shininess == other.shininess;
+        }
+    };
+
+    /* GL names of the arrays a material samples, 0 for a missing map. */
+    struct Arrays
+    {
+        unsigned int diffuse  = 0;
+        unsigned int specular = 0;
+
+        bool operator==(const Arrays& other) const { return diffuse == other.diffuse && specular == other.specular; }
+        bool operator!=(const Arrays& other) const { return !(*this == other); }
+    };
+
+    struct Array
+    {
+        unsigned int             name = 0;
+        int                      width = 0, height = 0;      /* Of level 0, held or not. */
+        int                      channels = 0;
+        unsigned int             internalFormat = 0;
+        int                      levels = 0;
+        int                      layers = 0;
+        bool                     streamable = false;         /* Every layer loaded from a file the streamer can read again. */
+        int                      residentLevel = 0;          /* The base level. */
+        int                      requestedLevel = 0;         /* Finest level drawn with at requestFrame. */
+        unsigned long long       requestFrame = 0;           /* 0 when never drawn. */
+        unsigned long long       changeFrame = 0;            /* Last time the base level moved. */
+        std::vector<std::string> paths;                      /* Source of each layer, */
+        std::vector<bool>        srgb;                       /* and how it was filtered. */
+        GLResources::Handle      resource = 0;
+    };
+
+    MaterialTable() = default;
+    ~MaterialTable();
+
+    MaterialTable(const MaterialTable&) = delete;
+    MaterialTable& operator=(const MaterialTable&) = delete;
+
+    /* Index of the material, added when new. */
+    unsigned int Add(const Material& material);
+    void Clear();
+
+    /*
+     * (Re)packs the textures as they are now, placeholders included, and uploads the table. Texels are copied
+     * on the GPU through a pixel pack then unpack buffer, compressed levels stay compressed.
+     */
+    void Build(const std::deque<Texture>& textures);
+
+    const Arrays& GetArrays(unsigned int material) const { return mMaterialArrays[material]; }
+    void BindArrays(const Arrays& arrays, unsigned int diffuseSlot, unsigned int specularSlot) const;
+    void BindTable(unsigned int slot) const;
+
+    /* A mesh of the material is drawn with uvPerPixel texture coordinate units per screen pixel, at most. */
+    void Request(unsigned int material, float uvPerPixel, unsigned long long frame);
+
+    /* Allocates an empty level of the array, to be filled before it becomes the base level. */
+    void AllocateLevel(size_t array, int level);
+    /* Moves the base level, levels above it are emptied. */
+    void SetResidentLevel(size_t array, int level, unsigned long long frame);
+    /* Keeps the array as it is, e.g. once its files no longer match it. */
+    void Pin(size_t array) { mArrayInfo[array].streamable = false; }
+
+    size_t GetMaterialCount() const { return mMaterials.size(); }
+    size_t GetArrayCount() const { return mArrayInfo.size(); }
+    const Array& GetArray(size_t array) const { return mArrayInfo[array]; }
+
+    /* All layers of the array from level down to 1x1. */
+    size_t GetByteSize(size_t array, int level) const;
+    /* GPU memory of the arrays as held, and what those levels would take as plain 8 bit texels. */
+    size_t GetByteSize() const;
+    size_t GetUncompressedByteSize() const;
+
+private:
+    void DeleteArrays();
+
+    std::vector<Material>     mMaterials;
+    std::vector<Arrays>       mMaterialArrays;
+    std::vector<Array>        mArrayInfo;
+    std::vector<std::pair<int, int>> mMaterialArrayIndices;     /* Into mArrayInfo, diffuse and specular, -1 for none. */
+    unsigned int              mTableBuffer  = 0;
+    unsigned int              mTableTexture = 0;
+    unsigned int              mStagingBuffer = 0;
+    GLResources::Handle       mTableResource = 0;
+    GLResources::Handle       mStagingResource = 0;
+};
+
+#endif /* MaterialTable_hpp */
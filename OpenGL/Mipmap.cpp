@@ -0,0 +1,172 @@
+//
+//  Mipmap.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "Mipmap.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Mipmap
+{
+    namespace
+    {
+        constexpr int    kTaps          = 8;        /* Source texels per axis for one target texel. */
+        constexpr double kKaiserBeta    = 4.0;
+        constexpr int    kEncodeEntries = 16384;    /* Linear to 8 bit steps, fine enough for dark sRGB values. */
+
+        double BesselI0(double x)
+        {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32; k++)
+            {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum  += term;
+            }
+            return sum;
+        }
+
+        struct Tables
+        {
+            float         kernel[kTaps];
+            float         decode[2][256];                   /* Linear, sRGB. */
+            unsigned char encode[2][kEncodeEntries + 1];
+
+            Tables()
+            {
+                /* Tap k reads source texel 2x - 3 + k, centered on 2x + 1 (in texel centers). Radius 2 target texels. */
+                double sum = 0.0, weights[kTaps];
+                for (int tap = 0; tap < kTaps; tap++)
+                {
+                    const double distance = (tap - 3.5) / 2.0;
+                    const double sinc = std::sin(M_PI * distance) / (M_PI * distance);
+                    const double ratio = distance / 2.0;
+                    weights[tap] = sinc * BesselI0(kKaiserBeta * std::sqrt(1.0 - ratio * ratio)) / BesselI0(kKaiserBeta);
+                    sum += weights[tap];
+                }
+                for (int tap = 0; tap < kTaps; tap++)
+                    kernel[tap] = static_cast<float>(weights[tap] / sum);
+
+                for (int value = 0; value < 256; value++)
+                {
+                    const double encoded = value / 255.0;
+                    decode[0][value] = static_cast<float>(encoded);
+                    decode[1][value] = static_cast<float>(encoded <= 0.04045 ? encoded / 12.92 : std::pow((encoded + 0.055) / 1.055, 2.4));
+                }
+
+                for (int entry = 0; entry <= kEncodeEntries; entry++)
+                {
+                    const double linear = double(entry) / kEncodeEntries;
+                    const double srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+                    encode[0][entry] = static_cast<unsigned char>(std::lround(linear * 255.0));
+                    encode[1][entry] = static_cast<unsigned char>(std::lround(srgb * 255.0));
+                }
+            }
+        };
+
+        const Tables& GetTables()
+        {
+            static const Tables tables;
+            return tables;
+        }
+    }
+
+    std::vector<Level> Layout(int width, int height, int channels)
+    {
+        std::vector<Level> levels;
+        size_t offset = 0;
+        for (;;)
+        {
+            levels.push_back({width, height, offset});
+            offset += static_cast<size_t>(width) * height * channels;
+
+            if (width == 1 && height == 1)
+                return levels;
+
+            width  = std::max(1, width / 2);
+            height = std::max(1, height / 2);
+        }
+    }
+
+    size_t GetByteSize(const std::vector<Level>& levels, int channels)
+    {
+        const Level& last = levels.back();
+        return last.offset + static_cast<size_t>(last.width) * last.height * channels;
+    }
+
+    void Generate(unsigned char* chain, const std::vector<Level>& levels, int channels, bool srgb, ThreadPool* pool)
+    {
+        PROFILE_FUNCTION();
+
+        const Tables& tables = GetTables();
+
+        /* Alpha stays linear. */
+        const float* decode[4];
+        const unsigned char* encode[4];
+        for (int channel = 0; channel < 4; channel++)
+        {
+            const int table = srgb && !(channels == 4 && channel == 3) ? 1 : 0;
+            decode[channel] = tables.decode[table];
+            encode[channel] = tables.encode[table];
+        }
+
+        for (size_t index = 1; index < levels.size(); index++)
+        {
+            const Level& source = levels[index - 1];
+            const Level& target = levels[index];
+            const unsigned char* sourceTexels = chain + source.offset;
+            unsigned char* targetTexels = chain + target.offset;
+            const size_t sourceRow = static_cast<size_t>(source.width) * channels;
+
+            /* Per target row: filter 8 source rows down to one in linear float, then that row across. */
+            auto filterRows = [&](size_t begin, size_t end) {
+                std::vector<float> column(sourceRow);
+
+                for (size_t y = begin; y < end; y++)
+                {
+                    std::fill(column.begin(), column.end(), 0.0f);
+                    for (int tap = 0; tap < kTaps; tap++)
+                    {
+                        const int sourceY = std::min(std::max(2 * static_cast<int>(y) - 3 + tap, 0), source.height - 1);
+                        const unsigned char* row = sourceTexels + sourceY * sourceRow;
+                        const float weight = tables.kernel[tap];
+
+                        for (int channel = 0; channel < channels; channel++)
+                        {
+                            const float* table = decode[channel];
+                            for (size_t offset = channel; offset < sourceRow; offset += channels)
+                                column[offset] += weight * table[row[offset]];
+                        }
+                    }
+
+                    unsigned char* targetRow = targetTexels + y * target.width * channels;
+                    for (int x = 0; x < target.width; x++)
+                        for (int channel = 0; channel < channels; channel++)
+                        {
+                            float sum = 0.0f;
+                            for (int tap = 0; tap < kTaps; tap++)
+                            {
+                                const int sourceX = std::min(std::max(2 * x - 3 + tap, 0), source.width - 1);
+                                sum += tables.kernel[tap] * column[sourceX * channels + channel];
+                            }
+
+                            /* The sinc lobes overshoot near edges. */
+                            const float clamped = std::min(std::max(sum, 0.0f), 1.0f);
+                            targetRow[x * channels + channel] = encode[channel][static_cast<int>(clamped * kEncodeEntries + 0.5f)];
+                        }
+                }
+            };
+
+            if (pool)
+                pool->ParallelFor(target.height, 16, filterRows);
+            else
+                filterRows(0, target.height);
+        }
+    }
+}
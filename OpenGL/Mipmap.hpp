@@ -0,0 +1,42 @@
+//
+//  Mipmap.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef Mipmap_hpp
+#define Mipmap_hpp
+
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+/*
+ * Mip chains built on the CPU, so textures load with their levels instead of a glGenerateMipmap per file.
+ * Each level halves the one before with a separable Kaiser windowed sinc (8 taps per axis), which keeps more
+ * detail than a box filter without ringing much. Color channels of sRGB images are filtered in linear light.
+ */
+namespace Mipmap
+{
+    struct Level
+    {
+        int    width;
+        int    height;
+        size_t offset;      /* Bytes into the chain, rows tightly packed. */
+    };
+
+    /* Every level down to 1x1, level 0 first and at offset 0. */
+    std::vector<Level> Layout(int width, int height, int channels);
+    size_t GetByteSize(const std::vector<Level>& levels, int channels);
+
+    /*
+     * chain holds level 0 as laid out, the other levels are written from it. With srgb, all but the alpha
+     * channel (the 4th) are sRGB encoded. Rows of a level are split over the pool, which may be null.
+     */
+    void Generate(unsigned char* chain, const std::vector<Level>& levels, int channels, bool srgb, ThreadPool* pool);
+}
+
+#endif /* Mipmap_hpp */
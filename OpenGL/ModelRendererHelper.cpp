@@ -7,22 +7,62 @@
 //
 
 #include "ModelRendererHelper.hpp"
+#include "GLResources.hpp"
+#include "Profiler.hpp"
+#include "TextureStreamer.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
 
 namespace Helper
 {
-    
-    ModelRenderer::ModelRenderer(const std::string& filepath):fModel(std::make_unique<TriangleMesh>(filepath))
+    namespace
+    {
+        /* Square root of UV area over surface area, summed over the triangles. 0 for meshes without either. */
+        float GetUVDensity(const std::vector<float>& positions, const std::vector<float>& uvCoords, const std::vector<unsigned int>& indices)
+        {
+            double surfaceArea = 0.0, uvArea = 0.0;
+            for (size_t index = 0; index + 2 < indices.size(); index += 3)
+            {
+                const unsigned int a = indices[index], b = indices[index + 1], c = indices[index + 2];
+                const glm::vec3 pa(positions[3 * a], positions[3 * a + 1], positions[3 * a + 2]);
+                const glm::vec3 pb(positions[3 * b], positions[3 * b + 1], positions[3 * b + 2]);
+                const glm::vec3 pc(positions[3 * c], positions[3 * c + 1], positions[3 * c + 2]);
+                const glm::vec2 ta(uvCoords[2 * a], uvCoords[2 * a + 1]);
+                const glm::vec2 tb(uvCoords[2 * b], uvCoords[2 * b + 1]);
+                const glm::vec2 tc(uvCoords[2 * c], uvCoords[2 * c + 1]);
+
+                surfaceArea += 0.5 * glm::length(glm::cross(pb - pa, pc - pa));
+                uvArea      += 0.5 * std::abs((tb.x - ta.x) * (tc.y - ta.y) - (tc.x - ta.x) * (tb.y - ta.y));
+            }
+
+            return surfaceArea > 0.0 ? static_cast<float>(std::sqrt(uvArea / surfaceArea)) : 0.0f;
+        }
+    }
+
+
+    ModelRenderer::ModelRenderer(const std::string& filepath, TextureStreamer* textureStreamer):fModel(std::make_unique<TriangleMesh>(filepath)), fTextureStreamer(textureStreamer)
+    {
+        Import();
+    }
+
+    ModelRenderer::ModelRenderer(std::unique_ptr<TriangleMesh> model, TextureStreamer* textureStreamer):fModel(std::move(model)), fTextureStreamer(textureStreamer)
     {
         Import();
     }
 
     ModelRenderer::~ModelRenderer()
     {
-        
+        if (fTextureStreamer)
+            fTextureStreamer->Untrack(fMaterials);
     }
     
     void ModelRenderer::Import()
     {
+        GLResources::ScopedOwner owner(fModel->GetFilePath());
+
         const auto& modelMeshes = fModel->GetModelMesh();
         fModelVA.resize(modelMeshes.size());
         /* WARNING: careful not to reallocate any entry! */
@@ -38,19 +78,95 @@ namespace Helper
             ASSERT(!meshUVCoords.empty());      /* UV's might be optional. Put a check! */
             fModelVA[index].CreateVBuffer2f(meshUVCoords);
             fModelVA[index].CreateIBuffer(meshIndicies);
+            
+            fMeshBounds.push_back(meshPositions.empty() ? CommonUtils::BBCoord{} : CommonUtils::GetBBox(meshPositions));
+            fMeshUVDensity.push_back(GetUVDensity(meshPositions, meshUVCoords, meshIndicies));
         }
         
         const auto& texturePaths = fModel->GetTexturePaths();
+        const std::vector<bool> srgb = GetSRGBTextures(*fModel);
         
         /* WARNING: careful not to reallocate any entry! */
-        for(const auto& path: texturePaths)
-            fModelTextures.emplace_back(path);
+        for (size_t index = 0; index < texturePaths.size(); index++)
+        {
+            if (fTextureStreamer)
+                fModelTextures.emplace_back(texturePaths[index], *fTextureStreamer, srgb[index]);
+            else
+                fModelTextures.emplace_back(texturePaths[index], srgb[index]);
+        }
+
+        /* Multiple texture maps of same type for single mesh doesn't make much sense to me right now.
+           So, I'm just dealing with one map for now. */
+        for (unsigned int index = 0; index < modelMeshes.size(); index++)
+        {
+            MaterialTable::Material material;
+            for (const auto& tex: modelMeshes.at(index).mTextures)
+            {
+                if (tex.type == TriangleMesh::Texture::Diffuse)
+                    material.diffuse = static_cast<int>(tex.indices[0]);
+                else if (tex.type == TriangleMesh::Texture::Specular)
+                    material.specular = static_cast<int>(tex.indices[0]);
+            }
+
+            fMeshMaterials.push_back(fMaterials.Add(material));
+        }
+
+        for (unsigned int instance = 0; instance < GetMeshInstances().size(); instance++)
+            fMeshOrder.push_back(instance);
+
+        UpdateMaterials();
+    }
+
+    void ModelRenderer::UpdateMaterials()
+    {
+        if (fMaterialsPacked && fModelTextures.empty())
+            return;
+
+        const size_t loaded = std::count_if(fModelTextures.begin(), fModelTextures.end(), [](const Texture& texture) { return texture.IsLoaded(); });
+        if (fMaterialsPacked && loaded == fPackedTextures)
+            return;
+
+        GLResources::ScopedOwner owner(fModel ? fModel->GetFilePath() : std::string());
+
+        /* The streamer must not hold on to arrays being replaced. */
+        if (fTextureStreamer)
+            fTextureStreamer->Untrack(fMaterials);
+
+        fMaterials.Build(fModelTextures);
+        fMaterialsPacked = true;
+
+        if (fTextureStreamer)
+            fTextureStreamer->Track(fMaterials);
+        fPackedTextures  = loaded;
+
+        const auto& instances = GetMeshInstances();
+        std::stable_sort(fMeshOrder.begin(), fMeshOrder.end(), [this, &instances](unsigned int first, unsigned int second) {
+            const unsigned int materialA = fMeshMaterials[instances[first].mesh], materialB = fMeshMaterials[instances[second].mesh];
+            const auto& a = fMaterials.GetArrays(materialA);
+            const auto& b = fMaterials.GetArrays(materialB);
+            return std::tie(a.diffuse, a.specular, materialA, instances[first].node) < std::tie(b.diffuse, b.specular, materialB, instances[second].node);
+        });
+
+        /* Everything is in the arrays now, the separate textures would only take memory. */
+        if (loaded == fModelTextures.size())
+            fModelTextures.clear();
     }
 
     void ModelRenderer::Clear()
     {
+        if (fTextureStreamer)
+            fTextureStreamer->Untrack(fMaterials);
+
         fModelTextures.clear();
+        fMaterials.Clear();
+        fMaterialsPacked = false;
+        fPackedTextures  = 0;
+        fMeshMaterials.clear();
+        fMeshOrder.clear();
         fModelVA.clear();
+        fMeshBounds.clear();
+        fMeshUVDensity.clear();
+        fMeshBVHs.clear();
         fModel.reset();
     }
     
@@ -61,51 +177,206 @@ namespace Helper
         Import();
     }
     
+    bool ModelRenderer::UpdateTransforms()
+    {
+        return fModel && fModel->GetSceneGraph().Update() > 0;
+    }
+
     void ModelRenderer::Draw(const Renderer& renderer, Shader& shader) const
     {
-        /*
-         * ToDo: Few issues here:
-         */
-        shader.SetUniform1f("u_MaterialProperty.shininess", 32.0f);
+        PROFILE_SCOPE("ModelRenderer::Draw");
 
-        const auto& modelMeshes = fModel->GetModelMesh();
+        /* Nothing culled, every instance counts as visible. */
+        renderer.CountMeshes(static_cast<unsigned int>(GetMeshInstances().size()), 0);
+        DrawMeshes(renderer, shader, false);
+    }
+    
+    void ModelRenderer::Draw(const Renderer& renderer, Shader& shader, const glm::mat4& modelMatrix, const Culling::Frustum& frustum) const
+    {
+        PROFILE_SCOPE("ModelRenderer::Draw");
+
+        const SceneGraph& graph = fModel->GetSceneGraph();
+        fWorldBounds.Clear();
+        for (const auto& instance: graph.GetMeshInstances())
+            fWorldBounds.Add(CommonUtils::TransformBBox(fMeshBounds[instance.mesh], modelMatrix * graph.GetWorldTransform(instance.node)));
+
+        const size_t visible = Culling::CullAABBs(frustum, fWorldBounds, fMeshVisible);
+        renderer.CountMeshes(static_cast<unsigned int>(visible), static_cast<unsigned int>(fWorldBounds.Size() - visible));
 
-        for(int index = 0; index < fModelVA.size(); index++)
+        DrawMeshes(renderer, shader, true);
+    }
+    
+    void ModelRenderer::DrawDepth(const Renderer& renderer, Shader& shader) const
+    {
+        const SceneGraph& graph = fModel->GetSceneGraph();
+        SceneGraph::NodeID boundNode = SceneGraph::kNone;
+
+        for (const auto& instance: graph.GetMeshInstances())
         {
-            const auto& meshVA = fModelVA[index];
-            /* 1) modelMeshes.at() is not very performant. */
-            const auto& meshTextures = modelMeshes.at(index).mTextures;
-            
-            int slot = 0;
-            for (const auto& tex: meshTextures)
+            if (instance.node != boundNode)
             {
-                /* 2) if else is ughh... */
-                if(tex.type == TriangleMesh::Texture::Diffuse)
-                {
-                    /* 3) Multiple texture maps of same type for single mesh doesn't make much sense to me right now.
-                          So, I'm just dealing with one map for now. */
-                    fModelTextures[tex.indices[0]].Bind(slot);
-                    shader.SetUniform1i("u_MaterialProperty.diffuseTex", slot);
-                    ++slot;
-                }
-                else if(tex.type == TriangleMesh::Texture::Specular)
-                {
-                    fModelTextures[tex.indices[0]].Bind(slot);
-                    shader.SetUniform1i("u_MaterialProperty.specularTex", slot);
-                    ++slot;
-                }
+                shader.SetUniformMat4f("u_NodeTransform", graph.GetWorldTransform(instance.node));
+                boundNode = instance.node;
             }
-            
-            renderer.Draw(meshVA, shader);
 
-            for (const auto& tex: meshTextures)
-                fModelTextures[tex.indices[0]].Unbind();
+            renderer.Draw(fModelVA[instance.mesh], shader);
+        }
+    }
+
+    void ModelRenderer::RequestMips(const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, float pixelsPerUnit, bool culled)
+    {
+        if (!fTextureStreamer || pixelsPerUnit <= 0.0f)
+            return;
+
+        const SceneGraph& graph = fModel->GetSceneGraph();
+        const unsigned long long frame = fTextureStreamer->GetFrame();
+        for (unsigned int index = 0; index < graph.GetMeshInstances().size(); index++)
+        {
+            const unsigned int mesh = graph.GetMeshInstances()[index].mesh;
+            if ((culled && !fMeshVisible[index]) || fMeshUVDensity[mesh] <= 0.0f)
+                continue;
+
+            /* World units per local unit, the largest axis. */
+            const glm::mat4 meshMatrix = modelMatrix * graph.GetWorldTransform(graph.GetMeshInstances()[index].node);
+            const float scale = std::max({glm::length(glm::vec3(meshMatrix[0])), glm::length(glm::vec3(meshMatrix[1])), glm::length(glm::vec3(meshMatrix[2]))});
+            if (scale <= 0.0f)
+                continue;
+
+            /* The nearest point of the mesh bounds sees the most detail. */
+            CommonUtils::BBCoord bounds;
+            if (culled)
+            {
+                bounds.Min = glm::vec3(fWorldBounds.Min(0)[index], fWorldBounds.Min(1)[index], fWorldBounds.Min(2)[index]);
+                bounds.Max = glm::vec3(fWorldBounds.Max(0)[index], fWorldBounds.Max(1)[index], fWorldBounds.Max(2)[index]);
+            }
+            else
+                bounds = CommonUtils::TransformBBox(fMeshBounds[mesh], meshMatrix);
+            const float distance = std::max(glm::length(glm::clamp(cameraPosition, bounds.Min, bounds.Max) - cameraPosition), 0.1f);
+
+            /* One pixel covers distance / pixelsPerUnit world units there. */
+            const float uvPerPixel = fMeshUVDensity[mesh] / scale * distance / pixelsPerUnit;
+            fMaterials.Request(fMeshMaterials[mesh], uvPerPixel, frame);
         }
     }
+
+    void ModelRenderer::DrawMeshes(const Renderer& renderer, Shader& shader, bool culled) const
+    {
+        fMaterials.BindTable(kMaterialsSlot);
+        unsigned int binds = 1;
+
+        /* Only the material index changes between meshes, the arrays only between groups of them. */
+        MaterialTable::Arrays bound;
+        int boundMaterial = -1;
+
+        const SceneGraph& graph = fModel->GetSceneGraph();
+        SceneGraph::NodeID boundNode = SceneGraph::kNone;
+
+        for (const auto index: fMeshOrder)
+        {
+            if (culled && !fMeshVisible[index])
+                continue;
+
+            const SceneGraph::MeshInstance& instance = graph.GetMeshInstances()[index];
+            if (instance.node != boundNode)
+            {
+                shader.SetUniformMat4f("u_NodeTransform", graph.GetWorldTransform(instance.node));
+                boundNode = instance.node;
+            }
+
+            const unsigned int material = fMeshMaterials[instance.mesh];
+            const auto& arrays = fMaterials.GetArrays(material);
+            if (boundMaterial < 0 || arrays != bound)
+            {
+                fMaterials.BindArrays(arrays, kDiffuseMapsSlot, kSpecularMapsSlot);
+                bound = arrays;
+                binds += 2;
+            }
+
+            if (static_cast<int>(material) != boundMaterial)
+            {
+                shader.SetUniform1i("u_MaterialIndex", static_cast<int>(material));
+                boundMaterial = static_cast<int>(material);
+            }
+
+            renderer.Draw(fModelVA[instance.mesh], shader);
+        }
+
+        renderer.CountTextureBinds(binds);
+    }
     
     const TriangleMesh& ModelRenderer::GetTriangleMesh() const
     {
         return *fModel;
     }
+    
+    std::vector<bool> ModelRenderer::GetSRGBTextures(const TriangleMesh& model)
+    {
+        /* Diffuse maps are color, their mips are filtered as sRGB. The rest is data. */
+        std::vector<bool> srgb(model.GetTexturePaths().size(), false);
+        for (const auto& mesh: model.GetModelMesh())
+            for (const auto& texture: mesh.second.mTextures)
+                if (texture.type == TriangleMesh::Texture::Diffuse)
+                    for (const auto textureIndex: texture.indices)
+                        if (textureIndex < srgb.size())
+                            srgb[textureIndex] = true;
+        return srgb;
+    }
+
+    const std::vector<CommonUtils::BBCoord>& ModelRenderer::GetMeshBounds() const
+    {
+        return fMeshBounds;
+    }
+
+    size_t ModelRenderer::GetTextureBytes() const
+    {
+        size_t bytes = fMaterials.GetByteSize();
+        for (const auto& texture: fModelTextures)
+            bytes += texture.GetByteSize();
+        return bytes;
+    }
+
+    size_t ModelRenderer::GetUncompressedTextureBytes() const
+    {
+        size_t bytes = fMaterials.GetUncompressedByteSize();
+        for (const auto& texture: fModelTextures)
+            bytes += texture.GetUncompressedByteSize();
+        return bytes;
+    }
+
+
+    bool ModelRenderer::Intersect(const glm::vec3& origin, const glm::vec3& direction, const glm::mat4& modelMatrix, TriangleBVH::Hit& hit, unsigned int& mesh) const
+    {
+        PROFILE_SCOPE("ModelRenderer::Intersect");
+
+        if (fMeshBVHs.empty())
+        {
+            for (const auto& entry: fModel->GetModelMesh())
+                fMeshBVHs.emplace_back(entry.second, &ThreadPool::Shared());
+        }
+
+        /* One inverse per node, distances along the local ray equal those along the world ray. */
+        const SceneGraph& graph = fModel->GetSceneGraph();
+        SceneGraph::NodeID inverseNode = SceneGraph::kNone;
+        glm::vec3 localOrigin{}, localDirection{};
+
+        bool found = false;
+        for (const auto& instance: graph.GetMeshInstances())
+        {
+            if (instance.node != inverseNode)
+            {
+                const glm::mat4 inverse = glm::inverse(modelMatrix * graph.GetWorldTransform(instance.node));
+                localOrigin    = glm::vec3(inverse * glm::vec4(origin, 1.0f));
+                localDirection = glm::vec3(inverse * glm::vec4(direction, 0.0f));
+                inverseNode    = instance.node;
+            }
 
+            if (fMeshBVHs[instance.mesh].Intersect(localOrigin, localDirection, hit))
+            {
+                mesh  = instance.mesh;
+                found = true;
+            }
+        }
+
+        return found;
+    }
 }
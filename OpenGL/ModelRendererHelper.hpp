@@ -12,8 +12,11 @@
 #include "TriangleMesh.hpp"
 #include "VertexArray.hpp"
 #include "Texture.hpp"
+#include "MaterialTable.hpp"
 #include "Renderer.hpp"
 #include "Shader.hpp"
+#include "Frustum.hpp"
+#include "TriangleBVH.hpp"
 
 #include <deque>
 #include <memory>
@@ -24,17 +27,70 @@ namespace Helper
     class ModelRenderer
     {
     public:
-        ModelRenderer(const std::string& filepath);
+        /* Texture units of the material arrays and table, the shaders' u_DiffuseMaps, u_SpecularMaps and u_Materials. */
+        static constexpr unsigned int kDiffuseMapsSlot  = 0;
+        static constexpr unsigned int kSpecularMapsSlot = 1;
+        static constexpr unsigned int kMaterialsSlot    = 2;
+
+        /* With a streamer, textures load in the background and show a placeholder until then. */
+        ModelRenderer(const std::string& filepath, TextureStreamer* textureStreamer = nullptr);
+        /* A model parsed elsewhere, e.g. on a worker thread. */
+        ModelRenderer(std::unique_ptr<TriangleMesh> model, TextureStreamer* textureStreamer = nullptr);
         ~ModelRenderer();
         void Clear();
         void Import(const std::string& filepath);
+        /* Repacks the material arrays once more textures have loaded. Once per frame, before drawing. */
+        void UpdateMaterials();
+        /*
+         * World transforms of the nodes moved through GetSceneGraph. Once per frame, before drawing. True when any
+         * changed: whatever the owner derived from the model's bounds (e.g. occluders, shadows) is stale then.
+         */
+        bool UpdateTransforms();
+        /*
+         * Every mesh at each node drawing it. The shader's u_NodeTransform is set per mesh, u_Model and u_MVP of the
+         * whole model are the caller's.
+         */
         void Draw(const Renderer& renderer, Shader& shader) const;
+        /* Skips meshes whose world space bounds are outside the frustum. */
+        void Draw(const Renderer& renderer, Shader& shader, const glm::mat4& modelMatrix, const Culling::Frustum& frustum) const;
+        /* Depth only passes: every mesh with the shader as bound, no textures or material uniforms. */
+        void DrawDepth(const Renderer& renderer, Shader& shader) const;
+        /*
+         * Reports the texture detail each mesh needs to the streamer, from its UV density and distance to the camera.
+         * pixelsPerUnit is the projected size of one world unit at distance 1. With culled, only meshes the last culled
+         * Draw found visible.
+         */
+        void RequestMips(const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, float pixelsPerUnit, bool culled);
         const TriangleMesh& GetTriangleMesh() const;
+        SceneGraph& GetSceneGraph() { return fModel->GetSceneGraph(); }
+        /* Per texture path of the model, whether it holds colour (filtered as sRGB) rather than data. */
+        static std::vector<bool> GetSRGBTextures(const TriangleMesh& model);
+        const std::vector<CommonUtils::BBCoord>& GetMeshBounds() const;
+        const MaterialTable& GetMaterials() const { return fMaterials; }
+        /* GPU memory of the model's textures and material arrays, and what they would take uncompressed. */
+        size_t GetTextureBytes() const;
+        size_t GetUncompressedTextureBytes() const;
+        /* Closest triangle over all meshes, ray in world space. Triangle BVHs are built by the first call. */
+        bool Intersect(const glm::vec3& origin, const glm::vec3& direction, const glm::mat4& modelMatrix, TriangleBVH::Hit& hit, unsigned int& mesh) const;
     private:
         void Import();
+        /* Mesh instances in material order, only those marked in fMeshVisible when culled. */
+        void DrawMeshes(const Renderer& renderer, Shader& shader, bool culled) const;
+        const std::vector<SceneGraph::MeshInstance>& GetMeshInstances() const { return fModel->GetSceneGraph().GetMeshInstances(); }
         std::unique_ptr<TriangleMesh> fModel;
         std::deque<VertexArray> fModelVA;
         std::deque<Texture> fModelTextures;
+        TextureStreamer* fTextureStreamer;
+        MaterialTable fMaterials;
+        bool fMaterialsPacked = false;
+        size_t fPackedTextures = 0;                      /* Loaded textures at the last pack. */
+        std::vector<unsigned int> fMeshMaterials;
+        std::vector<unsigned int> fMeshOrder;            /* Mesh instances sharing arrays next to each other. */
+        std::vector<CommonUtils::BBCoord> fMeshBounds;   /* Local space, one per mesh. */
+        std::vector<float> fMeshUVDensity;               /* Texture coordinate units per local unit, one per mesh. */
+        mutable Culling::AABBList fWorldBounds;          /* One per mesh instance, as are the flags. */
+        mutable std::vector<unsigned char> fMeshVisible;
+        mutable std::vector<TriangleBVH> fMeshBVHs;      /* Local space, one per mesh. */
     };
 }
 
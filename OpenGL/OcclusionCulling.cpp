@@ -0,0 +1,400 @@
+//
+//  OcclusionCulling.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "OcclusionCulling.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace Culling
+{
+    Occluder MakeOccluder(const TriangleMesh& mesh)
+    {
+        Occluder occluder;
+
+        /* Every mesh where the node hierarchy puts it. */
+        const SceneGraph& graph = mesh.GetSceneGraph();
+        for (const auto& instance: graph.GetMeshInstances())
+        {
+            const auto& attributes = mesh.GetMeshAttributes(instance.mesh);
+            const glm::mat4& transform = graph.GetWorldTransform(instance.node);
+            const unsigned int base = static_cast<unsigned int>(occluder.positions.size() / 3);
+
+            for (size_t index = 0; index + 2 < attributes.mPositions.size(); index += 3)
+            {
+                const glm::vec3 position(transform * glm::vec4(attributes.mPositions[index], attributes.mPositions[index + 1], attributes.mPositions[index + 2], 1.0f));
+                occluder.positions.insert(occluder.positions.end(), {position.x, position.y, position.z});
+            }
+            for (const auto index: attributes.mIndices)
+                occluder.indices.push_back(base + index);
+        }
+
+        return occluder;
+    }
+
+    Occluder MakeSimplifiedOccluder(const TriangleMesh& mesh, unsigned int cellsPerAxis)
+    {
+        return SimplifyOccluder(MakeOccluder(mesh), cellsPerAxis);
+    }
+
+    Occluder SimplifyOccluder(const Occluder& full, unsigned int cellsPerAxis)
+    {
+        if (full.positions.empty() || cellsPerAxis == 0)
+            return full;
+
+        const CommonUtils::BBCoord bounds = CommonUtils::GetBBox(full.positions);
+        const glm::vec3 extent = glm::max(bounds.Max - bounds.Min, glm::vec3(1e-6f));
+
+        struct Cell
+        {
+            glm::vec3    sum{};
+            unsigned int count = 0;
+            unsigned int index = 0;
+        };
+
+        std::unordered_map<unsigned int, Cell> cells;
+        std::vector<unsigned int> cellOf(full.positions.size() / 3);
+
+        for (size_t vertex = 0; vertex < cellOf.size(); vertex++)
+        {
+            const glm::vec3 position(full.positions[vertex * 3 + 0], full.positions[vertex * 3 + 1], full.positions[vertex * 3 + 2]);
+            const glm::uvec3 cell = glm::min(glm::uvec3((position - bounds.Min) / extent * float(cellsPerAxis)), glm::uvec3(cellsPerAxis - 1));
+
+            cellOf[vertex] = cell.x + cell.y * cellsPerAxis + cell.z * cellsPerAxis * cellsPerAxis;
+
+            Cell& entry = cells[cellOf[vertex]];
+            entry.sum += position;
+            entry.count++;
+        }
+
+        std::vector<glm::vec3> means;
+        means.reserve(cells.size());
+        for (auto& entry: cells)
+        {
+            entry.second.index = static_cast<unsigned int>(means.size());
+            means.push_back(entry.second.sum / float(entry.second.count));
+        }
+
+        std::vector<unsigned int> triangles;
+        for (size_t index = 0; index + 2 < full.indices.size(); index += 3)
+        {
+            const unsigned int a = cells[cellOf[full.indices[index + 0]]].index;
+            const unsigned int b = cells[cellOf[full.indices[index + 1]]].index;
+            const unsigned int c = cells[cellOf[full.indices[index + 2]]].index;
+
+            if (a != b && b != c && c != a)
+                triangles.insert(triangles.end(), {a, b, c});
+        }
+
+        /*
+         * Snapping moves the surface by up to a cell diagonal either way, so the clustered mesh can stick out past
+         * the real silhouette and hide what is visible. Moving every vertex that far inward along its normal keeps
+         * it inside. Normals point out whatever the winding, the sign of the enclosed volume says which way that is.
+         */
+        auto faceNormal = [](const std::vector<glm::vec3>& vertices, const unsigned int* corners) {
+            return glm::cross(vertices[corners[1]] - vertices[corners[0]], vertices[corners[2]] - vertices[corners[0]]);
+        };
+
+        float volume = 0.0f;
+        std::vector<glm::vec3> normals(means.size(), glm::vec3(0.0f));
+        std::vector<float> areas(means.size(), 0.0f);
+        for (size_t index = 0; index < triangles.size(); index += 3)
+        {
+            const glm::vec3 normal = faceNormal(means, &triangles[index]);
+            volume += glm::dot(means[triangles[index]] - bounds.Min, normal);
+            for (int corner = 0; corner < 3; corner++)
+            {
+                normals[triangles[index + corner]] += normal;
+                areas[triangles[index + corner]]   += glm::length(normal);
+            }
+        }
+
+        const float inset = glm::length(extent / float(cellsPerAxis)) * (volume < 0.0f ? -1.0f : 1.0f);
+        std::vector<glm::vec3> shrunk(means.size());
+        for (size_t vertex = 0; vertex < means.size(); vertex++)
+        {
+            const float length = glm::length(normals[vertex]);
+            shrunk[vertex] = length > 0.0f ? means[vertex] - normals[vertex] * (inset / length) : means[vertex];
+        }
+
+        Occluder simplified;
+        for (const auto& position: shrunk)
+            simplified.positions.insert(simplified.positions.end(), {position.x, position.y, position.z});
+
+        /*
+         * Dropped: parts thinner than the inset, which turn inside out, and anything at a cell that merged opposite
+         * sides of a gap (its normals mostly cancel), which may bridge the gap.
+         */
+        auto merged = [&normals, &areas](unsigned int vertex) { return glm::length(normals[vertex]) < 0.5f * areas[vertex]; };
+        for (size_t index = 0; index < triangles.size(); index += 3)
+        {
+            const unsigned int* corners = &triangles[index];
+            if (merged(corners[0]) || merged(corners[1]) || merged(corners[2]))
+                continue;
+
+            if (glm::dot(faceNormal(shrunk, corners), faceNormal(means, corners)) > 0.0f)
+                simplified.indices.insert(simplified.indices.end(), {triangles[index], triangles[index + 1], triangles[index + 2]});
+        }
+
+        return simplified;
+    }
+
+    DepthRasterizer::DepthRasterizer(int width, int height):
+        mTilesX((std::max(width, 1) + kTileWidth - 1) / kTileWidth),
+        mTilesY((std::max(height, 1) + kTileHeight - 1) / kTileHeight)
+    {
+        mWidth  = mTilesX * kTileWidth;
+        mHeight = mTilesY * kTileHeight;
+
+        mTileBins.resize(mTilesX * mTilesY);
+        mDepth.assign(mWidth * mHeight, 1.0f);
+        mTileMaxDepth.assign(mTilesX * mTilesY, 1.0f);
+    }
+
+    void DepthRasterizer::Clear(const glm::mat4& viewProj)
+    {
+        mViewProj = viewProj;
+        mTriangles.clear();
+
+        std::fill(mDepth.begin(), mDepth.end(), 1.0f);
+        std::fill(mTileMaxDepth.begin(), mTileMaxDepth.end(), 1.0f);
+    }
+
+    void DepthRasterizer::AddOccluder(const Occluder& occluder, const glm::mat4& modelMatrix)
+    {
+        PROFILE_SCOPE("DepthRasterizer::AddOccluder");
+
+        const glm::mat4 mvp = mViewProj * modelMatrix;
+        const size_t vertexCount = occluder.positions.size() / 3;
+
+        mClipVertices.resize(vertexCount);
+        for (size_t vertex = 0; vertex < vertexCount; vertex++)
+            mClipVertices[vertex] = mvp * glm::vec4(occluder.positions[vertex * 3 + 0], occluder.positions[vertex * 3 + 1], occluder.positions[vertex * 3 + 2], 1.0f);
+
+        for (size_t index = 0; index + 2 < occluder.indices.size(); index += 3)
+        {
+            ScreenTriangle triangle;
+            bool clipped = false;
+
+            for (int corner = 0; corner < 3; corner++)
+            {
+                const glm::vec4& clip = mClipVertices[occluder.indices[index + corner]];
+                if (clip.w <= 1e-5f || clip.z < -clip.w)
+                {
+                    clipped = true;
+                    break;
+                }
+
+                const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+                triangle.vertices[corner] = glm::vec3((ndc.x * 0.5f + 0.5f) * mWidth, (ndc.y * 0.5f + 0.5f) * mHeight, ndc.z * 0.5f + 0.5f);
+            }
+
+            if (clipped)
+                continue;
+
+            const glm::vec3& a = triangle.vertices[0];
+            const glm::vec3& b = triangle.vertices[1];
+            const glm::vec3& c = triangle.vertices[2];
+
+            const float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+            if (std::fabs(area) < 1e-8f)
+                continue;
+
+            /* Both windings are occluders, the edge functions want counter clockwise. */
+            if (area < 0.0f)
+                std::swap(triangle.vertices[1], triangle.vertices[2]);
+
+            const float minX = std::min({a.x, b.x, c.x}), maxX = std::max({a.x, b.x, c.x});
+            const float minY = std::min({a.y, b.y, c.y}), maxY = std::max({a.y, b.y, c.y});
+            if (maxX < 0.0f || maxY < 0.0f || minX >= mWidth || minY >= mHeight)
+                continue;
+
+            mTriangles.push_back(triangle);
+        }
+    }
+
+    void DepthRasterizer::Rasterize(ThreadPool* pool)
+    {
+        PROFILE_SCOPE("DepthRasterizer::Rasterize");
+
+        for (auto& bin: mTileBins)
+            bin.clear();
+
+        for (unsigned int index = 0; index < mTriangles.size(); index++)
+        {
+            const auto& v = mTriangles[index].vertices;
+
+            const int minX = std::max(0, static_cast<int>(std::floor(std::min({v[0].x, v[1].x, v[2].x}))) / kTileWidth);
+            const int maxX = std::min(mTilesX - 1, static_cast<int>(std::floor(std::max({v[0].x, v[1].x, v[2].x}))) / kTileWidth);
+            const int minY = std::max(0, static_cast<int>(std::floor(std::min({v[0].y, v[1].y, v[2].y}))) / kTileHeight);
+            const int maxY = std::min(mTilesY - 1, static_cast<int>(std::floor(std::max({v[0].y, v[1].y, v[2].y}))) / kTileHeight);
+
+            for (int tileY = minY; tileY <= maxY; tileY++)
+                for (int tileX = minX; tileX <= maxX; tileX++)
+                    mTileBins[tileY * mTilesX + tileX].push_back(index);
+        }
+
+        const size_t tiles = mTileBins.size();
+        if (pool)
+            pool->ParallelFor(tiles, 4, [this](size_t begin, size_t end) { for (size_t tile = begin; tile < end; tile++) RasterizeTile(static_cast<int>(tile)); });
+        else
+            for (size_t tile = 0; tile < tiles; tile++)
+                RasterizeTile(static_cast<int>(tile));
+    }
+
+    void DepthRasterizer::RasterizeTile(int tile)
+    {
+        const int tileX = (tile % mTilesX) * kTileWidth;
+        const int tileY = (tile / mTilesX) * kTileHeight;
+        float* depth = &mDepth[tile * kTileWidth * kTileHeight];
+
+        for (const unsigned int index: mTileBins[tile])
+        {
+            const glm::vec3* v = mTriangles[index].vertices;
+
+            /* Edge i goes from v[i] to v[i + 1], inside is E(x, y) = A x + B y + C >= 0 for all three. */
+            float A[3], B[3], C[3];
+            for (int edge = 0; edge < 3; edge++)
+            {
+                const glm::vec3& from = v[edge];
+                const glm::vec3& to   = v[(edge + 1) % 3];
+                A[edge] = from.y - to.y;
+                B[edge] = to.x - from.x;
+                C[edge] = -(A[edge] * from.x + B[edge] * from.y);
+            }
+
+            /* Depth is linear in screen space: z = z0 + dzdx (x - x0) + dzdy (y - y0). */
+            const float dx1 = v[1].x - v[0].x, dy1 = v[1].y - v[0].y, dz1 = v[1].z - v[0].z;
+            const float dx2 = v[2].x - v[0].x, dy2 = v[2].y - v[0].y, dz2 = v[2].z - v[0].z;
+            const float area = dx1 * dy2 - dy1 * dx2;
+            const float dzdx = (dz1 * dy2 - dy1 * dz2) / area;
+            const float dzdy = (dx1 * dz2 - dz1 * dx2) / area;
+            const float zC   = v[0].z - dzdx * v[0].x - dzdy * v[0].y;
+
+            const int minX = std::max(tileX, static_cast<int>(std::floor(std::min({v[0].x, v[1].x, v[2].x}))));
+            const int maxX = std::min(tileX + kTileWidth - 1, static_cast<int>(std::floor(std::max({v[0].x, v[1].x, v[2].x}))));
+            const int minY = std::max(tileY, static_cast<int>(std::floor(std::min({v[0].y, v[1].y, v[2].y}))));
+            const int maxY = std::min(tileY + kTileHeight - 1, static_cast<int>(std::floor(std::max({v[0].y, v[1].y, v[2].y}))));
+
+            /* Rows start on a multiple of 4 inside the tile, so the SIMD loads stay in bounds. */
+            const int startX = tileX + ((minX - tileX) & ~3);
+
+            for (int y = minY; y <= maxY; y++)
+            {
+                const float py = y + 0.5f;
+                float* row = depth + (y - tileY) * kTileWidth - tileX;
+
+#if defined(__SSE2__)
+                const __m128 e0Row = _mm_set1_ps(B[0] * py + C[0]);
+                const __m128 e1Row = _mm_set1_ps(B[1] * py + C[1]);
+                const __m128 e2Row = _mm_set1_ps(B[2] * py + C[2]);
+                const __m128 zRow  = _mm_set1_ps(dzdy * py + zC);
+                const __m128 zero  = _mm_setzero_ps();
+
+                for (int x = startX; x <= maxX; x += 4)
+                {
+                    const __m128 px = _mm_add_ps(_mm_set1_ps(x + 0.5f), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+
+                    const __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A[0]), px), e0Row);
+                    const __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A[1]), px), e1Row);
+                    const __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A[2]), px), e2Row);
+                    const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+                    if (_mm_movemask_ps(inside) == 0)
+                        continue;
+
+                    const __m128 z       = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(dzdx), px), zRow);
+                    const __m128 current = _mm_loadu_ps(row + x);
+                    const __m128 closer  = _mm_min_ps(current, z);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, current)));
+                }
+#else
+                /* Same evaluation order as the SSE path, both give identical depth. */
+                for (int x = startX; x <= maxX; x++)
+                {
+                    const float px = x + 0.5f;
+                    if (A[0] * px + (B[0] * py + C[0]) >= 0.0f && A[1] * px + (B[1] * py + C[1]) >= 0.0f && A[2] * px + (B[2] * py + C[2]) >= 0.0f)
+                        row[x] = std::min(row[x], dzdx * px + (dzdy * py + zC));
+                }
+#endif
+            }
+        }
+
+        mTileMaxDepth[tile] = *std::max_element(depth, depth + kTileWidth * kTileHeight);
+    }
+
+    bool DepthRasterizer::IsVisible(const CommonUtils::BBCoord& worldBox) const
+    {
+        glm::vec2 minScreen(std::numeric_limits<float>::max());
+        glm::vec2 maxScreen(-std::numeric_limits<float>::max());
+        float minDepth = std::numeric_limits<float>::max();
+
+        for (int corner = 0; corner < 8; corner++)
+        {
+            const glm::vec3 position(corner & 1 ? worldBox.Max.x : worldBox.Min.x,
+                                     corner & 2 ? worldBox.Max.y : worldBox.Min.y,
+                                     corner & 4 ? worldBox.Max.z : worldBox.Min.z);
+            const glm::vec4 clip = mViewProj * glm::vec4(position, 1.0f);
+
+            /* Box reaches the camera plane, can't say anything. */
+            if (clip.w <= 1e-5f || clip.z < -clip.w)
+                return true;
+
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            const glm::vec2 screen((ndc.x * 0.5f + 0.5f) * mWidth, (ndc.y * 0.5f + 0.5f) * mHeight);
+
+            minScreen = glm::min(minScreen, screen);
+            maxScreen = glm::max(maxScreen, screen);
+            minDepth  = std::min(minDepth, ndc.z * 0.5f + 0.5f);
+        }
+
+        if (maxScreen.x < 0.0f || maxScreen.y < 0.0f || minScreen.x >= mWidth || minScreen.y >= mHeight)
+            return false;
+
+        const int minX = std::max(0, static_cast<int>(std::floor(minScreen.x)));
+        const int maxX = std::min(mWidth - 1, static_cast<int>(std::floor(maxScreen.x)));
+        const int minY = std::max(0, static_cast<int>(std::floor(minScreen.y)));
+        const int maxY = std::min(mHeight - 1, static_cast<int>(std::floor(maxScreen.y)));
+
+        for (int tileY = minY / kTileHeight; tileY <= maxY / kTileHeight; tileY++)
+        {
+            for (int tileX = minX / kTileWidth; tileX <= maxX / kTileWidth; tileX++)
+            {
+                const int tile = tileY * mTilesX + tileX;
+
+                /* Everything in this tile is closer than the box. */
+                if (mTileMaxDepth[tile] < minDepth)
+                    continue;
+
+                const float* depth = &mDepth[tile * kTileWidth * kTileHeight];
+                const int x0 = std::max(minX, tileX * kTileWidth),  x1 = std::min(maxX, tileX * kTileWidth + kTileWidth - 1);
+                const int y0 = std::max(minY, tileY * kTileHeight), y1 = std::min(maxY, tileY * kTileHeight + kTileHeight - 1);
+
+                for (int y = y0; y <= y1; y++)
+                    for (int x = x0; x <= x1; x++)
+                        if (depth[(y - tileY * kTileHeight) * kTileWidth + (x - tileX * kTileWidth)] >= minDepth)
+                            return true;
+            }
+        }
+
+        return false;
+    }
+
+    float DepthRasterizer::GetDepth(int x, int y) const
+    {
+        const int tile = (y / kTileHeight) * mTilesX + (x / kTileWidth);
+        return mDepth[tile * kTileWidth * kTileHeight + (y % kTileHeight) * kTileWidth + (x % kTileWidth)];
+    }
+}
@@ -0,0 +1,90 @@
+//
+//  OcclusionCulling.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef OcclusionCulling_hpp
+#define OcclusionCulling_hpp
+
+#include "CommonUtils.hpp"
+#include "TriangleMesh.hpp"
+
+#include <vector>
+
+class ThreadPool;
+
+namespace Culling
+{
+    /* Occluder geometry in model space, triangle list. */
+    struct Occluder
+    {
+        std::vector<float>        positions;
+        std::vector<unsigned int> indices;
+    };
+
+    /* All meshes of the model where its nodes put them, for models that are already low poly. */
+    Occluder MakeOccluder(const TriangleMesh& mesh);
+
+    /*
+     * Vertex clustering LOD: vertices snap to the mean of their cell on a cellsPerAxis^3 grid, collapsed
+     * triangles are dropped. Then shrunk inward by a cell diagonal and cells merging across gaps dropped,
+     * so it stays inside the real silhouette.
+     * Needs a closed mesh (one that encloses a volume), as occluders should be anyway.
+     */
+    Occluder MakeSimplifiedOccluder(const TriangleMesh& mesh, unsigned int cellsPerAxis);
+    Occluder SimplifyOccluder(const Occluder& full, unsigned int cellsPerAxis);
+
+    /*
+     * Small software depth buffer for occlusion culling. Occluders are binned into tiles and rasterized tile
+     * by tile in parallel, 4 pixels at a time (SSE). Each tile keeps its farthest depth, so most box tests are
+     * decided per tile without touching pixels. Depth is NDC z mapped to [0, 1], smaller is closer.
+     */
+    class DepthRasterizer
+    {
+    public:
+        static constexpr int kTileWidth  = 32;
+        static constexpr int kTileHeight = 16;
+
+        /* Rounded up to whole tiles. */
+        DepthRasterizer(int width = 320, int height = 192);
+
+        void Clear(const glm::mat4& viewProj);
+        /* Triangles crossing the near plane are skipped, that only makes the result more conservative. */
+        void AddOccluder(const Occluder& occluder, const glm::mat4& modelMatrix);
+        /* Bins and rasterizes everything added since Clear. pool may be null. */
+        void Rasterize(ThreadPool* pool);
+
+        /* False only if every pixel the box covers is behind an occluder. */
+        bool IsVisible(const CommonUtils::BBCoord& worldBox) const;
+
+        int GetWidth() const { return mWidth; }
+        int GetHeight() const { return mHeight; }
+        size_t GetTriangleCount() const { return mTriangles.size(); }
+        float GetDepth(int x, int y) const;
+
+    private:
+        struct ScreenTriangle
+        {
+            glm::vec3 vertices[3];      /* Pixels x, y and depth. Counter clockwise. */
+        };
+
+        void RasterizeTile(int tile);
+
+        int mWidth;
+        int mHeight;
+        int mTilesX;
+        int mTilesY;
+
+        glm::mat4                              mViewProj{1.0f};
+        std::vector<ScreenTriangle>            mTriangles;
+        std::vector<std::vector<unsigned int>> mTileBins;
+        std::vector<float>                     mDepth;          /* Tile major, kTileWidth * kTileHeight per tile. */
+        std::vector<float>                     mTileMaxDepth;
+        std::vector<glm::vec4>                 mClipVertices;   /* Scratch for AddOccluder. */
+    };
+}
+
+#endif /* OcclusionCulling_hpp */
@@ -0,0 +1,139 @@
+//
+//  OcclusionQuery.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "OcclusionQuery.hpp"
+#include "ErrorHandler.hpp"
+
+namespace
+{
+    /* "Any samples" lets the GPU stop counting early, GL 3.3 or ARB_occlusion_query2. */
+    GLenum QueryTarget()
+    {
+        return (GLEW_VERSION_3_3 || GLEW_ARB_occlusion_query2) ? GL_ANY_SAMPLES_PASSED : GL_SAMPLES_PASSED;
+    }
+}
+
+OcclusionQuery::OcclusionQuery()
+{
+    GLCall(glGenQueries(1, &mRendererId));
+}
+
+OcclusionQuery::~OcclusionQuery()
+{
+    GLCall(glDeleteQueries(1, &mRendererId));
+}
+
+void OcclusionQuery::Begin()
+{
+    ASSERT(!mPending);
+    GLCall(glBeginQuery(QueryTarget(), mRendererId));
+    mPending = true;
+}
+
+void OcclusionQuery::End() const
+{
+    GLCall(glEndQuery(QueryTarget()));
+}
+
+bool OcclusionQuery::Poll()
+{
+    if (!mPending)
+        return false;
+
+    GLuint available = 0;
+    GLCall(glGetQueryObjectuiv(mRendererId, GL_QUERY_RESULT_AVAILABLE, &available));
+    if (!available)
+        return false;
+
+    GLuint samples = 0;
+    GLCall(glGetQueryObjectuiv(mRendererId, GL_QUERY_RESULT, &samples));
+
+    mVisible = samples != 0;
+    mPending = false;
+    return true;
+}
+
+void OcclusionQuery::BeginConditionalRender() const
+{
+    GLCall(glBeginConditionalRender(mRendererId, GL_QUERY_NO_WAIT));
+}
+
+void OcclusionQuery::EndConditionalRender() const
+{
+    GLCall(glEndConditionalRender());
+}
+
+GpuTimer::GpuTimer()
+{
+    if (IsSupported())
+    {
+        GLCall(glGenQueries(2 * kLatency, mQueries[0]));
+    }
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (IsSupported())
+    {
+        GLCall(glDeleteQueries(2 * kLatency, mQueries[0]));
+    }
+}
+
+bool GpuTimer::IsSupported()
+{
+    return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+}
+
+void GpuTimer::Collect()
+{
+    /* mCurrent is the oldest slot. Oldest first, so the newest finished one wins. */
+    for (int offset = 0; offset < kLatency; offset++)
+    {
+        const int slot = (mCurrent + offset) % kLatency;
+        if (!mIssued[slot])
+            continue;
+
+        GLuint available = 0;
+        GLCall(glGetQueryObjectuiv(mQueries[slot][1], GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available)
+            continue;
+
+        GLuint64 start = 0, end = 0;
+        GLCall(glGetQueryObjectui64v(mQueries[slot][0], GL_QUERY_RESULT, &start));
+        GLCall(glGetQueryObjectui64v(mQueries[slot][1], GL_QUERY_RESULT, &end));
+
+        mMilliseconds = static_cast<float>((end - start) / 1e6);
+        mIssued[slot] = false;
+    }
+}
+
+void GpuTimer::Begin()
+{
+    if (!IsSupported())
+        return;
+
+    Collect();
+
+    /* All slots still in flight, skip this frame rather than wait. */
+    if (mIssued[mCurrent])
+        return;
+
+    GLCall(glQueryCounter(mQueries[mCurrent][0], GL_TIMESTAMP));
+    mRunning = true;
+}
+
+void GpuTimer::End()
+{
+    if (!mRunning)
+        return;
+
+    GLCall(glQueryCounter(mQueries[mCurrent][1], GL_TIMESTAMP));
+    mIssued[mCurrent] = true;
+    mCurrent = (mCurrent + 1) % kLatency;
+    mRunning = false;
+}
@@ -0,0 +1,78 @@
+//
+//  OcclusionQuery.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef OcclusionQuery_hpp
+#define OcclusionQuery_hpp
+
+/*
+ * Hardware occlusion query. Results are only read once the GPU reports them available, so the CPU never
+ * waits; the last known answer is kept in between. Conditional rendering lets the GPU itself skip a draw
+ * when the latest query found no samples.
+ */
+class OcclusionQuery
+{
+private:
+    unsigned int mRendererId;
+    bool         mPending = false;
+    bool         mVisible = true;
+
+public:
+    OcclusionQuery();
+    ~OcclusionQuery();
+
+    OcclusionQuery(const OcclusionQuery&) = delete;
+    OcclusionQuery& operator=(const OcclusionQuery&) = delete;
+
+    void Begin();
+    void End() const;
+
+    /* True when a new result arrived. */
+    bool Poll();
+
+    bool IsPending() const { return mPending; }
+    bool WasVisible() const { return mVisible; }
+
+    /* Draws in between are dropped by the GPU if the query found nothing. Never waits for the result. */
+    void BeginConditionalRender() const;
+    void EndConditionalRender() const;
+};
+
+/*
+ * GPU time of a block of work, read a few frames later so nothing stalls. Timestamps rather than GL_TIME_ELAPSED,
+ * so timers can nest (scene time around shadow pass time).
+ */
+class GpuTimer
+{
+private:
+    static constexpr int kLatency = 4;
+
+    unsigned int mQueries[kLatency][2];     /* Start and end timestamp. */
+    bool         mIssued[kLatency] = {};
+    int          mCurrent = 0;
+    bool         mRunning = false;
+    float        mMilliseconds = 0.0f;
+
+    void Collect();
+
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void Begin();
+    void End();
+
+    /* Latest finished measurement. */
+    float GetMilliseconds() const { return mMilliseconds; }
+
+    static bool IsSupported();
+};
+
+#endif /* OcclusionQuery_hpp */
@@ -0,0 +1,200 @@
+//
+//  PixelReadback.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "PixelReadback.hpp"
+#include "ErrorHandler.hpp"
+#include "ImageWriter.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+PixelReadback::PixelReadback(ThreadPool& pool, int ringSize): PixelReadback(ringSize)
+{
+    mPool = &pool;
+}
+
+PixelReadback::PixelReadback(int ringSize): mPool(nullptr), mSlots(std::max(1, ringSize))
+{
+    for (auto& slot: mSlots)
+    {
+        GLCall(glGenBuffers(1, &slot.buffer));
+        slot.resource = GLResources::Register(GLResources::Type::Buffer, slot.buffer, 0, "readback ring", GL_RESOURCE_SITE);
+    }
+}
+
+PixelReadback::~PixelReadback()
+{
+    Flush();
+
+    for (auto& slot: mSlots)
+    {
+        GLCall(glDeleteBuffers(1, &slot.buffer));
+        GLResources::Release(slot.resource);
+    }
+}
+
+bool PixelReadback::Read(unsigned int framebuffer, int width, int height, int channels, unsigned long long frame, const Callback& callback)
+{
+    PROFILE_FUNCTION();
+
+    Slot& slot = mSlots[mNextSlot];
+    if (slot.fence)
+    {
+        mDropped++;
+        return false;
+    }
+    mNextSlot = (mNextSlot + 1) % mSlots.size();
+
+    const size_t bytes = static_cast<size_t>(width) * height * channels;
+    int previousFramebuffer = 0;
+    GLCall(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousFramebuffer));
+    GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer));
+    GLCall(glReadBuffer(framebuffer ? GL_COLOR_ATTACHMENT0 : GL_BACK));
+
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer));
+    if (bytes > slot.capacity)
+    {
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ));
+        slot.capacity = bytes;
+        GLResources::SetByteSize(slot.resource, bytes);
+    }
+
+    /* Into the buffer, glReadPixels returns as soon as the copy is queued. */
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GLCall(glReadPixels(0, 0, width, height, channels == 4 ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, nullptr));
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, previousFramebuffer));
+
+    slot.fence    = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.image    = Image{width, height, channels, frame, {}};
+    slot.callback = callback;
+    slot.updates  = 0;
+    return true;
+}
+
+void PixelReadback::Update()
+{
+    PROFILE_FUNCTION();
+
+    /* Oldest first, and none past one still in flight: callbacks without a pool promise read order. */
+    bool waiting = false;
+    for (size_t index = 0; index < mSlots.size(); index++)
+    {
+        Slot& slot = mSlots[(mNextSlot + index) % mSlots.size()];
+        if (!slot.fence)
+            continue;
+
+        slot.updates++;
+        if (waiting)
+            continue;
+
+        /* Never blocks, the flush makes sure the fence gets to the GPU at all. */
+        const GLenum status = glClientWaitSync(static_cast<GLsync>(slot.fence), GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+            Collect(slot);
+        else
+            waiting = true;
+    }
+
+    mWork.erase(std::remove_if(mWork.begin(), mWork.end(), [](const std::future<void>& work) {
+        return work.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), mWork.end());
+}
+
+void PixelReadback::Flush()
+{
+    PROFILE_FUNCTION();
+
+    for (size_t index = 0; index < mSlots.size(); index++)
+    {
+        /* Oldest first. */
+        Slot& slot = mSlots[(mNextSlot + index) % mSlots.size()];
+        if (!slot.fence)
+            continue;
+
+        glClientWaitSync(static_cast<GLsync>(slot.fence), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        Collect(slot);
+    }
+
+    for (auto& work: mWork)
+        work.wait();
+    mWork.clear();
+}
+
+void PixelReadback::Collect(Slot& slot)
+{
+    PROFILE_FUNCTION();
+
+    glDeleteSync(static_cast<GLsync>(slot.fence));
+    slot.fence = nullptr;
+
+    Image image = std::move(slot.image);
+    const size_t bytes = static_cast<size_t>(image.width) * image.height * image.channels;
+    image.pixels.resize(bytes);
+
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer));
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+    if (mapped)
+        std::memcpy(image.pixels.data(), mapped, bytes);
+    GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    mCompleted++;
+    mLatencySum += slot.updates;
+
+    /* GL rows start at the bottom, flipped on the worker with the rest of the work. */
+    Callback callback = std::move(slot.callback);
+    slot.callback = nullptr;
+    auto deliver = [image = std::move(image), callback]() mutable {
+        PROFILE_SCOPE("PixelReadback::Deliver");
+        const size_t stride = static_cast<size_t>(image.width) * image.channels;
+        std::vector<unsigned char> row(stride);
+        for (int y = 0; y < image.height / 2; y++)
+        {
+            unsigned char* top    = image.pixels.data() + y * stride;
+            unsigned char* bottom = image.pixels.data() + (image.height - 1 - y) * stride;
+            std::memcpy(row.data(), top, stride);
+            std::memcpy(top, bottom, stride);
+            std::memcpy(bottom, row.data(), stride);
+        }
+
+        if (callback)
+            callback(image);
+    };
+
+    /* A pool without workers (one core) would never get to it, as in TextureStreamer. */
+    if (mPool && mPool->GetThreadCount() > 0)
+        mWork.push_back(mPool->Enqueue(std::move(deliver)));
+    else
+        deliver();
+}
+
+size_t PixelReadback::GetPendingCount() const
+{
+    return std::count_if(mSlots.begin(), mSlots.end(), [](const Slot& slot) { return slot.fence != nullptr; });
+}
+
+PixelReadback::Callback PixelReadback::SavePNG(const std::string& path)
+{
+    return [path](const Image& image) {
+        if (!ImageWriter::WritePNG(path, image.pixels.data(), image.width, image.height, image.channels))
+            std::cout << "Failed to write " << path << std::endl;
+    };
+}
+
+PixelReadback::Callback PixelReadback::SaveRaw(const std::string& path)
+{
+    return [path](const Image& image) {
+        if (!ImageWriter::WriteRaw(path, image.pixels.data(), image.width, image.height, image.channels))
+            std::cout << "Failed to write " << path << std::endl;
+    };
+}
@@ -0,0 +1,90 @@
+//
+//  PixelReadback.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef PixelReadback_hpp
+#define PixelReadback_hpp
+
+#include "GLResources.hpp"
+
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/*
+ * Framebuffer pixels read back without waiting on the GPU. Read queues a glReadPixels into the next of a ring of
+ * pixel pack buffers and fences it; Update, once a frame, maps the buffers whose fence has signalled (usually a
+ * frame or two later), copies the pixels out and hands them to the callback on a worker, where encoding and file
+ * writes happen. A Read finding every buffer still in flight is dropped rather than stalling the frame.
+ */
+class PixelReadback
+{
+public:
+    struct Image
+    {
+        int                        width = 0;
+        int                        height = 0;
+        int                        channels = 0;
+        unsigned long long         frame = 0;       /* As passed to Read. */
+        std::vector<unsigned char> pixels;          /* Top row first. */
+    };
+
+    /* No GL, on a pool worker unless constructed without a pool or the pool has no workers. May take the pixels. */
+    using Callback = std::function<void(Image&)>;
+
+    explicit PixelReadback(ThreadPool& pool, int ringSize = 3);
+    /* Callbacks run in order on the thread calling Update or Flush, for consumers with a thread of their own. */
+    explicit PixelReadback(int ringSize = 3);
+    ~PixelReadback();
+
+    PixelReadback(const PixelReadback&) = delete;
+    PixelReadback& operator=(const PixelReadback&) = delete;
+
+    /* Colour attachment 0 of the framebuffer (0 for the window), 3 or 4 channels. False when dropped. */
+    bool Read(unsigned int framebuffer, int width, int height, int channels, unsigned long long frame, const Callback& callback);
+    /* Collects the reads the GPU has finished. */
+    void Update();
+    /* Waits for every read in flight and its callback. */
+    void Flush();
+
+    /* Callbacks writing the image to path. */
+    static Callback SavePNG(const std::string& path);
+    static Callback SaveRaw(const std::string& path);
+
+    size_t GetPendingCount() const;
+    size_t GetCompletedCount() const { return mCompleted; }
+    size_t GetDroppedCount() const { return mDropped; }
+    /* Update calls between a Read and its pixels being copied out, averaged over the completed reads. */
+    double GetAverageLatency() const { return mCompleted ? static_cast<double>(mLatencySum) / mCompleted : 0.0; }
+
+private:
+    struct Slot
+    {
+        unsigned int        buffer = 0;
+        GLResources::Handle resource = 0;
+        size_t              capacity = 0;
+        void*               fence = nullptr;        /* GLsync, null when the slot is free. */
+        Image               image;                  /* Everything but the pixels, until they are copied. */
+        Callback            callback;
+        size_t              updates = 0;            /* Update calls since the Read. */
+    };
+
+    void Collect(Slot& slot);
+
+    ThreadPool*                    mPool;
+    std::vector<Slot>              mSlots;
+    size_t                         mNextSlot = 0;
+    std::vector<std::future<void>> mWork;
+    size_t                         mCompleted = 0;
+    size_t                         mDropped = 0;
+    size_t                         mLatencySum = 0;
+};
+
+#endif /* PixelReadback_hpp */
@@ -0,0 +1,162 @@
+//
+//  Profiler.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "Profiler.hpp"
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Profiler
+{
+    namespace
+    {
+        const auto kEpoch = std::chrono::steady_clock::now();
+
+        /* Buffers are never freed, so zones of finished threads can still be dumped. */
+        std::mutex                                 gRegistryMutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> gThreadBuffers;
+
+        std::mutex  gAutoDumpMutex;
+        std::string gAutoDumpPath;
+        float       gAutoDumpSeconds = -1.0f;
+        bool        gAutoDumpDone    = false;
+
+        ThreadBuffer* RegisterThread()
+        {
+            std::lock_guard<std::mutex> lock(gRegistryMutex);
+            gThreadBuffers.emplace_back(std::make_unique<ThreadBuffer>());
+            gThreadBuffers.back()->threadID = static_cast<unsigned int>(gThreadBuffers.size() - 1);
+            return gThreadBuffers.back().get();
+        }
+
+        /* Copies the zones of one buffer, dropping any that the owner overwrote or was writing while we read. */
+        void CollectBufferZones(const ThreadBuffer& buffer, std::vector<Zone>& out)
+        {
+            const std::uint64_t head  = buffer.head.load(std::memory_order_acquire);
+            const std::uint64_t count = std::min<std::uint64_t>(head, ThreadBuffer::kCapacity);
+
+            for (std::uint64_t index = head - count; index < head; index++)
+            {
+                const ThreadBuffer::Slot& slot = buffer.slots[index & (ThreadBuffer::kCapacity - 1)];
+                /* Holding exactly this zone, not a later one through the same slot. */
+                const std::uint64_t expected = 2 * (index / ThreadBuffer::kCapacity + 1);
+
+                if (slot.sequence.load(std::memory_order_acquire) != expected)
+                    continue;
+
+                const Zone zone{slot.name.load(std::memory_order_relaxed), slot.startNs.load(std::memory_order_relaxed),
+                                slot.endNs.load(std::memory_order_relaxed)};
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == expected)
+                    out.push_back(zone);
+            }
+        }
+
+        void WriteEscaped(std::ostream& stream, const char* text)
+        {
+            for (; *text; ++text)
+            {
+                if (*text == '"' || *text == '\\')
+                    stream << '\\';
+                stream << *text;
+            }
+        }
+    }
+
+    std::uint64_t NowNs()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kEpoch).count());
+    }
+
+    ThreadBuffer& GetThreadBuffer()
+    {
+        thread_local ThreadBuffer* buffer = RegisterThread();
+        return *buffer;
+    }
+
+    std::vector<Zone> CollectZones()
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+
+        std::vector<Zone> zones;
+        for (const auto& buffer: gThreadBuffers)
+            CollectBufferZones(*buffer, zones);
+
+        return zones;
+    }
+
+    bool DumpChromeTrace(const std::string& path)
+    {
+        std::ofstream stream(path);
+        if (!stream.good())
+        {
+            std::cout << "Profiler: can't open " << path << std::endl;
+            return false;
+        }
+
+        std::vector<const ThreadBuffer*> buffers;
+        {
+            std::lock_guard<std::mutex> lock(gRegistryMutex);
+            for (const auto& buffer: gThreadBuffers)
+                buffers.push_back(buffer.get());
+        }
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool first = true;
+        std::vector<Zone> zones;
+        for (const ThreadBuffer* buffer: buffers)
+        {
+            stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadID
+                   << ",\"args\":{\"name\":\"" << (buffer->threadID == 0 ? "Main" : "Worker") << " " << buffer->threadID << "\"}}";
+            first = false;
+
+            zones.clear();
+            CollectBufferZones(*buffer, zones);
+
+            for (const Zone& zone: zones)
+            {
+                stream << ",\n{\"name\":\"";
+                WriteEscaped(stream, zone.name);
+                stream << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadID
+                       << ",\"ts\":" << zone.startNs / 1000.0
+                       << ",\"dur\":" << (zone.endNs - zone.startNs) / 1000.0 << "}";
+            }
+        }
+
+        stream << "\n]}\n";
+        std::cout << "Profiler: trace written to " << path << std::endl;
+        return true;
+    }
+
+    void SetAutoDump(float seconds, const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(gAutoDumpMutex);
+        gAutoDumpSeconds = seconds;
+        gAutoDumpPath    = path;
+        gAutoDumpDone    = false;
+    }
+
+    void Update()
+    {
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(gAutoDumpMutex);
+            if (gAutoDumpDone || gAutoDumpSeconds < 0.0f || NowNs() < static_cast<std::uint64_t>(gAutoDumpSeconds * 1e9))
+                return;
+
+            gAutoDumpDone = true;
+            path = gAutoDumpPath;
+        }
+
+        DumpChromeTrace(path);
+    }
+}
@@ -0,0 +1,111 @@
+//
+//  Profiler.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef Profiler_hpp
+#define Profiler_hpp
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Scoped CPU zones. Every thread records into its own ring buffer, so the hot path is two clock reads and
+ * a handful of uncontended stores. Zones compile out entirely unless ENABLE_PROFILER is defined (Debug config does it).
+ * Zone names must outlive the profiler, use string literals.
+ */
+#ifdef ENABLE_PROFILER
+    #define PROFILE_CONCAT_IMPL(a, b) a##b
+    #define PROFILE_CONCAT(a, b)      PROFILE_CONCAT_IMPL(a, b)
+    #define PROFILE_SCOPE(name)       Profiler::ScopedZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+    #define PROFILE_FUNCTION()        PROFILE_SCOPE(__func__)
+#else
+    #define PROFILE_SCOPE(name)
+    #define PROFILE_FUNCTION()
+#endif
+
+namespace Profiler
+{
+    struct Zone
+    {
+        const char*   name;
+        std::uint64_t startNs;
+        std::uint64_t endNs;
+    };
+
+    /* Single producer (owning thread), any consumer. Oldest zones get overwritten when full. */
+    struct ThreadBuffer
+    {
+        static constexpr std::size_t kCapacity = 1 << 16;
+
+        /* Seqlock: odd while the owner writes, the n-th zone through a slot leaves it at 2n. */
+        struct Slot
+        {
+            std::atomic<std::uint64_t> sequence{0};
+            std::atomic<const char*>   name{nullptr};
+            std::atomic<std::uint64_t> startNs{0};
+            std::atomic<std::uint64_t> endNs{0};
+        };
+
+        std::array<Slot, kCapacity> slots;
+        std::atomic<std::uint64_t>  head{0};
+        unsigned int                threadID{};
+
+        void Record(const char* name, std::uint64_t startNs, std::uint64_t endNs)
+        {
+            const std::uint64_t index = head.load(std::memory_order_relaxed);
+            Slot& slot = slots[index & (kCapacity - 1)];
+            const std::uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+
+            slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.name.store(name, std::memory_order_relaxed);
+            slot.startNs.store(startNs, std::memory_order_relaxed);
+            slot.endNs.store(endNs, std::memory_order_relaxed);
+            slot.sequence.store(sequence + 2, std::memory_order_release);
+
+            head.store(index + 1, std::memory_order_release);
+        }
+    };
+
+    std::uint64_t NowNs();
+    ThreadBuffer& GetThreadBuffer();
+
+    class ScopedZone
+    {
+    public:
+        explicit ScopedZone(const char* name): mName(name), mStartNs(NowNs()) {}
+        ~ScopedZone()
+        {
+            GetThreadBuffer().Record(mName, mStartNs, NowNs());
+        }
+
+        ScopedZone(const ScopedZone&) = delete;
+        ScopedZone& operator=(const ScopedZone&) = delete;
+
+    private:
+        const char*   mName;
+        std::uint64_t mStartNs;
+    };
+
+    /* Zones still held in the ring buffers of all threads. */
+    std::vector<Zone> CollectZones();
+
+    /* Writes every zone still held in the ring buffers as Chrome trace JSON (chrome://tracing, Perfetto). */
+    bool DumpChromeTrace(const std::string& path);
+
+    /* Dumps once, the first time Update() sees `seconds` elapsed since startup. */
+    void SetAutoDump(float seconds, const std::string& path);
+
+    /* Call once per frame. */
+    void Update();
+}
+
+#endif /* Profiler_hpp */
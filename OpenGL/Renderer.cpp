@@ -15,6 +15,9 @@ void Renderer::Draw(const VertexArray& va, const Shader& shader) const
     ASSERT(va.GetIndicesCount() != 0);
     
     GLCall(glDrawElements(GL_TRIANGLES, va.GetIndicesCount(), GL_UNSIGNED_INT, nullptr));
+
+    mStats.drawCalls++;
+    mStats.triangles += va.GetIndicesCount() / 3;
 }
 
 void Renderer::EnableDepth(GLenum depthType) const
@@ -16,10 +16,38 @@
 class Renderer
 {
 public:
+    struct Stats
+    {
+        unsigned int       drawCalls{};
+        unsigned long long triangles{};
+        unsigned int       objectsVisible{};
+        unsigned int       objectsCulled{};
+        unsigned int       objectsOccluded{};   /* Passed the frustum test, hidden behind occluders. */
+        unsigned int       meshesVisible{};
+        unsigned int       meshesCulled{};
+        unsigned int       occlusionQueries{};
+        unsigned int       conditionalDraws{};
+        unsigned int       shadowCascades{};    /* Re-rendered this frame, the rest came from the cache. */
+        unsigned int       textureBinds{};      /* Material arrays and tables. */
+    };
+
     void Clear() const;
     void EnableDepth(GLenum depthType) const;
     void DisableDepth() const;
     void EnableBlend() const;
     void Draw(const VertexArray& va, const Shader& shader ) const;
+
+    /* Counters since the last reset, call ResetStats() once per frame. */
+    const Stats& GetStats() const { return mStats; }
+    void ResetStats() { mStats = {}; }
+    void CountObjects(unsigned int visible, unsigned int culled) const { mStats.objectsVisible += visible; mStats.objectsCulled += culled; }
+    void CountOccluded(unsigned int occluded) const { mStats.objectsOccluded += occluded; }
+    void CountQueries(unsigned int queries, unsigned int conditional) const { mStats.occlusionQueries += queries; mStats.conditionalDraws += conditional; }
+    void CountShadowCascades(unsigned int rendered) const { mStats.shadowCascades += rendered; }
+    void CountMeshes(unsigned int visible, unsigned int culled) const  { mStats.meshesVisible  += visible; mStats.meshesCulled  += culled; }
+    void CountTextureBinds(unsigned int binds) const { mStats.textureBinds += binds; }
+
+private:
+    mutable Stats mStats;
 };
 #endif /* Renderer_hpp */
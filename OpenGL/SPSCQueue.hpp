@@ -0,0 +1,72 @@
+//
+//  SPSCQueue.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef SPSCQueue_hpp
+#define SPSCQueue_hpp
+
+#include <atomic>
+#include <vector>
+
+/*
+ * Bounded lock-free FIFO between exactly one producer thread and one consumer thread. Neither side ever blocks, a
+ * full or empty queue is reported and the caller decides whether to wait, drop or do something else meanwhile.
+ */
+template <typename T>
+class SPSCQueue
+{
+public:
+    explicit SPSCQueue(size_t capacity): mSlots(capacity + 1) {}
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    /* Producer only. Moves from value only when there was room. */
+    bool TryPush(T& value)
+    {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        const size_t next = Next(tail);
+        if (next == mHead.load(std::memory_order_acquire))
+            return false;
+
+        mSlots[tail] = std::move(value);
+        mTail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /* Consumer only. */
+    bool TryPop(T& value)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire))
+            return false;
+
+        value = std::move(mSlots[head]);
+        mSlots[head] = T();
+        mHead.store(Next(head), std::memory_order_release);
+        return true;
+    }
+
+    /* Either side, a snapshot. */
+    size_t GetSize() const
+    {
+        const size_t head = mHead.load(std::memory_order_acquire);
+        const size_t tail = mTail.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : tail + mSlots.size() - head;
+    }
+
+    size_t GetCapacity() const { return mSlots.size() - 1; }
+
+private:
+    size_t Next(size_t index) const { return index + 1 == mSlots.size() ? 0 : index + 1; }
+
+    std::vector<T>      mSlots;     /* One always empty, to tell full from empty. */
+    alignas(64) std::atomic<size_t> mHead{0};
+    alignas(64) std::atomic<size_t> mTail{0};
+};
+
+#endif /* SPSCQueue_hpp */
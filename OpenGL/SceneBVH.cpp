@@ -0,0 +1,428 @@
+//
+//  SceneBVH.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "SceneBVH.hpp"
+#include "ErrorHandler.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace
+{
+    constexpr unsigned int kNoParent = std::numeric_limits<unsigned int>::max();
+
+    CommonUtils::BBCoord EmptyBox()
+    {
+        const float inf = std::numeric_limits<float>::infinity();
+        return {glm::vec3(inf), glm::vec3(-inf)};
+    }
+
+    void Grow(CommonUtils::BBCoord& box, const CommonUtils::BBCoord& other)
+    {
+        box.Min = glm::min(box.Min, other.Min);
+        box.Max = glm::max(box.Max, other.Max);
+    }
+
+    float SurfaceArea(const CommonUtils::BBCoord& box)
+    {
+        const glm::vec3 extent = box.Max - box.Min;
+        if (extent.x < 0.0f || extent.y < 0.0f || extent.z < 0.0f)
+            return 0.0f;
+
+        return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+    }
+
+    bool Overlaps(const CommonUtils::BBCoord& a, const CommonUtils::BBCoord& b)
+    {
+        return a.Min.x <= b.Max.x && a.Max.x >= b.Min.x &&
+               a.Min.y <= b.Max.y && a.Max.y >= b.Min.y &&
+               a.Min.z <= b.Max.z && a.Max.z >= b.Min.z;
+    }
+
+    /* Slab test, returns the entry distance or a negative value on a miss. */
+    float IntersectRay(const CommonUtils::BBCoord& box, const glm::vec3& origin, const glm::vec3& inverseDirection)
+    {
+        const glm::vec3 t0 = (box.Min - origin) * inverseDirection;
+        const glm::vec3 t1 = (box.Max - origin) * inverseDirection;
+        const glm::vec3 near = glm::min(t0, t1);
+        const glm::vec3 far  = glm::max(t0, t1);
+
+        const float enter = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+        const float exit  = std::min(std::min(far.x, far.y), far.z);
+
+        return enter <= exit ? enter : -1.0f;
+    }
+}
+
+SceneBVH::~SceneBVH()
+{
+    if (mPendingTree.valid())
+        mPendingTree.wait();
+}
+
+void SceneBVH::Build(const std::vector<CommonUtils::BBCoord>& bounds)
+{
+    PROFILE_FUNCTION();
+
+    /* A rebuild of the old object set is useless now. */
+    if (mPendingTree.valid())
+        mPendingTree.get();
+
+    mBounds = bounds;
+    mTree   = BuildTree(mBounds);
+    mDirty  = false;
+}
+
+SceneBVH::Tree SceneBVH::BuildTree(std::vector<CommonUtils::BBCoord> bounds)
+{
+    Tree tree;
+    if (bounds.empty())
+        return tree;
+
+    tree.objects.resize(bounds.size());
+    for (ObjectID object = 0; object < bounds.size(); object++)
+        tree.objects[object] = object;
+
+    CommonUtils::BBCoord rootBounds = EmptyBox();
+    for (const auto& box: bounds)
+        Grow(rootBounds, box);
+
+    tree.nodes.reserve(2 * bounds.size());
+    tree.nodes.push_back({rootBounds, 0, static_cast<unsigned int>(bounds.size()), kNoParent});
+
+    Subdivide(tree, bounds, 0);
+
+    tree.leafOf.resize(bounds.size());
+    for (unsigned int nodeIndex = 0; nodeIndex < tree.nodes.size(); nodeIndex++)
+    {
+        const Node& node = tree.nodes[nodeIndex];
+        for (unsigned int index = node.first; index < node.first + node.count; index++)
+            tree.leafOf[tree.objects[index]] = nodeIndex;
+    }
+
+    tree.cost = ComputeCost(tree);
+    return tree;
+}
+
+void SceneBVH::Subdivide(Tree& tree, const std::vector<CommonUtils::BBCoord>& bounds, unsigned int rootIndex)
+{
+    /* Explicit stack, a badly clustered scene must not overflow the call stack. */
+    std::vector<unsigned int> stack{rootIndex};
+
+    while (!stack.empty())
+    {
+        const unsigned int nodeIndex = stack.back();
+        stack.pop_back();
+
+        const unsigned int first = tree.nodes[nodeIndex].first;
+        const unsigned int count = tree.nodes[nodeIndex].count;
+        if (count <= 1)
+            continue;
+
+        CommonUtils::BBCoord centroidBounds = EmptyBox();
+        for (unsigned int index = first; index < first + count; index++)
+        {
+            const glm::vec3 centroid = CommonUtils::GetBBoxCenter(bounds[tree.objects[index]]);
+            Grow(centroidBounds, {centroid, centroid});
+        }
+
+        /* Binned SAH over all three axes. */
+        float bestCost  = std::numeric_limits<float>::max();
+        int   bestAxis  = -1;
+        int   bestSplit = 0;
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            const float extent = centroidBounds.Max[axis] - centroidBounds.Min[axis];
+            if (extent <= 0.0f)
+                continue;
+
+            CommonUtils::BBCoord binBounds[kBins];
+            unsigned int         binCount[kBins] = {};
+            for (auto& box: binBounds)
+                box = EmptyBox();
+
+            const float scale = kBins / extent;
+            for (unsigned int index = first; index < first + count; index++)
+            {
+                const auto& box = bounds[tree.objects[index]];
+                const int bin = std::min<int>(kBins - 1, static_cast<int>((CommonUtils::GetBBoxCenter(box)[axis] - centroidBounds.Min[axis]) * scale));
+                binCount[bin]++;
+                Grow(binBounds[bin], box);
+            }
+
+            float        rightArea[kBins];
+            unsigned int rightCount[kBins];
+            CommonUtils::BBCoord accumulated = EmptyBox();
+            unsigned int         accumulatedCount = 0;
+            for (int bin = kBins - 1; bin > 0; bin--)
+            {
+                Grow(accumulated, binBounds[bin]);
+                accumulatedCount += binCount[bin];
+                rightArea[bin]  = SurfaceArea(accumulated);
+                rightCount[bin] = accumulatedCount;
+            }
+
+            accumulated      = EmptyBox();
+            accumulatedCount = 0;
+            for (int bin = 0; bin < static_cast<int>(kBins) - 1; bin++)
+            {
+                Grow(accumulated, binBounds[bin]);
+                accumulatedCount += binCount[bin];
+
+                if (accumulatedCount == 0 || rightCount[bin + 1] == 0)
+                    continue;
+
+                const float cost = SurfaceArea(accumulated) * accumulatedCount + rightArea[bin + 1] * rightCount[bin + 1];
+                if (cost < bestCost)
+                {
+                    bestCost  = cost;
+                    bestAxis  = axis;
+                    bestSplit = bin;
+                }
+            }
+        }
+
+        /* Splitting costs one traversal step, keep small nodes as leaves when that doesn't pay off. */
+        const float leafCost = SurfaceArea(tree.nodes[nodeIndex].bounds) * count;
+        if (bestAxis < 0 || (count <= kMaxLeafSize && bestCost + SurfaceArea(tree.nodes[nodeIndex].bounds) >= leafCost))
+            continue;
+
+        const float scale = kBins / (centroidBounds.Max[bestAxis] - centroidBounds.Min[bestAxis]);
+        const auto middle = std::partition(tree.objects.begin() + first, tree.objects.begin() + first + count, [&](ObjectID object) {
+            const int bin = std::min<int>(kBins - 1, static_cast<int>((CommonUtils::GetBBoxCenter(bounds[object])[bestAxis] - centroidBounds.Min[bestAxis]) * scale));
+            return bin <= bestSplit;
+        });
+
+        const unsigned int leftCount = static_cast<unsigned int>(middle - (tree.objects.begin() + first));
+        if (leftCount == 0 || leftCount == count)
+            continue;
+
+        const unsigned int leftIndex = static_cast<unsigned int>(tree.nodes.size());
+        tree.nodes.push_back({EmptyBox(), first, leftCount, nodeIndex});
+        tree.nodes.push_back({EmptyBox(), first + leftCount, count - leftCount, nodeIndex});
+
+        for (unsigned int child = leftIndex; child < leftIndex + 2; child++)
+        {
+            Node& node = tree.nodes[child];
+            for (unsigned int index = node.first; index < node.first + node.count; index++)
+                Grow(node.bounds, bounds[tree.objects[index]]);
+        }
+
+        tree.nodes[nodeIndex].first = leftIndex;
+        tree.nodes[nodeIndex].count = 0;
+
+        stack.push_back(leftIndex);
+        stack.push_back(leftIndex + 1);
+    }
+}
+
+float SceneBVH::ComputeCost(const Tree& tree)
+{
+    if (tree.nodes.empty())
+        return 0.0f;
+
+    const float rootArea = SurfaceArea(tree.nodes[0].bounds);
+    if (rootArea <= 0.0f)
+        return 0.0f;
+
+    float cost = 0.0f;
+    for (const Node& node: tree.nodes)
+        cost += SurfaceArea(node.bounds) / rootArea * (node.count ? node.count : 1.0f);
+
+    return cost;
+}
+
+float SceneBVH::GetCost() const
+{
+    return ComputeCost(mTree);
+}
+
+void SceneBVH::RefitAll()
+{
+    /* Children always come after their parent. */
+    for (size_t nodeIndex = mTree.nodes.size(); nodeIndex-- > 0;)
+    {
+        Node& node = mTree.nodes[nodeIndex];
+        node.bounds = EmptyBox();
+
+        if (node.count)
+        {
+            for (unsigned int index = node.first; index < node.first + node.count; index++)
+                Grow(node.bounds, mBounds[mTree.objects[index]]);
+        }
+        else
+        {
+            Grow(node.bounds, mTree.nodes[node.first].bounds);
+            Grow(node.bounds, mTree.nodes[node.first + 1].bounds);
+        }
+    }
+}
+
+void SceneBVH::Update(ObjectID object, const CommonUtils::BBCoord& bounds)
+{
+    ASSERT(object < mBounds.size());
+
+    const CommonUtils::BBCoord& previous = mBounds[object];
+    if (previous.Min == bounds.Min && previous.Max == bounds.Max)
+        return;
+
+    mBounds[object] = bounds;
+    mDirty = true;
+
+    unsigned int nodeIndex = mTree.leafOf[object];
+
+    Node& leaf = mTree.nodes[nodeIndex];
+    leaf.bounds = EmptyBox();
+    for (unsigned int index = leaf.first; index < leaf.first + leaf.count; index++)
+        Grow(leaf.bounds, mBounds[mTree.objects[index]]);
+
+    while ((nodeIndex = mTree.nodes[nodeIndex].parent) != kNoParent)
+    {
+        Node& node = mTree.nodes[nodeIndex];
+        node.bounds = mTree.nodes[node.first].bounds;
+        Grow(node.bounds, mTree.nodes[node.first + 1].bounds);
+    }
+}
+
+void SceneBVH::Commit()
+{
+    if (mPendingTree.valid())
+    {
+        if (mPendingTree.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+
+        /* Built from a snapshot, bring it up to date with whatever moved since. */
+        mTree = mPendingTree.get();
+        RefitAll();
+        mTree.cost = ComputeCost(mTree);
+        mRebuildCount++;
+        mDirty = false;
+        return;
+    }
+
+    if (!mDirty)
+        return;
+
+    mDirty = false;
+
+    if (ComputeCost(mTree) > fRebuildThreshold * mTree.cost)
+        mPendingTree = std::async(std::launch::async, &SceneBVH::BuildTree, mBounds);
+}
+
+void SceneBVH::QueryFrustum(const Culling::Frustum& frustum, std::vector<ObjectID>& objects) const
+{
+    PROFILE_FUNCTION();
+    objects.clear();
+    if (mTree.nodes.empty())
+        return;
+
+    /* Second member: node is known to be fully inside, no more plane tests below it. */
+    std::vector<std::pair<unsigned int, bool>> stack{{0, false}};
+
+    while (!stack.empty())
+    {
+        const auto entry = stack.back();
+        stack.pop_back();
+
+        const Node& node = mTree.nodes[entry.first];
+        bool inside = entry.second;
+
+        if (!inside)
+        {
+            const auto containment = frustum.Test(node.bounds);
+            if (containment == Culling::Frustum::Containment::Outside)
+                continue;
+
+            inside = containment == Culling::Frustum::Containment::Inside;
+        }
+
+        if (node.count)
+        {
+            for (unsigned int index = node.first; index < node.first + node.count; index++)
+            {
+                const ObjectID object = mTree.objects[index];
+                if (inside || node.count == 1 || frustum.Test(mBounds[object]) != Culling::Frustum::Containment::Outside)
+                    objects.push_back(object);
+            }
+        }
+        else
+        {
+            stack.push_back({node.first, inside});
+            stack.push_back({node.first + 1, inside});
+        }
+    }
+}
+
+void SceneBVH::QueryOverlap(const CommonUtils::BBCoord& box, std::vector<ObjectID>& objects) const
+{
+    objects.clear();
+    if (mTree.nodes.empty())
+        return;
+
+    std::vector<unsigned int> stack{0};
+
+    while (!stack.empty())
+    {
+        const Node& node = mTree.nodes[stack.back()];
+        stack.pop_back();
+
+        if (!Overlaps(node.bounds, box))
+            continue;
+
+        if (node.count)
+        {
+            for (unsigned int index = node.first; index < node.first + node.count; index++)
+                if (Overlaps(mBounds[mTree.objects[index]], box))
+                    objects.push_back(mTree.objects[index]);
+        }
+        else
+        {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+        }
+    }
+}
+
+void SceneBVH::QueryRay(const glm::vec3& origin, const glm::vec3& direction, std::vector<RayHit>& hits) const
+{
+    hits.clear();
+    if (mTree.nodes.empty())
+        return;
+
+    const glm::vec3 inverseDirection = 1.0f / direction;
+    std::vector<unsigned int> stack{0};
+
+    while (!stack.empty())
+    {
+        const Node& node = mTree.nodes[stack.back()];
+        stack.pop_back();
+
+        if (IntersectRay(node.bounds, origin, inverseDirection) < 0.0f)
+            continue;
+
+        if (node.count)
+        {
+            for (unsigned int index = node.first; index < node.first + node.count; index++)
+            {
+                const float distance = IntersectRay(mBounds[mTree.objects[index]], origin, inverseDirection);
+                if (distance >= 0.0f)
+                    hits.push_back({mTree.objects[index], distance});
+            }
+        }
+        else
+        {
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const RayHit& a, const RayHit& b) { return a.distance < b.distance; });
+}
@@ -0,0 +1,92 @@
+//
+//  SceneBVH.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef SceneBVH_hpp
+#define SceneBVH_hpp
+
+#include "CommonUtils.hpp"
+#include "Frustum.hpp"
+
+#include <future>
+#include <vector>
+
+/*
+ * Bounding volume hierarchy over scene objects (world space boxes), for frustum culling, ray and overlap queries.
+ * Built with binned SAH. Moving objects only refits their path to the root; when refitting made the tree
+ * noticeably worse than a fresh build, a rebuild runs on a background thread and is swapped in by Commit().
+ */
+class SceneBVH
+{
+public:
+    using ObjectID = unsigned int;
+
+    struct RayHit
+    {
+        ObjectID object;
+        float    distance;      /* Along the ray, where it enters the object's box. 0 if it starts inside. */
+    };
+
+    SceneBVH() = default;
+    ~SceneBVH();
+
+    /* Objects are identified by their index in `bounds`. */
+    void Build(const std::vector<CommonUtils::BBCoord>& bounds);
+
+    /* New bounds of a moved object, refits its ancestors. */
+    void Update(ObjectID object, const CommonUtils::BBCoord& bounds);
+
+    /* Once per frame after the updates: swaps in a finished background rebuild, or starts one if the tree degraded. */
+    void Commit();
+
+    void QueryFrustum(const Culling::Frustum& frustum, std::vector<ObjectID>& objects) const;
+    void QueryOverlap(const CommonUtils::BBCoord& box, std::vector<ObjectID>& objects) const;
+    /* Every object whose box the ray crosses, nearest first. */
+    void QueryRay(const glm::vec3& origin, const glm::vec3& direction, std::vector<RayHit>& hits) const;
+
+    size_t GetObjectCount() const { return mBounds.size(); }
+    size_t GetNodeCount() const { return mTree.nodes.size(); }
+    float  GetCost() const;                             /* SAH cost of the current (refitted) tree. */
+    unsigned int GetRebuildCount() const { return mRebuildCount; }
+
+    /* Rebuild when the refitted cost exceeds the built cost by this factor. */
+    float fRebuildThreshold = 1.5f;
+
+private:
+    static constexpr unsigned int kMaxLeafSize = 4;
+    static constexpr unsigned int kBins        = 12;
+
+    struct Node
+    {
+        CommonUtils::BBCoord bounds;
+        unsigned int         first;     /* Leaf: first entry in objects. Interior: left child, right is first + 1. */
+        unsigned int         count;     /* 0 for interior nodes. */
+        unsigned int         parent;
+    };
+
+    struct Tree
+    {
+        std::vector<Node>         nodes;
+        std::vector<ObjectID>     objects;
+        std::vector<unsigned int> leafOf;   /* Object to its leaf node. */
+        float                     cost = 0.0f;
+    };
+
+    static Tree  BuildTree(std::vector<CommonUtils::BBCoord> bounds);
+    static void  Subdivide(Tree& tree, const std::vector<CommonUtils::BBCoord>& bounds, unsigned int nodeIndex);
+    static float ComputeCost(const Tree& tree);
+
+    void RefitAll();
+
+    std::vector<CommonUtils::BBCoord> mBounds;
+    Tree                              mTree;
+    std::future<Tree>                 mPendingTree;
+    bool                              mDirty        = false;
+    unsigned int                      mRebuildCount = 0;
+};
+
+#endif /* SceneBVH_hpp */
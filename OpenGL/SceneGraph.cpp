@@ -0,0 +1,88 @@
+//
+//  SceneGraph.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "SceneGraph.hpp"
+#include "ErrorHandler.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+
+SceneGraph::NodeID SceneGraph::AddNode(NodeID parent, const glm::mat4& localTransform, const std::string& name)
+{
+    const NodeID node = static_cast<NodeID>(mParents.size());
+    ASSERT(parent == kNone || parent < node);
+
+    mParents.push_back(parent);
+    mLocalTransforms.push_back(localTransform);
+    mWorldTransforms.push_back(localTransform);
+    mDirty.push_back(1);
+    mNames.push_back(name);
+
+    mFirstDirty = std::min(mFirstDirty, node);
+    return node;
+}
+
+void SceneGraph::AddMesh(NodeID node, unsigned int mesh)
+{
+    ASSERT(node < mParents.size());
+    mMeshInstances.push_back({node, mesh});
+}
+
+void SceneGraph::Clear()
+{
+    mParents.clear();
+    mLocalTransforms.clear();
+    mWorldTransforms.clear();
+    mDirty.clear();
+    mNames.clear();
+    mMeshInstances.clear();
+    mFirstDirty = kNone;
+}
+
+void SceneGraph::SetLocalTransform(NodeID node, const glm::mat4& transform)
+{
+    if (mLocalTransforms[node] == transform)
+        return;
+
+    mLocalTransforms[node] = transform;
+    mDirty[node] = 1;
+    mFirstDirty = std::min(mFirstDirty, node);
+}
+
+SceneGraph::NodeID SceneGraph::FindNode(const std::string& name) const
+{
+    const auto found = std::find(mNames.begin(), mNames.end(), name);
+    return found == mNames.end() ? kNone : static_cast<NodeID>(found - mNames.begin());
+}
+
+size_t SceneGraph::Update()
+{
+    if (mFirstDirty == kNone)
+        return 0;
+
+    PROFILE_FUNCTION();
+
+    /* Parents come first, a node's parent flag already says whether the parent was recomputed in this pass. */
+    size_t updated = 0;
+    for (NodeID node = mFirstDirty; node < mParents.size(); node++)
+    {
+        const NodeID parent = mParents[node];
+        if (parent != kNone && mDirty[parent])
+            mDirty[node] = 1;
+
+        if (!mDirty[node])
+            continue;
+
+        mWorldTransforms[node] = parent == kNone ? mLocalTransforms[node] : mWorldTransforms[parent] * mLocalTransforms[node];
+        updated++;
+    }
+
+    std::fill(mDirty.begin() + mFirstDirty, mDirty.end(), 0);
+    mFirstDirty = kNone;
+    return updated;
+}
@@ -0,0 +1,66 @@
+//
+//  SceneGraph.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef SceneGraph_hpp
+#define SceneGraph_hpp
+
+#include "glm.hpp"
+
+#include <string>
+#include <vector>
+
+/*
+ * Node hierarchy of a model, flattened into arrays with every parent before its children. World transforms are
+ * then a single pass in index order, and only nodes whose local transform changed, or one of their ancestors',
+ * are recomputed.
+ */
+class SceneGraph
+{
+public:
+    using NodeID = unsigned int;
+    static constexpr NodeID kNone = ~0u;
+
+    /* A mesh drawn at a node, a mesh may be drawn at several. */
+    struct MeshInstance
+    {
+        NodeID       node;
+        unsigned int mesh;
+    };
+
+    /* parent is kNone for a root, otherwise already in the graph. */
+    NodeID AddNode(NodeID parent, const glm::mat4& localTransform, const std::string& name = std::string());
+    void AddMesh(NodeID node, unsigned int mesh);
+    void Clear();
+
+    void SetLocalTransform(NodeID node, const glm::mat4& transform);
+    const glm::mat4& GetLocalTransform(NodeID node) const { return mLocalTransforms[node]; }
+    /* As of the last Update. */
+    const glm::mat4& GetWorldTransform(NodeID node) const { return mWorldTransforms[node]; }
+    NodeID GetParent(NodeID node) const { return mParents[node]; }
+    const std::string& GetName(NodeID node) const { return mNames[node]; }
+    /* First node of that name, kNone if there is none. */
+    NodeID FindNode(const std::string& name) const;
+
+    size_t GetNodeCount() const { return mParents.size(); }
+    const std::vector<MeshInstance>& GetMeshInstances() const { return mMeshInstances; }
+
+    /* Recomputes the world transforms of dirty subtrees. Returns how many, 0 when nothing changed. */
+    size_t Update();
+    bool IsDirty() const { return mFirstDirty != kNone; }
+
+private:
+    std::vector<NodeID>        mParents;
+    std::vector<glm::mat4>     mLocalTransforms;
+    std::vector<glm::mat4>     mWorldTransforms;
+    std::vector<unsigned char> mDirty;              /* Local transform changed since the last Update. */
+    std::vector<std::string>   mNames;
+    std::vector<MeshInstance>  mMeshInstances;
+    NodeID                     mFirstDirty = kNone; /* Nothing before it needs a look. */
+};
+
+#endif /* SceneGraph_hpp */
@@ -0,0 +1,147 @@
+//
+//  ScenePipeline.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "ScenePipeline.hpp"
+#include "ErrorHandler.hpp"
+#include "Profiler.hpp"
+
+#include <chrono>
+
+namespace Helper
+{
+    ScenePipeline::ScenePipeline(const SceneRenderer& scene, bool threaded):
+        mScene(scene)
+    {
+        SetThreaded(threaded);
+    }
+
+    ScenePipeline::~ScenePipeline()
+    {
+        SetThreaded(false);
+    }
+
+    void ScenePipeline::SetThreaded(bool threaded)
+    {
+        if (threaded == IsThreaded())
+            return;
+
+        if (threaded)
+        {
+            mStopping = false;
+            mFirstThreaded = mSubmitted + 1;
+            mThread = std::thread(&ScenePipeline::UpdateLoop, this);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+
+        mCondition.notify_one();
+        mThread.join();
+    }
+
+    void ScenePipeline::Submit(const Input& input)
+    {
+        mSubmitted++;
+
+        if (!IsThreaded())
+        {
+            mInput = input;
+            mInput.sequence = mSubmitted;
+            return;
+        }
+
+        /* Handed over by Acquire, once the update thread is done with the previous one. */
+        Input& next = mInputs.GetWriteBuffer();
+        next = input;
+        next.sequence = mSubmitted;
+    }
+
+    SceneState& ScenePipeline::Acquire()
+    {
+        PROFILE_FUNCTION();
+
+        if (!IsThreaded())
+        {
+            mWaitTime = 0.0;
+            if (mState.sequence != mInput.sequence)
+                Prepare(mInput, mState);
+
+            return mState;
+        }
+
+        /*
+         * Exactly the previous input's state, prepared while that frame was drawn. The first frame after the start
+         * has none and waits for its own, so the frame after it draws that one again.
+         */
+        const bool first = mSubmitted == mFirstThreaded;
+        const unsigned long long required = first ? mSubmitted : mSubmitted - 1;
+
+        if (first)
+            HandOver();
+
+        const auto start = std::chrono::steady_clock::now();
+        mStates.Update();
+        while (mStates.GetReadBuffer().sequence < required)
+        {
+            std::this_thread::yield();
+            mStates.Update();
+        }
+        mWaitTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        /* Only now the next input goes over, no later state can take the place of the one returned before it's read. */
+        if (!first)
+            HandOver();
+
+        ASSERT(mStates.GetReadBuffer().sequence == required);
+        return mStates.GetReadBuffer();
+    }
+
+    void ScenePipeline::HandOver()
+    {
+        mInputs.Publish();
+
+        /* Taking the lock orders the publish before the update thread's check, the wake up can't get lost. */
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+        }
+
+        mCondition.notify_one();
+    }
+
+    void ScenePipeline::UpdateLoop()
+    {
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this]() { return mStopping.load() || mInputs.HasNew(); });
+
+                if (mStopping)
+                    return;
+            }
+
+            mInputs.Update();
+            Prepare(mInputs.GetReadBuffer(), mStates.GetWriteBuffer());
+            mStates.Publish();
+        }
+    }
+
+    void ScenePipeline::Prepare(const Input& input, SceneState& state)
+    {
+        PROFILE_FUNCTION();
+
+        const auto start = std::chrono::steady_clock::now();
+        mScene.Prepare(input.settings, input.proj, input.view, input.cameraPosition, input.width, input.height, state);
+        state.sequence = input.sequence;
+
+        mPrepareNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+}
@@ -0,0 +1,85 @@
+//
+//  ScenePipeline.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef ScenePipeline_hpp
+#define ScenePipeline_hpp
+
+#include "SceneRenderHelper.hpp"
+#include "TripleBuffer.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Helper
+{
+    /*
+     * Prepares the scene state of the next frame on an update thread while the GL thread draws this one. Inputs go
+     * over to it and prepared states come back through triple buffers, neither thread ever holds a lock while the
+     * other works. The update thread has at most one input at a time, so every state is prepared and drawn in order.
+     * Costs one frame of latency. Not threaded, Acquire prepares the frame just submitted inline.
+     */
+    class ScenePipeline
+    {
+    public:
+        struct Input
+        {
+            SceneRenderer::Settings settings;
+            glm::mat4               proj{1.0f};
+            glm::mat4               view{1.0f};
+            glm::vec3               cameraPosition{};
+            int                     width  = 0;
+            int                     height = 0;
+            unsigned long long      sequence = 0;      /* Set by Submit. */
+        };
+
+        /* The scene must outlive the pipeline, and only its Prepare is called off the GL thread. */
+        ScenePipeline(const SceneRenderer& scene, bool threaded);
+        ~ScenePipeline();
+
+        ScenePipeline(const ScenePipeline&) = delete;
+        ScenePipeline& operator=(const ScenePipeline&) = delete;
+
+        void SetThreaded(bool threaded);
+        bool IsThreaded() const { return mThread.joinable(); }
+
+        /* Once a frame, then Acquire. */
+        void Submit(const Input& input);
+        /* The state to draw, exactly the one of the previous Submit when threaded. Valid until the next Acquire. */
+        SceneState& Acquire();
+
+        /* Milliseconds, of the last state prepared and of the last Acquire waiting for it. */
+        double GetPrepareTime() const { return mPrepareNanoseconds.load(std::memory_order_relaxed) / 1e6; }
+        double GetWaitTime() const { return mWaitTime; }
+
+    private:
+        void UpdateLoop();
+        void HandOver();
+        void Prepare(const Input& input, SceneState& state);
+
+        const SceneRenderer&      mScene;
+
+        TripleBuffer<Input>       mInputs;      /* GL thread writes, update thread reads. */
+        TripleBuffer<SceneState>  mStates;      /* The other way round. */
+        Input                     mInput;       /* Not threaded. */
+        SceneState                mState;
+        unsigned long long        mSubmitted = 0;
+        unsigned long long        mFirstThreaded = 0;   /* First input the update thread got. */
+
+        std::thread               mThread;
+        std::mutex                mMutex;       /* Only to sleep on, nothing is shared under it. */
+        std::condition_variable   mCondition;
+        std::atomic<bool>         mStopping{false};
+
+        std::atomic<long long>    mPrepareNanoseconds{0};
+        double                    mWaitTime = 0.0;
+    };
+}
+
+#endif /* ScenePipeline_hpp */
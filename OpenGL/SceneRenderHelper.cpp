@@ -0,0 +1,573 @@
+//
+//  SceneRenderHelper.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "SceneRenderHelper.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+#include "Transforms.hpp"
+
+#include <random>
+
+namespace Helper
+{
+    /* Y axis is up. */
+    SceneRenderer::SceneRenderer(const std::string& resourceRoot, bool compressTextures, bool cacheTextures):
+        mTextureStreamer(ThreadPool::Shared(), compressTextures, cacheTextures),
+        mGroundModel(resourceRoot + "Models/GroundPlane/GroundPlane.obj", &mTextureStreamer),
+        mObjectModel(resourceRoot + "Models/Ivysaur_OBJ/Pokemon.obj", &mTextureStreamer),
+        mLightModel(resourceRoot + "Models/Light/Light.obj", &mTextureStreamer),
+        mModelShader(resourceRoot + "Shaders/ModelObject.shader"),
+        mLightShader(resourceRoot + "Shaders/LightObject.shader"),
+        mBoundingBoxShader(resourceRoot + "Shaders/BoundingBox.shader"),
+        mShadowDepthShader(resourceRoot + "Shaders/ShadowDepth.shader"),
+        /* Todo: abstract all these GetBBox calls and put them in relevent class. SERIOUSLY! */
+        mLightObjectBB(CommonUtils::GetBBox(mLightModel.GetTriangleMesh())),
+        mModelObjectBB(CommonUtils::GetBBox(mObjectModel.GetTriangleMesh())),
+        mGroundObjectBB(CommonUtils::GetBBox(mGroundModel.GetTriangleMesh())), /* Todo: Add a get bound to renderermodel maybe?*/
+        mUnionizedBB(CommonUtils::GetBBox({mLightObjectBB, mModelObjectBB, mGroundObjectBB})), /* ToDo: Ugh... Copy... */
+        mInitialLightPosition(CommonUtils::GetBBoxCenter(mLightObjectBB)),
+        fObjectModelMatrix(mUnionizedBB, mModelObjectBB),
+        fLightModelMatrix(mUnionizedBB, mLightObjectBB),
+        fGroundModelMatrix(mUnionizedBB, mGroundObjectBB)
+    {
+        mModelShader.Bind();
+
+        /* ToDo: extract these values from model itself. Direction is set per frame. */
+        mModelShader.SetUniform3f("u_DirectionalLight.ambient",  0.3f, 0.3f, 0.3f);
+        mModelShader.SetUniform3f("u_DirectionalLight.diffuse",  0.7f, 0.7f, 0.7f);
+        mModelShader.SetUniform3f("u_DirectionalLight.specular", 1.0f, 1.0f, 1.0f);
+        mModelShader.SetUniform1i("u_DiffuseMaps", ModelRenderer::kDiffuseMapsSlot);
+        mModelShader.SetUniform1i("u_SpecularMaps", ModelRenderer::kSpecularMapsSlot);
+        mModelShader.SetUniform1i("u_Materials", ModelRenderer::kMaterialsSlot);
+        mModelShader.SetUniform1i("u_ShadowMap", kShadowMapSlot);
+        mModelShader.SetUniform1i("u_Lights", kLightsSlot);
+        mModelShader.SetUniform1i("u_LightGrid", kLightGridSlot);
+        mModelShader.SetUniform1i("u_LightIndices", kLightIndicesSlot);
+
+        mLightShader.Bind();
+        mLightShader.SetUniform1i("u_DiffuseMaps", ModelRenderer::kDiffuseMapsSlot);
+        mLightShader.SetUniform1i("u_Materials", ModelRenderer::kMaterialsSlot);
+        mLightShader.SetUniform3f("u_LightColor", 1.0f, 1.0f, 1.0f);
+
+        fLightModelMatrix.fTranslation.x = -15.0f;
+        fLightModelMatrix.fScale.x = fLightModelMatrix.fScale.y = fLightModelMatrix.fScale.z = 1.4f;
+
+        fObjectModelMatrix.fScale = glm::vec3(5.0f, 5.0f, 5.0f);
+        fGroundModelMatrix.fScale = fObjectModelMatrix.fScale;
+
+        mObjectMatrices[Object] = fObjectModelMatrix.GetMatrix();
+        mObjectMatrices[Ground] = fGroundModelMatrix.GetMatrix();
+        mObjectMatrices[Light]  = fLightModelMatrix.GetMatrix();
+
+        mObjectBounds.resize(SceneObjectCount);
+        UpdateObjectBounds(mObjectMatrices[Object], mObjectMatrices[Ground], mObjectMatrices[Light]);
+        mObjectBVH.Build(mObjectBounds);
+
+        mGroundOccluder = Culling::MakeOccluder(mGroundModel.GetTriangleMesh());
+        mObjectOccluder = Culling::MakeSimplifiedOccluder(mObjectModel.GetTriangleMesh(), 32);
+
+        /* [0, 1] cube, scaled onto the object bounds for the occlusion queries. */
+        mUnitCube.CreateVBuffer3f({0, 0, 0,  1, 0, 0,  1, 1, 0,  0, 1, 0,  0, 0, 1,  1, 0, 1,  1, 1, 1,  0, 1, 1});
+        mUnitCube.CreateIBuffer({0, 2, 1, 0, 3, 2,  4, 5, 6, 4, 6, 7,  0, 1, 5, 0, 5, 4,
+                                 3, 6, 2, 3, 7, 6,  0, 4, 7, 0, 7, 3,  1, 2, 6, 1, 6, 5});
+    }
+
+    SceneRenderer::~SceneRenderer()
+    {
+
+    }
+
+    void SceneRenderer::UpdateObjectBounds(const glm::mat4& objectMatrix, const glm::mat4& groundMatrix, const glm::mat4& lightMatrix)
+    {
+        mObjectBounds[Object] = CommonUtils::TransformBBox(mModelObjectBB, objectMatrix);
+        mObjectBounds[Ground] = CommonUtils::TransformBBox(mGroundObjectBB, groundMatrix);
+        mObjectBounds[Light]  = CommonUtils::TransformBBox(mLightObjectBB, lightMatrix);
+    }
+
+    void SceneRenderer::UpdateModelTransforms()
+    {
+        /* Every model updates, no short circuit. */
+        const bool groundMoved = mGroundModel.UpdateTransforms();
+        const bool objectMoved = mObjectModel.UpdateTransforms();
+        const bool lightMoved  = mLightModel.UpdateTransforms();
+
+        /* The model matrices keep rotating about the initial bounds, the GUI's placement doesn't jump. */
+        if (groundMoved)
+        {
+            mGroundObjectBB = CommonUtils::GetBBox(mGroundModel.GetTriangleMesh());
+            mGroundOccluder = Culling::MakeOccluder(mGroundModel.GetTriangleMesh());
+        }
+
+        if (objectMoved)
+        {
+            mModelObjectBB  = CommonUtils::GetBBox(mObjectModel.GetTriangleMesh());
+            mObjectOccluder = Culling::MakeSimplifiedOccluder(mObjectModel.GetTriangleMesh(), 32);
+        }
+
+        if (lightMoved)
+        {
+            mLightObjectBB        = CommonUtils::GetBBox(mLightModel.GetTriangleMesh());
+            mInitialLightPosition = CommonUtils::GetBBoxCenter(mLightObjectBB);
+        }
+
+        /* The object bounds and their BVH follow from the boxes in this Draw, the shadow casters changed shape. */
+        if (groundMoved || objectMoved)
+            mShadowCacheStale = true;
+    }
+
+    glm::vec3 SceneRenderer::GetLookAtCenter() const
+    {
+        return CommonUtils::GetBBoxCenter(mUnionizedBB);
+    }
+
+    void SceneRenderer::ScatterExtraLights(unsigned int count)
+    {
+        const CommonUtils::BBCoord area = CommonUtils::GetBBox({mObjectBounds[Object], mObjectBounds[Ground]});
+        const glm::vec3 extent = area.Max - area.Min;
+        const float radius = 0.15f * std::max(extent.x, extent.z);
+
+        std::mt19937 random(count);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        fExtraLights.resize(count);
+        for (auto& light: fExtraLights)
+        {
+            light.position = area.Min + glm::vec3(unit(random), 0.05f + 0.3f * unit(random), unit(random)) * extent;
+            light.radius   = radius;
+            light.color    = glm::vec3(unit(random), unit(random), unit(random));
+        }
+    }
+
+    SceneRenderer::TextureMemory SceneRenderer::GetTextureMemory(SceneBVH::ObjectID object) const
+    {
+        const ModelRenderer& model = object == Object ? mObjectModel : object == Ground ? mGroundModel : mLightModel;
+        return {model.GetTextureBytes(), model.GetUncompressedTextureBytes()};
+    }
+
+    const MaterialTable& SceneRenderer::GetMaterials(SceneBVH::ObjectID object) const
+    {
+        const ModelRenderer& model = object == Object ? mObjectModel : object == Ground ? mGroundModel : mLightModel;
+        return model.GetMaterials();
+    }
+
+    const char* SceneRenderer::GetObjectName(SceneBVH::ObjectID object)
+    {
+        switch (object)
+        {
+            case Object: return "Object";
+            case Ground: return "Ground";
+            case Light:  return "Light";
+            default:     return "Unknown";
+        }
+    }
+
+    bool SceneRenderer::Pick(const glm::vec2& ndc, const glm::mat4& proj, const glm::mat4& view, PickHit& hit) const
+    {
+        PROFILE_FUNCTION();
+
+        const glm::mat4 inverseViewProj = glm::inverse(proj * view);
+        const glm::vec4 nearPoint = inverseViewProj * glm::vec4(ndc, -1.0f, 1.0f);
+        const glm::vec4 farPoint  = inverseViewProj * glm::vec4(ndc,  1.0f, 1.0f);
+
+        const glm::vec3 origin    = glm::vec3(nearPoint) / nearPoint.w;
+        const glm::vec3 direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+
+        /* Objects come nearest box first, stop once the next box starts behind the best triangle. */
+        std::vector<SceneBVH::RayHit> candidates;
+        mObjectBVH.QueryRay(origin, direction, candidates);
+
+        TriangleBVH::Hit best;
+        bool found = false;
+
+        for (const auto& candidate: candidates)
+        {
+            if (candidate.distance >= best.distance)
+                break;
+
+            const ModelRenderer& model = candidate.object == Object ? mObjectModel : candidate.object == Ground ? mGroundModel : mLightModel;
+
+            unsigned int mesh = 0;
+            if (model.Intersect(origin, direction, mObjectMatrices[candidate.object], best, mesh))
+            {
+                hit.object   = candidate.object;
+                hit.mesh     = mesh;
+                found        = true;
+            }
+        }
+
+        if (found)
+        {
+            hit.triangle = best.triangle;
+            hit.distance = best.distance;
+            hit.position = origin + best.distance * direction;
+        }
+
+        return found;
+    }
+
+    SceneRenderer::Settings SceneRenderer::GetSettings()
+    {
+        {
+            /* Place ground below object */
+            auto distance = CommonUtils::GetBBoxCenter(mModelObjectBB) - CommonUtils::GetBBoxCenter(mGroundObjectBB);
+            distance -= glm::vec3(0, CommonUtils::GetBBoxHeight(mModelObjectBB)/2  * fObjectModelMatrix.fScale.y, 0);
+            fGroundModelMatrix.fTranslation = distance;
+            /* ToDo: I should actually put object on ground instead of other way round. */
+        }
+
+        /* Only recomposed when changed, the copies then carry the cached matrices to Prepare. */
+        fObjectModelMatrix.GetMatrix();
+        fGroundModelMatrix.GetMatrix();
+        fLightModelMatrix.GetMatrix();
+
+        Settings settings;
+        settings.objectModelMatrix         = fObjectModelMatrix;
+        settings.lightModelMatrix          = fLightModelMatrix;
+        settings.groundModelMatrix         = fGroundModelMatrix;
+        settings.lightPosition             = mInitialLightPosition;
+        settings.lightColor                = fLightColor;
+        settings.extraLights               = fExtraLights;
+        settings.enableDirectionalLight    = fEnableDirectionalLight;
+        settings.directionalLightDirection = fDirectionalLightDirection;
+        return settings;
+    }
+
+    void SceneRenderer::Draw(const Renderer& renderer, const glm::mat4& proj, const glm::mat4& view, const glm::vec3& cameraPosition)
+    {
+        GLint viewPort[4];
+        GLCall(glGetIntegerv(GL_VIEWPORT, viewPort));
+
+        Prepare(GetSettings(), proj, view, cameraPosition, viewPort[2], viewPort[3], mState);
+        Draw(renderer, mState);
+    }
+
+    void SceneRenderer::Prepare(const Settings& settings, const glm::mat4& proj, const glm::mat4& view, const glm::vec3& cameraPosition,
+                                int width, int height, SceneState& state)
+    {
+        PROFILE_FUNCTION();
+
+        state.proj           = proj;
+        state.view           = view;
+        state.cameraPosition = cameraPosition;
+        state.width          = width;
+        state.height         = height;
+        state.pixelsPerUnit  = 0.5f * height * proj[1][1];
+        state.lightColor     = settings.lightColor;
+        state.enableDirectionalLight    = settings.enableDirectionalLight;
+        state.directionalLightDirection = settings.directionalLightDirection;
+
+        const CommonUtils::ModelMatrix* modelMatrices[SceneObjectCount] = {};
+        modelMatrices[Object] = &settings.objectModelMatrix;
+        modelMatrices[Ground] = &settings.groundModelMatrix;
+        modelMatrices[Light]  = &settings.lightModelMatrix;
+
+        for (SceneBVH::ObjectID object = 0; object < SceneObjectCount; object++)
+        {
+            state.objectMatrices[object] = modelMatrices[object]->GetMatrix();
+            state.normalMatrices[object] = modelMatrices[object]->GetNormalMatrix();
+        }
+
+        Transforms::MultiplyMatrices(proj * view, state.objectMatrices, state.mvps, SceneObjectCount);
+
+        PROFILE_SCOPE("SceneRenderer::ClusterLights");
+
+        auto finalLightPosition = glm::vec3(state.objectMatrices[Light] * glm::vec4(settings.lightPosition, 1.0f));
+
+        state.pointLights.clear();
+        state.pointLights.push_back({finalLightPosition, Lighting::AttenuationRadius(settings.lightColor), settings.lightColor});
+        state.pointLights.insert(state.pointLights.end(), settings.extraLights.begin(), settings.extraLights.end());
+
+        state.lightClusters.Build(state.pointLights, view, proj, width, height, &ThreadPool::Shared());
+    }
+
+    void SceneRenderer::Draw(const Renderer& renderer, SceneState& state)
+    {
+        mTextureStreamer.Update();
+        mGroundModel.UpdateMaterials();
+        mObjectModel.UpdateMaterials();
+        mLightModel.UpdateMaterials();
+        UpdateModelTransforms();
+
+        mDrawnState = &state;
+
+        const glm::mat4& proj = state.proj;
+        const glm::mat4& view = state.view;
+        const glm::vec3& cameraPosition = state.cameraPosition;
+
+        mModelShader.Bind();
+        mModelShader.SetUniform3f("u_ViewPos", cameraPosition.x, cameraPosition.y, cameraPosition.z);
+
+        {
+            mModelShader.SetUniform1i("u_DirectionalLight.enable", state.enableDirectionalLight);
+            mModelShader.SetUniform3f("u_DirectionalLight.direction", state.directionalLightDirection.x, state.directionalLightDirection.y, state.directionalLightDirection.z);
+        }
+
+        {
+            state.lightClusters.Upload();
+            state.lightClusters.Bind(kLightsSlot, kLightGridSlot, kLightIndicesSlot);
+
+            const glm::vec2 tileScale = state.lightClusters.GetTileScale();
+            const glm::vec3 viewForward = -glm::vec3(view[0][2], view[1][2], view[2][2]);
+
+            mModelShader.Bind();
+            mModelShader.SetUniform3f("u_ViewForward", viewForward.x, viewForward.y, viewForward.z);
+            mModelShader.SetUniform2f("u_ClusterTileScale", tileScale.x, tileScale.y);
+            mModelShader.SetUniform1f("u_ClusterNear", state.lightClusters.GetNear());
+            mModelShader.SetUniform1f("u_ClusterSliceScale", state.lightClusters.GetSliceScale());
+        }
+
+        const glm::mat4& objectMatrix = state.objectMatrices[Object];
+        const glm::mat4& groundMatrix = state.objectMatrices[Ground];
+        const glm::mat4& lightMatrix  = state.objectMatrices[Light];
+        const glm::mat4 viewProj     = proj * view;
+
+        /* Cached shadow cascades only care about the shadow casters. */
+        const bool castersMoved = objectMatrix != mObjectMatrices[Object] || groundMatrix != mObjectMatrices[Ground];
+        CommonUtils::BBCoord movedBounds = CommonUtils::GetBBox({mObjectBounds[Object], mObjectBounds[Ground]});
+
+        mObjectMatrices[Object] = objectMatrix;
+        mObjectMatrices[Ground] = groundMatrix;
+        mObjectMatrices[Light]  = lightMatrix;
+
+        UpdateObjectBounds(objectMatrix, groundMatrix, lightMatrix);
+
+        /* Only objects that actually moved (e.g. the light from the GUI) refit their path to the root. */
+        for (SceneBVH::ObjectID object = 0; object < SceneObjectCount; object++)
+            mObjectBVH.Update(object, mObjectBounds[object]);
+
+        mObjectBVH.Commit();
+
+        const Culling::Frustum frustum = Culling::Frustum::FromMatrix(viewProj);
+
+        if (fEnableFrustumCulling)
+        {
+            mObjectBVH.QueryFrustum(frustum, mVisibleObjects);
+
+            mObjectVisible.assign(SceneObjectCount, 0);
+            for (const auto object: mVisibleObjects)
+                mObjectVisible[object] = 1;
+
+            renderer.CountObjects(static_cast<unsigned int>(mVisibleObjects.size()), static_cast<unsigned int>(SceneObjectCount - mVisibleObjects.size()));
+        }
+        else
+        {
+            mObjectVisible.assign(SceneObjectCount, 1);
+            renderer.CountObjects(SceneObjectCount, 0);
+        }
+
+        if (fEnableOcclusionCulling)
+        {
+            mOcclusionRasterizer.Clear(viewProj);
+            mOcclusionRasterizer.AddOccluder(mGroundOccluder, groundMatrix);
+            mOcclusionRasterizer.AddOccluder(mObjectOccluder, objectMatrix);
+            mOcclusionRasterizer.Rasterize(&ThreadPool::Shared());
+
+            unsigned int occluded = 0;
+            for (SceneBVH::ObjectID object = 0; object < SceneObjectCount; object++)
+            {
+                if (mObjectVisible[object] && !mOcclusionRasterizer.IsVisible(mObjectBounds[object]))
+                {
+                    mObjectVisible[object] = 0;
+                    occluded++;
+                }
+            }
+
+            renderer.CountOccluded(occluded);
+        }
+
+        if (fEnableShadows && state.enableDirectionalLight)
+        {
+            /* Casters may have moved any number of times while no shadows were drawn. */
+            if (mShadowCacheStale)
+            {
+                for (int cascade = 0; cascade < CascadedShadowMap::kCascades; cascade++)
+                    mShadowMap.Invalidate(cascade);
+                mShadowCacheStale = false;
+            }
+
+            movedBounds = CommonUtils::GetBBox({movedBounds, mObjectBounds[Object], mObjectBounds[Ground]});
+            RenderShadowMaps(renderer, state, castersMoved, movedBounds);
+
+            mModelShader.Bind();
+            mModelShader.SetUniform1i("u_EnableShadows", 1);
+            for (int cascade = 0; cascade < CascadedShadowMap::kCascades; cascade++)
+            {
+                mModelShader.SetUniformMat4f("u_LightViewProj[" + std::to_string(cascade) + "]", mShadowMap.GetViewProj(cascade));
+                mModelShader.SetUniform1f("u_CascadeSplits[" + std::to_string(cascade) + "]", mShadowMap.GetSplit(cascade));
+            }
+            mShadowMap.Bind(kShadowMapSlot);
+        }
+        else
+        {
+            mShadowCacheStale = true;
+
+            mModelShader.Bind();
+            mModelShader.SetUniform1i("u_EnableShadows", 0);
+        }
+
+        if (!fEnableOcclusionQueries)
+        {
+            for (SceneBVH::ObjectID object = 0; object < SceneObjectCount; object++)
+                if (mObjectVisible[object])
+                    DrawObject(object, renderer, frustum);
+
+            return;
+        }
+
+        /*
+         * Temporal coherence: objects visible at their last query are drawn first, they fill the depth buffer.
+         * Boxes of the rest are then tested against it, and those objects are drawn under conditional rendering
+         * so the GPU drops them when no box sample passed. Results are read when ready, the CPU never waits.
+         */
+        bool deferred[SceneObjectCount] = {};
+        bool query[SceneObjectCount] = {};
+        unsigned int queries = 0, conditional = 0;
+
+        for (SceneBVH::ObjectID object = 0; object < SceneObjectCount; object++)
+        {
+            if (!mObjectVisible[object])
+                continue;
+
+            mOcclusionQueries[object].Poll();
+
+            /* A box around the camera gets clipped by the near plane and would report nothing. */
+            const CommonUtils::BBCoord& bounds = mObjectBounds[object];
+            const bool cameraInside = glm::all(glm::greaterThanEqual(cameraPosition, bounds.Min - 1.0f)) &&
+                                      glm::all(glm::lessThanEqual(cameraPosition, bounds.Max + 1.0f));
+
+            if (cameraInside || mOcclusionQueries[object].WasVisible())
+                DrawObject(object, renderer, frustum);
+            else
+                deferred[object] = true;
+
+            if (cameraInside || mOcclusionQueries[object].IsPending())
+                continue;
+
+            query[object] = deferred[object] || ++mFramesSinceQuery[object] >= kRequeryInterval;
+        }
+
+        /* Only once every visible object is in the depth buffer, or a box could pass where it would be hidden. */
+        for (SceneBVH::ObjectID object = 0; object < SceneObjectCount; object++)
+        {
+            if (!query[object])
+                continue;
+
+            QueryBoundingBox(object, viewProj);
+            mFramesSinceQuery[object] = 0;
+            queries++;
+        }
+
+        for (SceneBVH::ObjectID object = 0; object < SceneObjectCount; object++)
+        {
+            if (!deferred[object])
+                continue;
+
+            mOcclusionQueries[object].BeginConditionalRender();
+            DrawObject(object, renderer, frustum);
+            mOcclusionQueries[object].EndConditionalRender();
+            conditional++;
+        }
+
+        renderer.CountQueries(queries, conditional);
+    }
+
+    void SceneRenderer::RenderShadowMaps(const Renderer& renderer, const SceneState& state, bool castersMoved, const CommonUtils::BBCoord& movedBounds)
+    {
+        PROFILE_FUNCTION();
+        mShadowTimer.Begin();
+
+        const CommonUtils::BBCoord casterBounds = CommonUtils::GetBBox({mObjectBounds[Object], mObjectBounds[Ground]});
+        mShadowMap.Fit(state.proj, state.view, state.directionalLightDirection, casterBounds);
+
+        unsigned int rendered = 0;
+        for (int cascade = 0; cascade < CascadedShadowMap::kCascades; cascade++)
+        {
+            const glm::mat4& lightViewProj = mShadowMap.GetViewProj(cascade);
+            const Culling::Frustum lightFrustum = Culling::Frustum::FromMatrix(lightViewProj);
+
+            /* A caster moved through this cascade, before or after the move. */
+            if (castersMoved && lightFrustum.Test(movedBounds) != Culling::Frustum::Containment::Outside)
+                mShadowMap.Invalidate(cascade);
+
+            if (fEnableShadowCache && !mShadowMap.NeedsRender(cascade))
+                continue;
+
+            mShadowMap.BeginCascade(cascade);
+            mShadowDepthShader.Bind();
+
+            /* The light's own model casts no shadow. */
+            for (const SceneObject object: {Object, Ground})
+            {
+                if (lightFrustum.Test(mObjectBounds[object]) == Culling::Frustum::Containment::Outside)
+                    continue;
+
+                const ModelRenderer& model = object == Object ? mObjectModel : mGroundModel;
+                mShadowDepthShader.SetUniformMat4f("u_MVP", lightViewProj * mObjectMatrices[object]);
+                model.DrawDepth(renderer, mShadowDepthShader);
+            }
+
+            rendered++;
+        }
+
+        mShadowMap.End();
+        mShadowTimer.End();
+
+        renderer.CountShadowCascades(rendered);
+    }
+
+    void SceneRenderer::DrawObject(SceneBVH::ObjectID object, const Renderer& renderer, const Culling::Frustum& frustum)
+    {
+        ModelRenderer& model = object == Object ? mObjectModel : object == Ground ? mGroundModel : mLightModel;
+        Shader& shader = object == Light ? mLightShader : mModelShader;
+        const glm::mat4& modelMatrix = mDrawnState->objectMatrices[object];
+
+        shader.Bind();
+
+        if (object == Light)
+        {
+            mLightShader.SetUniform3f("u_LightColor", mDrawnState->lightColor.x, mDrawnState->lightColor.y, mDrawnState->lightColor.z);
+        }
+        else
+        {
+            mModelShader.SetUniformMat4f("u_Model", modelMatrix);
+            mModelShader.SetUniformMat3f("u_NormalMatrix", mDrawnState->normalMatrices[object]);
+        }
+
+        shader.SetUniformMat4f("u_MVP", mDrawnState->mvps[object]);
+
+        if (fEnableFrustumCulling)
+            model.Draw(renderer, shader, modelMatrix, frustum);
+        else
+            model.Draw(renderer, shader);
+
+        model.RequestMips(modelMatrix, mDrawnState->cameraPosition, mDrawnState->pixelsPerUnit, fEnableFrustumCulling);
+    }
+
+    void SceneRenderer::QueryBoundingBox(SceneBVH::ObjectID object, const glm::mat4& viewProj)
+    {
+        /* Slightly larger, flat objects (the ground) would otherwise give a zero-height box. */
+        const CommonUtils::BBCoord& bounds = mObjectBounds[object];
+        const glm::vec3 margin = 0.01f * (bounds.Max - bounds.Min) + 0.01f;
+        const glm::mat4 boxMatrix = glm::scale(glm::translate(glm::mat4(1.0f), bounds.Min - margin), bounds.Max - bounds.Min + 2.0f * margin);
+
+        GLCall(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+        GLCall(glDepthMask(GL_FALSE));
+
+        mBoundingBoxShader.Bind();
+        mBoundingBoxShader.SetUniformMat4f("u_MVP", viewProj * boxMatrix);
+
+        /* Drawn directly, proxies are counted as queries and must not show up as draw calls or triangles. */
+        mUnitCube.Bind();
+        mOcclusionQueries[object].Begin();
+        GLCall(glDrawElements(GL_TRIANGLES, mUnitCube.GetIndicesCount(), GL_UNSIGNED_INT, nullptr));
+        mOcclusionQueries[object].End();
+
+        GLCall(glDepthMask(GL_TRUE));
+        GLCall(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+    }
+}
@@ -0,0 +1,215 @@
+//
+//  SceneRenderHelper.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef SceneRenderHelper_hpp
+#define SceneRenderHelper_hpp
+
+#include "ModelRendererHelper.hpp"
+#include "ClusteredLighting.hpp"
+#include "CommonUtils.hpp"
+#include "Frustum.hpp"
+#include "OcclusionCulling.hpp"
+#include "OcclusionQuery.hpp"
+#include "SceneBVH.hpp"
+#include "ShadowMap.hpp"
+#include "Renderer.hpp"
+#include "Shader.hpp"
+#include "TextureStreamer.hpp"
+
+#include <string>
+
+namespace Helper
+{
+    /* What a frame of the scene is drawn from, see SceneRenderer::Prepare. */
+    struct SceneState
+    {
+        unsigned long long sequence = 0;    /* Of the input it was prepared from, see ScenePipeline. */
+
+        glm::mat4 proj{1.0f};
+        glm::mat4 view{1.0f};
+        glm::vec3 cameraPosition{};
+        int       width  = 0;
+        int       height = 0;
+        float     pixelsPerUnit = 0.0f;     /* For texture residency, see ModelRenderer::RequestMips. */
+
+        glm::mat4 objectMatrices[3];        /* Object, ground and light. */
+        glm::mat3 normalMatrices[3];
+        glm::mat4 mvps[3];
+        glm::vec3 lightColor{1.0f};
+        bool      enableDirectionalLight = true;
+        glm::vec3 directionalLightDirection{0.0f, 1.0f, 0.0f};
+
+        std::vector<Lighting::PointLight> pointLights;
+        Lighting::ClusterGrid             lightClusters;    /* Built, uploaded by the Draw. */
+    };
+
+    /* The viewer's scene (object on a ground plane, lit by a movable point light), shared by the app and the benchmarks. */
+    class SceneRenderer
+    {
+    private:
+        /* Before the models, their textures cancel with it on destruction. */
+        TextureStreamer mTextureStreamer;
+
+        ModelRenderer mGroundModel;
+        ModelRenderer mObjectModel;
+        ModelRenderer mLightModel;
+
+        Shader mModelShader;
+        Shader mLightShader;
+        Shader mBoundingBoxShader;
+        Shader mShadowDepthShader;
+
+        CommonUtils::BBCoord mLightObjectBB;
+        CommonUtils::BBCoord mModelObjectBB;
+        CommonUtils::BBCoord mGroundObjectBB;
+        CommonUtils::BBCoord mUnionizedBB;
+
+        glm::vec3 mInitialLightPosition;
+
+        /* Scene objects by BVH object id. */
+        enum SceneObject : SceneBVH::ObjectID
+        {
+            Object = 0,
+            Ground,
+            Light,
+            SceneObjectCount
+        };
+
+        SceneBVH                          mObjectBVH;
+        std::vector<CommonUtils::BBCoord> mObjectBounds;
+        std::vector<SceneBVH::ObjectID>   mVisibleObjects;
+        std::vector<unsigned char>        mObjectVisible;
+
+        /* Ground as is, the object through a clustered LOD. The light is too small to hide anything. */
+        Culling::Occluder        mGroundOccluder;
+        Culling::Occluder        mObjectOccluder;
+        Culling::DepthRasterizer mOcclusionRasterizer;
+
+        /* Objects found visible are trusted this many frames before their box is queried again. */
+        static constexpr unsigned int kRequeryInterval = 8;
+
+        VertexArray    mUnitCube;
+        OcclusionQuery mOcclusionQueries[SceneObjectCount];
+        unsigned int   mFramesSinceQuery[SceneObjectCount] = {};
+
+        /* As of the last Draw, for picking and the shadow cache. */
+        glm::mat4      mObjectMatrices[SceneObjectCount];
+
+        static constexpr unsigned int kShadowMapSlot = 4;   /* Above the material textures. */
+
+        CascadedShadowMap mShadowMap;
+        GpuTimer          mShadowTimer;
+        bool              mShadowCacheStale = false;   /* Shadow passes were skipped, casters may have moved. */
+
+        /* Point lights, texture buffers right after the shadow map. */
+        static constexpr unsigned int kLightsSlot       = 5;
+        static constexpr unsigned int kLightGridSlot    = 6;
+        static constexpr unsigned int kLightIndicesSlot = 7;
+
+        /* For the Draw that prepares its own state. The last drawn one has the light clusters shown in the GUI. */
+        SceneState        mState;
+        const SceneState* mDrawnState = &mState;
+
+        void RenderShadowMaps(const Renderer& renderer, const SceneState& state, bool castersMoved, const CommonUtils::BBCoord& movedBounds);
+
+        /* With the matrices of the state being drawn. */
+        void DrawObject(SceneBVH::ObjectID object, const Renderer& renderer, const Culling::Frustum& frustum);
+        void QueryBoundingBox(SceneBVH::ObjectID object, const glm::mat4& viewProj);
+
+        void UpdateObjectBounds(const glm::mat4& objectMatrix, const glm::mat4& groundMatrix, const glm::mat4& lightMatrix);
+        /* Node transforms of the models. Where nodes moved: their bounds, the occluders built from them, the cached shadows. */
+        void UpdateModelTransforms();
+
+    public:
+        struct PickHit
+        {
+            SceneBVH::ObjectID object;
+            unsigned int       mesh;
+            unsigned int       triangle;    /* Within the mesh, index into mIndices / 3. */
+            float              distance;    /* From the camera, world units. */
+            glm::vec3          position;
+        };
+
+        struct TextureMemory
+        {
+            size_t bytes;
+            size_t uncompressedBytes;
+        };
+
+        /* The f members the state of a frame is prepared from, copied so the GUI can go on changing them. */
+        struct Settings
+        {
+            CommonUtils::ModelMatrix          objectModelMatrix;
+            CommonUtils::ModelMatrix          lightModelMatrix;
+            CommonUtils::ModelMatrix          groundModelMatrix;
+            glm::vec3                         lightPosition{};      /* Light model's center, before its model matrix. */
+            glm::vec3                         lightColor{1.0f};
+            std::vector<Lighting::PointLight> extraLights;
+            bool                              enableDirectionalLight = true;
+            glm::vec3                         directionalLightDirection{0.0f, 1.0f, 0.0f};
+        };
+
+        /* resourceRoot is the path of the res/ directory, with a trailing slash. */
+        SceneRenderer(const std::string& resourceRoot, bool compressTextures = true, bool cacheTextures = true);
+        ~SceneRenderer();
+
+        /* Prepares and draws in one go, into the current viewport. */
+        void Draw(const Renderer& renderer, const glm::mat4& proj, const glm::mat4& view, const glm::vec3& cameraPosition);
+        /*
+         * The CPU side of a frame: object matrices, point lights and their clusters. No GL and no renderer, so any
+         * thread can prepare the next frame while this one is drawn (see ScenePipeline), and cpu_bench times it.
+         */
+        static void Prepare(const Settings& settings, const glm::mat4& proj, const glm::mat4& view, const glm::vec3& cameraPosition,
+                            int width, int height, SceneState& state);
+        /* The GL side, on the GL thread. The state must stay untouched until the next Draw. */
+        void Draw(const Renderer& renderer, SceneState& state);
+        /* Also places the ground under the object and brings the model matrix caches up to date, for the copies. */
+        Settings GetSettings();
+
+        glm::vec3 GetLookAtCenter() const;
+        const SceneBVH& GetObjectBVH() const { return mObjectBVH; }
+
+        /* Closest triangle under a point on screen (NDC, y up), objects as placed by the last Draw. */
+        bool Pick(const glm::vec2& ndc, const glm::mat4& proj, const glm::mat4& view, PickHit& hit) const;
+        static const char* GetObjectName(SceneBVH::ObjectID object);
+
+        /* GPU time of the last measured shadow pass, cached cascades cost nothing. */
+        float GetShadowMilliseconds() const { return mShadowTimer.GetMilliseconds(); }
+
+        /* Textures still decoding or uploading, they show a placeholder meanwhile. */
+        size_t GetPendingTextureCount() const { return mTextureStreamer.GetPendingCount(); }
+        TextureStreamer& GetTextureStreamer() { return mTextureStreamer; }
+        /* Per object, for objects 0 .. GetObjectCount() - 1. */
+        TextureMemory GetTextureMemory(SceneBVH::ObjectID object) const;
+        /* Texture arrays of the object, with their residency. */
+        const MaterialTable& GetMaterials(SceneBVH::ObjectID object) const;
+        static SceneBVH::ObjectID GetObjectCount() { return SceneObjectCount; }
+
+        const Lighting::ClusterGrid& GetLightClusters() const { return mDrawnState->lightClusters; }
+        /* Replaces fExtraLights with count small colored lights over the ground, same layout for the same count. */
+        void ScatterExtraLights(unsigned int count);
+
+        /* Translation, Scale, Rotation to object, Model Matrix. Local to World coordinates. Tweaked from the GUI. */
+        CommonUtils::ModelMatrix fObjectModelMatrix;
+        CommonUtils::ModelMatrix fLightModelMatrix;
+        CommonUtils::ModelMatrix fGroundModelMatrix;
+
+        glm::vec3 fLightColor{1.0f, 1.0f, 1.0f};
+        /* Point lights besides the movable one, world space. Not drawn, they only light the scene. */
+        std::vector<Lighting::PointLight> fExtraLights;
+        bool      fEnableDirectionalLight = true;
+        glm::vec3 fDirectionalLightDirection{0.0f, 1.0f, 0.0f};    /* Towards the light. */
+        bool      fEnableShadows          = true;
+        bool      fEnableShadowCache      = true;
+        bool      fEnableFrustumCulling   = true;
+        bool      fEnableOcclusionCulling = false;
+        bool      fEnableOcclusionQueries = false;
+    };
+}
+
+#endif /* SceneRenderHelper_hpp */
@@ -8,6 +8,7 @@
 
 #include "Shader.hpp"
 #include "ErrorHandler.hpp"
+#include "Profiler.hpp"
 #include <fstream>
 #include <string>
 #include <sstream>
@@ -20,11 +21,13 @@ Shader::Shader(const std::string& filePath)
 {
     ShaderProgramSource source = ParseShader(filePath);
     mRendererId  = CreateShader(source.VertexSource, source.FragmentSource);
+    mResource    = GLResources::Register(GLResources::Type::Shader, mRendererId, 0, filePath, GL_RESOURCE_SITE);
 }
 
 Shader::~Shader()
 {
     GLCall(glDeleteProgram(mRendererId));
+    GLResources::Release(mResource);
 }
 
 ShaderProgramSource Shader::ParseShader(const std::string& filePath)
@@ -58,6 +61,7 @@ ShaderProgramSource Shader::ParseShader(const std::string& filePath)
 
 unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 {
+    PROFILE_SCOPE("Shader::CompileShader");
     GLCall(unsigned int id = glCreateShader(type));
 
     const char* src = source.c_str();
@@ -89,6 +93,7 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 
 unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
 {
+    PROFILE_SCOPE("Shader::CreateShader");
     GLCall(unsigned int program = glCreateProgram());
 
     GLCall(unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader));
@@ -168,6 +173,11 @@ void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2,
     GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
 }
 
+void Shader::SetUniformMat3f(const std::string& name, const glm::mat3& mat)
+{
+    GLCall(glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]));
+}
+
 void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& mat)
 {
     GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]));
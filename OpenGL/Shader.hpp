@@ -10,6 +10,7 @@
 #define Shader_hpp
 
 #include <string>
+#include <vector>
 #include <unordered_map>
 #include <deque>
 #include <map>
@@ -17,6 +18,7 @@
 #include "glm.hpp"
 #include "gtc/matrix_transform.hpp"
 #include "Texture.hpp"
+#include "GLResources.hpp"
 
 struct ShaderProgramSource {
     std::string VertexSource;
@@ -27,6 +29,7 @@ class Shader {
 private:
     std::string mFilePath;
     unsigned int mRendererId;
+    GLResources::Handle mResource;
     std::unordered_map<std::string, int> mUniformLocationCache;
     std::deque<Texture> mTextures;
     std::map<std::string, std::string> mTexturePathToUniform;
@@ -44,11 +47,14 @@ public:
     void SetUniform2f(const std::string& name, float v0, float v1);
     void SetUniform3f(const std::string& name, float v0, float v1, float v2);
     void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
+    void SetUniformMat3f(const std::string& name, const glm::mat3& );
     void SetUniformMat4f(const std::string& name, const glm::mat4& );
     void SetUniformVec2f(const std::string& name, const std::vector<glm::vec2>& vec);
 
+    /* Splits a .shader file into its vertex and fragment sources. No GL calls. */
+    static ShaderProgramSource ParseShader(const std::string& filePath);
+
 private:
-    ShaderProgramSource ParseShader(const std::string& filePath);
     unsigned int CompileShader(unsigned int type, const std::string& source);
     unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
 
@@ -0,0 +1,183 @@
+//
+//  ShadowMap.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "ShadowMap.hpp"
+#include "ErrorHandler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+CascadedShadowMap::CascadedShadowMap(int resolution): mResolution(resolution)
+{
+    GLCall(glGenTextures(1, &mTextureId));
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, mTextureId));
+    GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, mResolution, mResolution, kCascades, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr));
+
+    /* Linear filtering with compare mode gives 2x2 PCF for free. Outside the map is lit. */
+    const float border[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER));
+    GLCall(glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL));
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+
+    GLCall(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &mPreviousFramebuffer));
+    GLCall(glGenFramebuffers(1, &mFramebufferId));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, mFramebufferId));
+    GLCall(glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mTextureId, 0, 0));
+    GLCall(glDrawBuffer(GL_NONE));
+    GLCall(glReadBuffer(GL_NONE));
+
+    ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, mPreviousFramebuffer));
+
+    mTextureResource     = GLResources::Register(GLResources::Type::Texture, mTextureId, static_cast<size_t>(mResolution) * mResolution * kCascades * 4,
+                                                 "shadow cascades", GL_RESOURCE_SITE);
+    mFramebufferResource = GLResources::Register(GLResources::Type::Framebuffer, mFramebufferId, 0, "shadow cascades", GL_RESOURCE_SITE);
+}
+
+CascadedShadowMap::~CascadedShadowMap()
+{
+    GLCall(glDeleteFramebuffers(1, &mFramebufferId));
+    GLCall(glDeleteTextures(1, &mTextureId));
+
+    GLResources::Release(mFramebufferResource);
+    GLResources::Release(mTextureResource);
+}
+
+void CascadedShadowMap::Fit(const glm::mat4& proj, const glm::mat4& view, const glm::vec3& lightDirection, const CommonUtils::BBCoord& casterBounds)
+{
+    /* Camera planes back from a glm::perspective matrix. */
+    const float cameraNear = proj[3][2] / (proj[2][2] - 1.0f);
+    const float cameraFar  = proj[3][2] / (proj[2][2] + 1.0f);
+    const float shadowFar  = std::min(cameraFar, fShadowDistance);
+
+    const glm::mat4 inverseViewProj = glm::inverse(proj * view);
+    glm::vec3 nearCorners[4], farCorners[4];
+    for (int corner = 0; corner < 4; corner++)
+    {
+        const glm::vec2 ndc((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f);
+        const glm::vec4 nearPoint = inverseViewProj * glm::vec4(ndc, -1.0f, 1.0f);
+        const glm::vec4 farPoint  = inverseViewProj * glm::vec4(ndc,  1.0f, 1.0f);
+        nearCorners[corner] = glm::vec3(nearPoint) / nearPoint.w;
+        farCorners[corner]  = glm::vec3(farPoint) / farPoint.w;
+    }
+
+    /* Points along a corner ray are linear in view depth. */
+    auto sliceCorner = [&](int corner, float depth) {
+        return glm::mix(nearCorners[corner], farCorners[corner], (depth - cameraNear) / (cameraFar - cameraNear));
+    };
+
+    /* Only the light's direction matters, so this view does not follow the camera. */
+    const glm::vec3 towardsLight = glm::normalize(lightDirection);
+    const glm::vec3 up = std::abs(towardsLight.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), -towardsLight, up);
+
+    float minZ = std::numeric_limits<float>::max(), maxZ = -std::numeric_limits<float>::max();
+    for (int corner = 0; corner < 8; corner++)
+    {
+        const glm::vec3 point((corner & 1) ? casterBounds.Max.x : casterBounds.Min.x,
+                              (corner & 2) ? casterBounds.Max.y : casterBounds.Min.y,
+                              (corner & 4) ? casterBounds.Max.z : casterBounds.Min.z);
+        const float z = (lightView * glm::vec4(point, 1.0f)).z;
+        minZ = std::min(minZ, z);
+        maxZ = std::max(maxZ, z);
+    }
+
+    float sliceNear = cameraNear;
+    for (int cascade = 0; cascade < kCascades; cascade++)
+    {
+        /* Practical split scheme, mostly logarithmic. */
+        const float fraction    = float(cascade + 1) / kCascades;
+        const float logarithmic = cameraNear * std::pow(shadowFar / cameraNear, fraction);
+        const float uniform     = cameraNear + (shadowFar - cameraNear) * fraction;
+        const float sliceFar    = glm::mix(uniform, logarithmic, 0.75f);
+
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        for (int corner = 0; corner < 4; corner++)
+        {
+            corners[corner]     = sliceCorner(corner, sliceNear);
+            corners[corner + 4] = sliceCorner(corner, sliceFar);
+            center += corners[corner] + corners[corner + 4];
+        }
+        center /= 8.0f;
+
+        /* Radius only depends on the projection, rounded so it does not flicker with the camera rotation. */
+        float radius = 0.0f;
+        for (const auto& corner: corners)
+            radius = std::max(radius, glm::length(corner - center));
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        /* Snap in whole texels, in steps of the margin: the box stays put until the sphere would leave it. */
+        const float halfSize = radius * (1.0f + fCacheMargin);
+        const float texel    = 2.0f * halfSize / mResolution;
+        const float step     = std::max(1.0f, std::floor(radius * fCacheMargin / texel)) * texel;
+
+        const glm::vec3 lightCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+        const glm::vec2 snapped = glm::floor(glm::vec2(lightCenter) / step + 0.5f) * step;
+
+        const glm::mat4 lightProj = glm::ortho(snapped.x - halfSize, snapped.x + halfSize, snapped.y - halfSize, snapped.y + halfSize,
+                                               -maxZ - 1.0f, -minZ + 1.0f);
+
+        mCascades[cascade].viewProj = lightProj * lightView;
+        mCascades[cascade].split    = sliceFar;
+        sliceNear = sliceFar;
+    }
+}
+
+bool CascadedShadowMap::NeedsRender(int cascade) const
+{
+    const Cascade& entry = mCascades[cascade];
+    return !entry.valid || entry.viewProj != entry.renderedViewProj;
+}
+
+void CascadedShadowMap::BeginCascade(int cascade)
+{
+    if (!mActive)
+    {
+        GLCall(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &mPreviousFramebuffer));
+        GLCall(glGetIntegerv(GL_VIEWPORT, mViewPort));
+
+        GLCall(glBindFramebuffer(GL_FRAMEBUFFER, mFramebufferId));
+        GLCall(glViewport(0, 0, mResolution, mResolution));
+
+        /* Slope scaled bias against acne. */
+        GLCall(glEnable(GL_POLYGON_OFFSET_FILL));
+        GLCall(glPolygonOffset(2.0f, 4.0f));
+        mActive = true;
+    }
+
+    GLCall(glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mTextureId, 0, cascade));
+    GLCall(glClear(GL_DEPTH_BUFFER_BIT));
+
+    mCascades[cascade].renderedViewProj = mCascades[cascade].viewProj;
+    mCascades[cascade].valid = true;
+}
+
+void CascadedShadowMap::End()
+{
+    if (!mActive)
+        return;
+
+    GLCall(glDisable(GL_POLYGON_OFFSET_FILL));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, mPreviousFramebuffer));
+    GLCall(glViewport(mViewPort[0], mViewPort[1], mViewPort[2], mViewPort[3]));
+    mActive = false;
+}
+
+void CascadedShadowMap::Bind(unsigned int slot) const
+{
+    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, mTextureId));
+}
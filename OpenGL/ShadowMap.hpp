@@ -0,0 +1,73 @@
+//
+//  ShadowMap.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef ShadowMap_hpp
+#define ShadowMap_hpp
+
+#include "CommonUtils.hpp"
+#include "GLResources.hpp"
+
+/*
+ * Cascaded shadow map for a directional light, one depth array layer per cascade. Cascades are fitted to a sphere
+ * around their slice of the camera frustum, with some margin, and only move in steps of that margin. A layer is
+ * therefore valid for many frames and is only re-rendered when its matrix changed or it was invalidated.
+ */
+class CascadedShadowMap
+{
+public:
+    static constexpr int kCascades = 3;
+
+    explicit CascadedShadowMap(int resolution = 2048);
+    ~CascadedShadowMap();
+
+    CascadedShadowMap(const CascadedShadowMap&) = delete;
+    CascadedShadowMap& operator=(const CascadedShadowMap&) = delete;
+
+    /* lightDirection points towards the light. Depth range covers casterBounds. */
+    void Fit(const glm::mat4& proj, const glm::mat4& view, const glm::vec3& lightDirection, const CommonUtils::BBCoord& casterBounds);
+
+    /* Layer out of date: never rendered, matrix moved, or invalidated. */
+    bool NeedsRender(int cascade) const;
+    void Invalidate(int cascade) { mCascades[cascade].valid = false; }
+
+    /* Render target for one layer, depth cleared. End() restores the previous framebuffer and viewport. */
+    void BeginCascade(int cascade);
+    void End();
+
+    void Bind(unsigned int slot) const;
+
+    const glm::mat4& GetViewProj(int cascade) const { return mCascades[cascade].viewProj; }
+    /* Far end of the cascade, distance along the view direction. */
+    float GetSplit(int cascade) const { return mCascades[cascade].split; }
+
+    /* Shadows end here, or at the camera far plane if that is closer. */
+    float fShadowDistance = 120.0f;
+    /* Cascade boxes are this much larger than their sphere, and snap in steps of it. */
+    float fCacheMargin = 0.25f;
+
+private:
+    struct Cascade
+    {
+        glm::mat4 viewProj{1.0f};
+        glm::mat4 renderedViewProj{1.0f};
+        float     split = 0.0f;
+        bool      valid = false;
+    };
+
+    int          mResolution;
+    unsigned int mTextureId{};
+    unsigned int mFramebufferId{};
+    GLResources::Handle mTextureResource{};
+    GLResources::Handle mFramebufferResource{};
+    int          mPreviousFramebuffer{};
+    int          mViewPort[4]{};
+    bool         mActive = false;
+    Cascade      mCascades[kCascades];
+};
+
+#endif /* ShadowMap_hpp */
@@ -8,19 +8,45 @@
 
 #include "Texture.hpp"
 #include "ErrorHandler.hpp"
+#include "Profiler.hpp"
+#include "TextureStreamer.hpp"
 #include "stb_image.h"
+#include <algorithm>
 #include <fstream>
 
-Texture::Texture(unsigned int width, unsigned int height, unsigned int channels): mWidth(width), mHeight(height), mChannels(channels)
+unsigned int Texture::GetFormat(int channels)
 {
-    if (mChannels == 1)
-        mFormat = GL_RED;
-    else if (mChannels == 3)
-        mFormat = GL_RGB;
-    else if (mChannels == 4)
-        mFormat = GL_RGBA;
+    if (channels == 1)
+        return GL_RED;
+    else if (channels == 2)
+        return GL_RG;
+    else if (channels == 3)
+        return GL_RGB;
+    else if (channels == 4)
+        return GL_RGBA;
     else
         throw std::runtime_error("Bad Channel!");
+}
+
+bool Texture::IsCompressedFormat(unsigned int internalFormat)
+{
+    return internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ||
+           internalFormat == GL_COMPRESSED_RED_RGTC1 || internalFormat == GL_COMPRESSED_RG_RGTC2;
+}
+
+size_t Texture::GetLevelByteSize(unsigned int internalFormat, int channels, int width, int height)
+{
+    if (!IsCompressedFormat(internalFormat))
+        return static_cast<size_t>(width) * height * channels;
+
+    const size_t blockBytes = internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || internalFormat == GL_COMPRESSED_RED_RGTC1 ? 8 : 16;
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+}
+
+Texture::Texture(unsigned int width, unsigned int height, unsigned int channels): mWidth(width), mHeight(height), mChannels(channels)
+{
+    mFormat = mInternalFormat = GetFormat(mChannels);
+    mByteSize = static_cast<size_t>(mWidth) * mHeight * mChannels;
     
     GLCall(glGenTextures(1, &mRendererId));
     GLCall(glBindTexture(GL_TEXTURE_2D, mRendererId));
@@ -28,42 +54,100 @@ Texture::Texture(unsigned int width, unsigned int height, unsigned int channels)
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
     GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+
+    mResource = GLResources::Register(GLResources::Type::Texture, mRendererId, mByteSize, "render target", GL_RESOURCE_SITE);
 }
 
-Texture::Texture(const std::string& path):mRendererId(0), mFilePath(path), mLocalBuffer(nullptr), mWidth(0), mHeight(0), mChannels(0)
+Texture::Texture(const std::string& path, bool srgb):mRendererId(0), mFilePath(path), mLocalBuffer(nullptr), mWidth(0), mHeight(0), mChannels(0), mSRGB(srgb)
 {
     std::ifstream f(path.c_str());
     ASSERT(f.good());
-    
-    stbi_set_flip_vertically_on_load(true);
-    mLocalBuffer = stbi_load(path.c_str(), &mWidth, &mHeight, &mChannels, 0);
-    
-    if (mChannels == 1)
-        mFormat = GL_RED;
-    else if (mChannels == 3)
-        mFormat = GL_RGB;
-    else if (mChannels == 4)
-        mFormat = GL_RGBA;
+
+    const TextureStreamer::Image image = TextureStreamer::Prepare(path, false, srgb, true);
+    if (image.IsEmpty())
+        throw std::runtime_error("Failed to load texture " + path);
+
+    mWidth    = image.width;
+    mHeight   = image.height;
+    mChannels = image.channels;
+    mFormat   = mInternalFormat = GetFormat(mChannels);
+    mLevels   = static_cast<int>(image.levels.size());
     
     GLCall(glGenTextures(1, &mRendererId));
     GLCall(glBindTexture(GL_TEXTURE_2D, mRendererId));
     
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mLevels - 1));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
     
-    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, mFormat, mWidth, mHeight, 0, mFormat, GL_UNSIGNED_BYTE, mLocalBuffer));
-    GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+    {
+        PROFILE_SCOPE("Texture::Upload");
+        GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+        for (size_t index = 0; index < image.levels.size(); index++)
+        {
+            const Mipmap::Level& level = image.levels[index];
+            GLCall(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(index), mFormat, level.width, level.height, 0, mFormat, GL_UNSIGNED_BYTE, image.chain + level.offset));
+        }
+        GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+        mByteSize = Mipmap::GetByteSize(image.levels, mChannels);
+    }
     GLCall(glBindTexture(GL_TEXTURE_2D, 0));
-    
-    if(mLocalBuffer)
-        stbi_image_free(mLocalBuffer);
+
+    mResource = GLResources::Register(GLResources::Type::Texture, mRendererId, mByteSize, path, GL_RESOURCE_SITE);
+}
+
+Texture::Texture(const std::string& path, TextureStreamer& streamer, bool srgb): mFilePath(path), mWidth(1), mHeight(1), mChannels(4), mFormat(GL_RGBA), mInternalFormat(GL_RGBA), mSRGB(srgb), mStreamer(&streamer)
+{
+    const unsigned char grey[4] = {128, 128, 128, 255};
+    mByteSize = sizeof(grey);
+
+    GLCall(glGenTextures(1, &mRendererId));
+    GLCall(glBindTexture(GL_TEXTURE_2D, mRendererId));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, mFormat, mWidth, mHeight, 0, mFormat, GL_UNSIGNED_BYTE, grey));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+
+    mResource = GLResources::Register(GLResources::Type::Texture, mRendererId, mByteSize, path, GL_RESOURCE_SITE);
+    streamer.Load(*this, path, srgb);
 }
 
 Texture::~Texture()
+{
+    if (mStreamer)
+        mStreamer->Cancel(*this);
+
+    GLCall(glDeleteTextures(1, &mRendererId));
+    GLResources::Release(mResource);
+}
+
+void Texture::Adopt(unsigned int rendererId, int width, int height, int channels, unsigned int internalFormat, int levels, int baseLevel, size_t byteSize)
 {
     GLCall(glDeleteTextures(1, &mRendererId));
+
+    mRendererId = rendererId;
+    mWidth      = width;
+    mHeight     = height;
+    mChannels   = channels;
+    mFormat     = GetFormat(channels);
+    mInternalFormat = internalFormat;
+    mLevels     = levels;
+    mBaseLevel  = baseLevel;
+    mByteSize   = byteSize;
+    mStreamer   = nullptr;
+
+    GLResources::SetName(mResource, mRendererId);
+    GLResources::SetByteSize(mResource, mByteSize);
+}
+
+size_t Texture::GetUncompressedByteSize() const
+{
+    size_t bytes = 0;
+    for (int level = mBaseLevel; level < mLevels; level++)
+        bytes += static_cast<size_t>(std::max(1, mWidth >> level)) * std::max(1, mHeight >> level) * mChannels;
+    return bytes;
 }
 
 void Texture::Bind(unsigned int slot) const
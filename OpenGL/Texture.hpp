@@ -10,8 +10,12 @@
 #ifndef Texture_hpp
 #define Texture_hpp
 
+#include "GLResources.hpp"
+
 #include <string>
 
+class TextureStreamer;
+
 class Texture
 {
 private:
@@ -20,11 +24,31 @@ private:
     unsigned char* mLocalBuffer{};
     int mWidth{}, mHeight{}, mChannels{};
     unsigned int mFormat{};
+    unsigned int mInternalFormat{};   /* mFormat, or the block format when compressed. */
+    int mLevels{1};                   /* Of the whole chain, */
+    int mBaseLevel{};                 /* of which the GL texture holds this one and the coarser ones. */
+    bool mSRGB{};
+    size_t mByteSize{};               /* GPU memory of the levels held, compressed or not. */
+    TextureStreamer* mStreamer{};     /* Set while the streamer still owes us the real image. */
+    GLResources::Handle mResource{};
+
+    friend class TextureStreamer;
+    /* Takes over the streamed texture, its tail or more, dropping the placeholder. width and height are of level 0. */
+    void Adopt(unsigned int rendererId, int width, int height, int channels, unsigned int internalFormat, int levels, int baseLevel, size_t byteSize);
     
 public:
-    Texture(const std::string& path);
+    /* With its mip chain, from the texture cache when there. Color textures are srgb, their mips filtered in linear light. */
+    Texture(const std::string& path, bool srgb = false);
+    /* 1x1 grey placeholder right away, the image follows once streamer has loaded it. */
+    Texture(const std::string& path, TextureStreamer& streamer, bool srgb = false);
     Texture(unsigned int width, unsigned int height, unsigned int channel);
     ~Texture();
+
+    /* GL_RED, GL_RG, GL_RGB or GL_RGBA by channel count. */
+    static unsigned int GetFormat(int channels);
+    /* One level of a GetFormat or BC format texture. */
+    static size_t GetLevelByteSize(unsigned int internalFormat, int channels, int width, int height);
+    static bool IsCompressedFormat(unsigned int internalFormat);
     
     const std::string& GetTexturePath() const;
 
@@ -33,7 +57,16 @@ public:
     
     inline int GetWidth() const { return mWidth;}
     inline int GetHeight() const { return mHeight;}
+    inline int GetChannels() const { return mChannels; }
+    inline unsigned int GetInternalFormat() const { return mInternalFormat; }
+    inline int GetLevelCount() const { return mLevels; }
+    inline int GetBaseLevel() const { return mBaseLevel; }
+    inline bool IsSRGB() const { return mSRGB; }
     inline int GetTextureID() const { return mRendererId;}
+    inline bool IsLoaded() const { return mStreamer == nullptr; }
+    inline size_t GetByteSize() const { return mByteSize; }
+    /* The same levels as plain 8 bit texels. */
+    size_t GetUncompressedByteSize() const;
     
 };
 #endif /* Texture_hpp */
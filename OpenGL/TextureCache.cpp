@@ -0,0 +1,133 @@
+//
+//  TextureCache.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "TextureCache.hpp"
+#include "Profiler.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    const int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return false;
+
+    struct stat info{};
+    if (fstat(descriptor, &info) != 0 || info.st_size == 0)
+    {
+        close(descriptor);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    mData = static_cast<const unsigned char*>(data);
+    mSize = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (mData)
+        munmap(const_cast<unsigned char*>(mData), mSize);
+
+    mData = nullptr;
+    mSize = 0;
+}
+
+namespace TextureCache
+{
+    std::uint64_t HashFile(const std::string& path)
+    {
+        PROFILE_FUNCTION();
+
+        MappedFile file;
+        if (!file.Open(path))
+            return 0;
+
+        std::uint64_t hash = 14695981039346656037ull;
+        for (size_t index = 0; index < file.GetSize(); index++)
+        {
+            hash ^= file.GetData()[index];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string GetPath(const std::string& source, std::uint64_t hash, const std::string& suffix)
+    {
+        const size_t slash = source.find_last_of('/');
+        const std::string directory = (slash == std::string::npos ? std::string() : source.substr(0, slash + 1)) + ".cache/";
+        mkdir(directory.c_str(), 0755);
+
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+        return directory + name + suffix;
+    }
+
+    bool WriteRaw(const std::string& path, const RawHeader& header, const unsigned char* chain, size_t bytes)
+    {
+        PROFILE_FUNCTION();
+
+        /* Written aside and renamed, a reader never maps half a file. */
+        const std::string partial = path + ".partial";
+        {
+            std::ofstream file(partial, std::ios::binary);
+            if (!file)
+                return false;
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(chain), bytes);
+            if (!file)
+                return false;
+        }
+
+        return std::rename(partial.c_str(), path.c_str()) == 0;
+    }
+
+    bool OpenRaw(const std::string& path, std::uint64_t sourceHash, MappedFile& file, RawHeader& header)
+    {
+        if (!file.Open(path) || file.GetSize() < sizeof(RawHeader))
+            return false;
+
+        std::memcpy(&header, file.GetData(), sizeof(header));
+        const RawHeader expected;
+        if (std::memcmp(header.magic, expected.magic, 4) != 0 || header.version != expected.version || header.sourceHash != sourceHash ||
+            header.channels < 1 || header.channels > 4 || header.width == 0 || header.height == 0)
+        {
+            file.Close();
+            return false;
+        }
+
+        const auto levels = Mipmap::Layout(static_cast<int>(header.width), static_cast<int>(header.height), static_cast<int>(header.channels));
+        if (file.GetSize() != sizeof(RawHeader) + Mipmap::GetByteSize(levels, static_cast<int>(header.channels)))
+        {
+            file.Close();
+            return false;
+        }
+
+        return true;
+    }
+}
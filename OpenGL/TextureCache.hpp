@@ -0,0 +1,71 @@
+//
+//  TextureCache.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef TextureCache_hpp
+#define TextureCache_hpp
+
+#include "Mipmap.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Read only view of a whole file, pages come in as they are touched. */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const unsigned char* GetData() const { return mData; }
+    size_t GetSize() const { return mSize; }
+
+private:
+    const unsigned char* mData = nullptr;
+    size_t               mSize = 0;
+};
+
+/*
+ * Texture caches live in a .cache directory next to the source file, named after a hash of the source contents,
+ * so an edited or replaced file never hits an old entry. Raw entries hold the decoded pixels and their whole mip
+ * chain exactly as uploaded: a header, then the levels of Mipmap::Layout.
+ */
+namespace TextureCache
+{
+    struct RawHeader
+    {
+        char          magic[4] = {'T', 'X', 'R', 'W'};
+        std::uint32_t version  = 1;
+        std::uint32_t width    = 0;
+        std::uint32_t height   = 0;
+        std::uint32_t channels = 0;
+        std::uint32_t srgb     = 0;
+        std::uint64_t sourceHash = 0;
+        std::uint8_t  padding[32] = {};     /* Levels start 64 byte aligned. */
+    };
+    static_assert(sizeof(RawHeader) == 64, "raw cache header layout");
+
+    /* 64 bit FNV-1a of the file, 0 when it can't be read. */
+    std::uint64_t HashFile(const std::string& path);
+
+    /* <dir>/.cache/<hash><suffix>, creating the directory. */
+    std::string GetPath(const std::string& source, std::uint64_t hash, const std::string& suffix);
+
+    bool WriteRaw(const std::string& path, const RawHeader& header, const unsigned char* chain, size_t bytes);
+
+    /* Maps the entry and checks it against the layout its header describes. Levels start at GetData() + sizeof(RawHeader). */
+    bool OpenRaw(const std::string& path, std::uint64_t sourceHash, MappedFile& file, RawHeader& header);
+}
+
+#endif /* TextureCache_hpp */
@@ -0,0 +1,716 @@
+//
+//  TextureStreamer.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "TextureStreamer.hpp"
+#include "ErrorHandler.hpp"
+#include "Profiler.hpp"
+#include "Texture.hpp"
+#include "ThreadPool.hpp"
+#include "stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    std::vector<TextureStreamer::Image> PrepareLayers(const std::vector<std::string>& paths, const std::vector<bool>& srgb, bool compress, bool useCache)
+    {
+        std::vector<TextureStreamer::Image> layers;
+        for (size_t layer = 0; layer < paths.size(); layer++)
+            layers.push_back(TextureStreamer::Prepare(paths[layer], compress, srgb[layer], useCache));
+        return layers;
+    }
+
+    /* The file may have changed since the array was built. */
+    bool Matches(const TextureStreamer::Image& image, const MaterialTable::Array& array)
+    {
+        if (image.IsEmpty() || image.width != array.width || image.height != array.height)
+            return false;
+
+        if (!image.compressed.levels.empty())
+            return BlockCompression::GetGLFormat(image.compressed.format) == array.internalFormat && static_cast<int>(image.compressed.levels.size()) == array.levels;
+
+        return Texture::GetFormat(image.channels) == array.internalFormat && static_cast<int>(image.levels.size()) == array.levels;
+    }
+}
+
+TextureStreamer::Image TextureStreamer::Decode(const std::string& path)
+{
+    PROFILE_SCOPE("Texture::Decode");
+
+    /* Per thread, decodes run on any worker and nobody else's setting can get in between. */
+    stbi_set_flip_vertically_on_load_thread(true);
+
+    Image image;
+    image.pixels = {stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0), stbi_image_free};
+    return image;
+}
+
+TextureStreamer::Image TextureStreamer::Prepare(const std::string& path, bool compress, bool srgb, bool useCache)
+{
+    PROFILE_SCOPE("Texture::Prepare");
+
+    /* Keyed by contents, an edited file misses instead of reading a stale entry. Unreadable sources hash to 0. */
+    const std::uint64_t hash = useCache ? TextureCache::HashFile(path) : 0;
+    const std::string cachePath = hash ? TextureCache::GetPath(path, hash, std::string(srgb ? ".srgb" : "") + (compress ? ".dds" : ".raw")) : std::string();
+
+    Image image;
+    if (hash && compress && BlockCompression::ReadDDS(cachePath, image.compressed))
+    {
+        image.width    = image.compressed.levels[0].width;
+        image.height   = image.compressed.levels[0].height;
+        image.channels = image.compressed.format == BlockCompression::Format::BC4 ? 1 : image.compressed.format == BlockCompression::Format::BC5 ? 2 :
+                         image.compressed.format == BlockCompression::Format::BC1 ? 3 : 4;
+        return image;
+    }
+
+    if (hash && !compress)
+    {
+        auto mapping = std::make_unique<MappedFile>();
+        TextureCache::RawHeader header;
+        if (TextureCache::OpenRaw(cachePath, hash, *mapping, header))
+        {
+            image.width    = static_cast<int>(header.width);
+            image.height   = static_cast<int>(header.height);
+            image.channels = static_cast<int>(header.channels);
+            image.levels   = Mipmap::Layout(image.width, image.height, image.channels);
+            image.chain    = mapping->GetData() + sizeof(header);
+            image.mapping  = std::move(mapping);
+            return image;
+        }
+    }
+
+    Image decoded = Decode(path);
+    if (!decoded.pixels)
+        return image;
+
+    image.width    = decoded.width;
+    image.height   = decoded.height;
+    image.channels = decoded.channels;
+    image.levels   = Mipmap::Layout(image.width, image.height, image.channels);
+    image.chainStorage.resize(Mipmap::GetByteSize(image.levels, image.channels));
+    std::memcpy(image.chainStorage.data(), decoded.pixels.get(), static_cast<size_t>(image.width) * image.height * image.channels);
+    decoded.pixels.reset();
+
+    /* Already on a worker, the other files keep the rest of the pool busy. */
+    Mipmap::Generate(image.chainStorage.data(), image.levels, image.channels, srgb, nullptr);
+
+    /* Read only resources just mean no cache. */
+    if (compress)
+    {
+        image.compressed = BlockCompression::Compress(image.chainStorage.data(), image.levels, image.channels,
+                                                      BlockCompression::ChooseFormat(image.channels), nullptr);
+        image.levels.clear();
+        image.chainStorage = {};
+
+        if (hash)
+            BlockCompression::WriteDDS(cachePath, image.compressed);
+        return image;
+    }
+
+    image.chain = image.chainStorage.data();
+    if (hash)
+    {
+        TextureCache::RawHeader header;
+        header.width      = static_cast<std::uint32_t>(image.width);
+        header.height     = static_cast<std::uint32_t>(image.height);
+        header.channels   = static_cast<std::uint32_t>(image.channels);
+        header.srgb       = srgb ? 1 : 0;
+        header.sourceHash = hash;
+        TextureCache::WriteRaw(cachePath, header, image.chain, image.chainStorage.size());
+    }
+    return image;
+}
+
+int TextureStreamer::GetTailLevel(int width, int height, int levels)
+{
+    int level = 0;
+    while (level < levels - 1 && std::max(width, height) >> level > kTailSize)
+        level++;
+    return level;
+}
+
+TextureStreamer::TextureStreamer(ThreadPool& pool, bool compress, bool useCache):
+    mPool(pool), mCompress(compress && GLEW_EXT_texture_compression_s3tc), mUseCache(useCache)
+{
+    GLCall(glGenBuffers(kRingSize, mPixelBuffers));
+    for (int buffer = 0; buffer < kRingSize; buffer++)
+        mPixelBufferResources[buffer] = GLResources::Register(GLResources::Type::Buffer, mPixelBuffers[buffer], 0, "texture upload ring", GL_RESOURCE_SITE);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    /* Decodes still running finish on their own, nobody reads their result. */
+    for (auto& job: mJobs)
+    {
+        if (job.target)
+        {
+            GLCall(glDeleteTextures(1, &job.target));
+        }
+    }
+
+    GLCall(glDeleteBuffers(kRingSize, mPixelBuffers));
+    for (const auto resource: mPixelBufferResources)
+        GLResources::Release(resource);
+}
+
+void TextureStreamer::Load(Texture& texture, const std::string& path, bool srgb)
+{
+    std::ifstream f(path.c_str());
+    ASSERT(f.good());
+
+    mJobs.push_back({&texture, path, srgb, {}, {}});
+
+    /* The entry stays until its CancelPrefetch calls, which prepare the file again if others still want it. */
+    const auto prefetch = mPrefetches.find({path, srgb});
+    if (prefetch != mPrefetches.end() && prefetch->second.decoding.valid())
+        mJobs.back().decoding = std::move(prefetch->second.decoding);
+    else if (mPool.GetThreadCount() > 0)
+    {
+        const bool compress = mCompress, useCache = mUseCache;
+        mJobs.back().decoding = mPool.Enqueue([path, compress, srgb, useCache] { return Prepare(path, compress, srgb, useCache); });
+    }
+}
+
+void TextureStreamer::Prefetch(const std::string& path, bool srgb)
+{
+    if (mPool.GetThreadCount() == 0)
+        return;
+
+    const auto found = mPrefetches.find({path, srgb});
+    if (found != mPrefetches.end())
+        found->second.wanted++;
+
+    Prefetched& prefetch = found != mPrefetches.end() ? found->second : mPrefetches[{path, srgb}];
+
+    if (!prefetch.decoding.valid())
+    {
+        const bool compress = mCompress, useCache = mUseCache;
+        prefetch.decoding = mPool.Enqueue([path, compress, srgb, useCache] { return Prepare(path, compress, srgb, useCache); });
+    }
+}
+
+void TextureStreamer::CancelPrefetch(const std::string& path, bool srgb)
+{
+    const auto prefetch = mPrefetches.find({path, srgb});
+    if (prefetch == mPrefetches.end())
+        return;
+
+    if (--prefetch->second.wanted == 0)
+        mPrefetches.erase(prefetch);
+    else if (!prefetch->second.decoding.valid())
+    {
+        /* Loaded by the one done with it, prepare it again for those still waiting. */
+        const bool compress = mCompress, useCache = mUseCache;
+        prefetch->second.decoding = mPool.Enqueue([path, compress, srgb, useCache] { return Prepare(path, compress, srgb, useCache); });
+    }
+}
+
+void TextureStreamer::Cancel(const Texture& texture)
+{
+    for (auto job = mJobs.begin(); job != mJobs.end(); ++job)
+    {
+        if (job->texture != &texture)
+            continue;
+
+        if (job->target)
+        {
+            GLCall(glDeleteTextures(1, &job->target));
+        }
+
+        mJobs.erase(job);
+        return;
+    }
+}
+
+void TextureStreamer::Track(MaterialTable& table)
+{
+    if (std::find(mTables.begin(), mTables.end(), &table) == mTables.end())
+        mTables.push_back(&table);
+}
+
+void TextureStreamer::Untrack(const MaterialTable& table)
+{
+    mRefinements.erase(std::remove_if(mRefinements.begin(), mRefinements.end(), [&](const Refinement& refinement) { return refinement.table == &table; }),
+                       mRefinements.end());
+    mTables.erase(std::remove(mTables.begin(), mTables.end(), &table), mTables.end());
+}
+
+int TextureStreamer::GetWantedLevel(const MaterialTable::Array& array) const
+{
+    const int tail = GetTailLevel(array.width, array.height, array.levels);
+    if (array.requestFrame == 0 || mFrame - array.requestFrame > kIdleFrames)
+        return tail;
+
+    return std::min(array.requestedLevel, tail);
+}
+
+bool TextureStreamer::IsRefining(const MaterialTable& table, size_t array) const
+{
+    return std::any_of(mRefinements.begin(), mRefinements.end(), [&](const Refinement& refinement) {
+        return refinement.table == &table && refinement.array == array;
+    });
+}
+
+size_t TextureStreamer::Update()
+{
+    PROFILE_FUNCTION();
+
+    mFrame++;
+    UpdateResidency();
+
+    if (mJobs.empty() && mRefinements.empty())
+        return 0;
+
+    size_t budget = fUploadBudget;
+    bool decodedInline = false;
+
+    /* Oldest first, but a texture still decoding doesn't hold up the ones behind it. */
+    for (auto job = mJobs.begin(); job != mJobs.end() && budget > 0;)
+    {
+        if (!job->decoded)
+        {
+            if (job->decoding.valid())
+            {
+                if (job->decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                {
+                    ++job;
+                    continue;
+                }
+
+                job->image = job->decoding.get();
+            }
+            else
+            {
+                if (decodedInline)
+                    break;
+
+                job->image = Prepare(job->path, mCompress, job->srgb, mUseCache);
+                decodedInline = true;
+            }
+
+            job->decoded = true;
+
+            if (job->image.IsEmpty())
+            {
+                std::cout << "Failed to load texture " << job->path << ", keeping the placeholder" << std::endl;
+                job = mJobs.erase(job);
+                continue;
+            }
+        }
+
+        const bool complete = job->image.compressed.levels.empty() ? Stream(*job, budget) : StreamCompressed(*job, budget);
+        if (complete)
+            job = mJobs.erase(job);
+        else
+            ++job;
+    }
+
+    /* Detail gets what the new textures left. */
+    for (auto refinement = mRefinements.begin(); refinement != mRefinements.end() && budget > 0;)
+    {
+        if (!refinement->prepared)
+        {
+            const MaterialTable::Array& array = refinement->table->GetArray(refinement->array);
+
+            if (refinement->preparing.valid())
+            {
+                if (refinement->preparing.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                {
+                    ++refinement;
+                    continue;
+                }
+
+                refinement->layers = refinement->preparing.get();
+            }
+            else
+            {
+                if (decodedInline)
+                    break;
+
+                refinement->layers = PrepareLayers(array.paths, array.srgb, mCompress, mUseCache);
+                decodedInline = true;
+            }
+
+            refinement->prepared = true;
+
+            if (!std::all_of(refinement->layers.begin(), refinement->layers.end(), [&](const Image& image) { return Matches(image, array); }))
+            {
+                std::cout << "Texture files of " << array.paths[0] << " no longer match, keeping its levels" << std::endl;
+                refinement->table->Pin(refinement->array);
+                refinement = mRefinements.erase(refinement);
+                continue;
+            }
+        }
+
+        if (Refine(*refinement, budget))
+            refinement = mRefinements.erase(refinement);
+        else
+            ++refinement;
+    }
+
+    return fUploadBudget - budget;
+}
+
+void TextureStreamer::UpdateResidency()
+{
+    PROFILE_FUNCTION();
+
+    mResidentBytes = mWantedBytes = mWaitingRequests = 0;
+    if (mTables.empty())
+        return;
+
+    for (const MaterialTable* table: mTables)
+        for (size_t index = 0; index < table->GetArrayCount(); index++)
+        {
+            const MaterialTable::Array& array = table->GetArray(index);
+            mResidentBytes += table->GetByteSize(index, array.residentLevel);
+            mWantedBytes   += table->GetByteSize(index, array.streamable ? GetWantedLevel(array) : array.residentLevel);
+        }
+
+    /* What is held plus what running refinements will add. */
+    size_t committed = mResidentBytes;
+    for (const auto& refinement: mRefinements)
+    {
+        const MaterialTable::Array& array = refinement.table->GetArray(refinement.array);
+        committed += refinement.table->GetByteSize(refinement.array, refinement.targetLevel) - refinement.table->GetByteSize(refinement.array, array.residentLevel);
+    }
+
+    if (committed > fVRAMBudget)
+        committed = Evict(committed, fVRAMBudget / 10 * 9, false);
+
+    struct Candidate
+    {
+        MaterialTable* table;
+        size_t         array;
+    };
+
+    std::vector<Candidate> candidates;
+    for (MaterialTable* table: mTables)
+        for (size_t index = 0; index < table->GetArrayCount(); index++)
+        {
+            const MaterialTable::Array& array = table->GetArray(index);
+            if (!array.streamable || GetWantedLevel(array) >= array.residentLevel || IsRefining(*table, index))
+                continue;
+
+            if (array.changeFrame && mFrame - array.changeFrame < kHysteresisFrames)
+                mWaitingRequests++;
+            else
+                candidates.push_back({table, index});
+        }
+
+    /* Most recently drawn first. */
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& first, const Candidate& second) {
+        return first.table->GetArray(first.array).requestFrame > second.table->GetArray(second.array).requestFrame;
+    });
+
+    for (const auto& candidate: candidates)
+    {
+        const MaterialTable::Array& array = candidate.table->GetArray(candidate.array);
+        const size_t resident = candidate.table->GetByteSize(candidate.array, array.residentLevel);
+        int level = GetWantedLevel(array);
+
+        const size_t wanted = candidate.table->GetByteSize(candidate.array, level) - resident;
+        if (committed + wanted > fVRAMBudget)
+            committed = Evict(committed, fVRAMBudget - std::min(wanted, fVRAMBudget), true);
+
+        /* As close to the wanted level as fits, nothing when not even the next one does. */
+        while (level < array.residentLevel && committed + candidate.table->GetByteSize(candidate.array, level) - resident > fVRAMBudget)
+            level++;
+
+        if (level == array.residentLevel)
+            continue;
+
+        committed += candidate.table->GetByteSize(candidate.array, level) - resident;
+        mRefinements.push_back({candidate.table, candidate.array, level});
+
+        if (mPool.GetThreadCount() > 0)
+        {
+            const bool compress = mCompress, useCache = mUseCache;
+            mRefinements.back().preparing = mPool.Enqueue([paths = array.paths, srgb = array.srgb, compress, useCache] {
+                return PrepareLayers(paths, srgb, compress, useCache);
+            });
+        }
+    }
+}
+
+size_t TextureStreamer::Evict(size_t committed, size_t target, bool excessOnly)
+{
+    struct Candidate
+    {
+        MaterialTable* table;
+        size_t         array;
+        bool           excess;      /* Holds levels finer than wanted. */
+    };
+
+    std::vector<Candidate> candidates;
+    for (MaterialTable* table: mTables)
+        for (size_t index = 0; index < table->GetArrayCount(); index++)
+        {
+            const MaterialTable::Array& array = table->GetArray(index);
+            if (!array.streamable || array.residentLevel >= GetTailLevel(array.width, array.height, array.levels) || IsRefining(*table, index))
+                continue;
+
+            if (array.changeFrame && mFrame - array.changeFrame < kHysteresisFrames)
+                continue;
+
+            const bool excess = array.residentLevel < GetWantedLevel(array);
+            if (excess || !excessOnly)
+                candidates.push_back({table, index, excess});
+        }
+
+    /* Unneeded detail first, then least recently drawn. */
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& first, const Candidate& second) {
+        if (first.excess != second.excess)
+            return first.excess;
+        return first.table->GetArray(first.array).requestFrame < second.table->GetArray(second.array).requestFrame;
+    });
+
+    for (const auto& candidate: candidates)
+    {
+        if (committed <= target)
+            break;
+
+        const MaterialTable::Array& array = candidate.table->GetArray(candidate.array);
+        const int resident = array.residentLevel;
+        const int level = candidate.excess ? GetWantedLevel(array) : resident + 1;
+        const size_t freed = candidate.table->GetByteSize(candidate.array, resident) - candidate.table->GetByteSize(candidate.array, level);
+
+        candidate.table->SetResidentLevel(candidate.array, level, mFrame);
+        mEvictedLevels += level - resident;
+        mResidentBytes -= freed;
+        committed      -= freed;
+    }
+
+    return committed;
+}
+
+bool TextureStreamer::Refine(Refinement& refinement, size_t& budget)
+{
+    MaterialTable& table = *refinement.table;
+    const MaterialTable::Array& array = table.GetArray(refinement.array);
+    const bool compressed = Texture::IsCompressedFormat(array.internalFormat);
+    const unsigned int format = Texture::GetFormat(array.channels);
+
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+    /* The level above the base, every layer, then it becomes the base. Same band rules as Stream(). */
+    while (array.residentLevel > refinement.targetLevel)
+    {
+        const int level = array.residentLevel - 1;
+        if (!refinement.filling)
+        {
+            table.AllocateLevel(refinement.array, level);
+            refinement.filling   = true;
+            refinement.nextLayer = refinement.nextRow = 0;
+        }
+
+        const Image& image = refinement.layers[refinement.nextLayer];
+        GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, array.name));
+
+        if (compressed)
+        {
+            const BlockCompression::Level& source = image.compressed.levels[level];
+            if (budget < source.data.size() && budget != fUploadBudget)
+            {
+                budget = 0;
+                break;
+            }
+
+            FillPixelBuffer(source.data.data(), source.data.size());
+            GLCall(glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, refinement.nextLayer, source.width, source.height, 1,
+                                             array.internalFormat, static_cast<GLsizei>(source.data.size()), nullptr));
+
+            budget -= std::min(budget, source.data.size());
+            refinement.nextLayer++;
+        }
+        else
+        {
+            const Mipmap::Level& source = image.levels[level];
+            const size_t rowBytes = static_cast<size_t>(source.width) * image.channels;
+            if (budget < rowBytes && budget != fUploadBudget)
+            {
+                budget = 0;
+                break;
+            }
+
+            const int rows = std::min(source.height - refinement.nextRow, static_cast<int>(std::max<size_t>(1, budget / rowBytes)));
+            const size_t bytes = rows * rowBytes;
+
+            FillPixelBuffer(image.chain + source.offset + refinement.nextRow * rowBytes, bytes);
+            GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, refinement.nextRow, refinement.nextLayer, source.width, rows, 1, format, GL_UNSIGNED_BYTE, nullptr));
+
+            budget -= std::min(budget, bytes);
+            refinement.nextRow += rows;
+            if (refinement.nextRow == source.height)
+            {
+                refinement.nextLayer++;
+                refinement.nextRow = 0;
+            }
+        }
+
+        if (refinement.nextLayer == array.layers)
+        {
+            table.SetResidentLevel(refinement.array, level, mFrame);
+            refinement.filling = false;
+            mRefinedLevels++;
+        }
+    }
+
+    GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+    GLCall(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+
+    return array.residentLevel <= refinement.targetLevel;
+}
+
+bool TextureStreamer::Stream(Job& job, size_t& budget)
+{
+    const Image& image = job.image;
+    const unsigned int format = Texture::GetFormat(image.channels);
+    const int levelCount = static_cast<int>(image.levels.size());
+    const int baseLevel = GetTailLevel(image.width, image.height, levelCount);
+
+    /* Only the tail, the finer levels are up to residency. */
+    if (!job.target)
+    {
+        GLCall(glGenTextures(1, &job.target));
+        GLCall(glBindTexture(GL_TEXTURE_2D, job.target));
+        for (int index = baseLevel; index < levelCount; index++)
+        {
+            GLCall(glTexImage2D(GL_TEXTURE_2D, index, format, image.levels[index].width, image.levels[index].height, 0, format, GL_UNSIGNED_BYTE, nullptr));
+        }
+        job.nextLevel = baseLevel;
+    }
+    else
+    {
+        GLCall(glBindTexture(GL_TEXTURE_2D, job.target));
+    }
+
+    /* Rows are tightly packed, RGB rows of odd width are not 4 byte aligned. */
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+    /* Level by level, each in bands. A whole row is the smallest band: go over budget by less than a row rather than stall on huge images. */
+    while (job.nextLevel < levelCount)
+    {
+        const Mipmap::Level& level = image.levels[job.nextLevel];
+        const size_t rowBytes = static_cast<size_t>(level.width) * image.channels;
+        if (budget < rowBytes && budget != fUploadBudget)
+        {
+            budget = 0;
+            break;
+        }
+
+        const int rows = std::min(level.height - job.nextRow, static_cast<int>(std::max<size_t>(1, budget / rowBytes)));
+        const size_t bytes = rows * rowBytes;
+
+        FillPixelBuffer(image.chain + level.offset + job.nextRow * rowBytes, bytes);
+        GLCall(glTexSubImage2D(GL_TEXTURE_2D, job.nextLevel, 0, job.nextRow, level.width, rows, format, GL_UNSIGNED_BYTE, nullptr));
+
+        budget -= std::min(budget, bytes);
+        job.nextRow += rows;
+        if (job.nextRow == level.height)
+        {
+            job.nextLevel++;
+            job.nextRow = 0;
+        }
+    }
+
+    GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+
+    const bool complete = job.nextLevel == levelCount;
+    if (complete)
+    {
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+        job.texture->Adopt(job.target, image.width, image.height, image.channels, format, levelCount, baseLevel,
+                           Mipmap::GetByteSize(image.levels, image.channels) - image.levels[baseLevel].offset);
+        job.target = 0;
+    }
+
+    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    return complete;
+}
+
+bool TextureStreamer::StreamCompressed(Job& job, size_t& budget)
+{
+    const BlockCompression::Image& image = job.image.compressed;
+    const unsigned int format = BlockCompression::GetGLFormat(image.format);
+    const int levelCount = static_cast<int>(image.levels.size());
+    const int baseLevel = GetTailLevel(job.image.width, job.image.height, levelCount);
+
+    if (!job.target)
+    {
+        GLCall(glGenTextures(1, &job.target));
+        job.nextLevel = baseLevel;
+    }
+    GLCall(glBindTexture(GL_TEXTURE_2D, job.target));
+
+    /* Whole levels, the first one of a frame may go over budget. */
+    while (job.nextLevel < levelCount)
+    {
+        const BlockCompression::Level& level = image.levels[job.nextLevel];
+        if (budget < level.data.size() && budget != fUploadBudget)
+        {
+            budget = 0;
+            break;
+        }
+
+        FillPixelBuffer(level.data.data(), level.data.size());
+        GLCall(glCompressedTexImage2D(GL_TEXTURE_2D, job.nextLevel, format, level.width, level.height, 0,
+                                      static_cast<GLsizei>(level.data.size()), nullptr));
+
+        job.nextLevel++;
+        budget -= std::min(budget, level.data.size());
+    }
+
+    GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+
+    const bool complete = job.nextLevel == levelCount;
+    if (complete)
+    {
+        size_t bytes = 0;
+        for (int level = baseLevel; level < levelCount; level++)
+            bytes += image.levels[level].data.size();
+
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+        job.texture->Adopt(job.target, job.image.width, job.image.height, job.image.channels, format, levelCount, baseLevel, bytes);
+        job.target = 0;
+    }
+
+    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    return complete;
+}
+
+void TextureStreamer::FillPixelBuffer(const unsigned char* data, size_t bytes)
+{
+    /* Round robin, and the store is orphaned first: the upload before may still be reading it. */
+    GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPixelBuffers[mNextBuffer]));
+    GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW));
+    GLResources::SetByteSize(mPixelBufferResources[mNextBuffer], bytes);
+    mNextBuffer = (mNextBuffer + 1) % kRingSize;
+
+    void* mapped = nullptr;
+    GLCall(mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    std::memcpy(mapped, data, bytes);
+    GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+}
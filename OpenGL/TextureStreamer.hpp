@@ -0,0 +1,182 @@
+//
+//  TextureStreamer.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef TextureStreamer_hpp
+#define TextureStreamer_hpp
+
+#include "BlockCompression.hpp"
+#include "GLResources.hpp"
+#include "MaterialTable.hpp"
+#include "Mipmap.hpp"
+#include "TextureCache.hpp"
+
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Texture;
+class ThreadPool;
+
+/*
+ * Loads textures without stalling the GL thread. Files are decoded on a thread pool, the pixels then go up through
+ * a ring of pixel buffer objects in bands of rows, at most fUploadBudget bytes per Update(). A texture keeps its
+ * placeholder until the last band of its last mip is in, then it switches over in one go.
+ *
+ * Workers build the whole mip chain (see Mipmap.hpp) and keep it in the texture cache, later loads map the cached
+ * chain and upload straight from the mapping with no decoding or filtering. With compression on, the cache holds
+ * the chain encoded to BC1/BC3/BC4/BC5 as DDS instead, and compressed textures go up a level at a time.
+ */
+class TextureStreamer
+{
+public:
+    static constexpr int kRingSize = 3;
+    static constexpr int kTailSize = 128;                       /* Texels, the levels up front. */
+    static constexpr unsigned long long kHysteresisFrames = 30;
+    static constexpr unsigned long long kIdleFrames = 120;      /* Not drawn for this long, the tail is enough. */
+
+    struct Image
+    {
+        std::unique_ptr<unsigned char, void(*)(void*)> pixels{nullptr, nullptr};     /* Decode() only. */
+        int width = 0, height = 0, channels = 0;
+
+        /* From Prepare(): the mip chain, owned or mapped from the cache, or the compressed levels instead. */
+        std::vector<Mipmap::Level>  levels;
+        const unsigned char*        chain = nullptr;
+        std::vector<unsigned char>  chainStorage;
+        std::unique_ptr<MappedFile> mapping;
+        BlockCompression::Image     compressed;
+
+        bool IsEmpty() const { return !chain && compressed.levels.empty(); }
+    };
+
+    /* Same flags as the Texture class, callable from any thread. Empty pixels when the file can't be read. */
+    static Image Decode(const std::string& path);
+    /*
+     * Mip chain ready to upload: from the cache on a hit, else decoded, filtered (in linear light with srgb), encoded
+     * with compress, and cached unless useCache is off.
+     */
+    static Image Prepare(const std::string& path, bool compress, bool srgb, bool useCache);
+
+    /* Finest level of the tail. */
+    static int GetTailLevel(int width, int height, int levels);
+
+    /*
+     * With no worker threads in the pool, files are prepared by Update(), one per call. Compression falls back to
+     * plain uploads when the context has no S3TC.
+     */
+    explicit TextureStreamer(ThreadPool& pool, bool compress = true, bool useCache = true);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /* Called by Texture, which must stay at the same address until it is loaded or destroyed. */
+    void Load(Texture& texture, const std::string& path, bool srgb);
+    /*
+     * Starts preparing a file on the pool ahead of its Load, which then picks up the result. No-op without workers.
+     * Counted per file: pair each Prefetch with a CancelPrefetch once its user is done (e.g. the model is drawn),
+     * whether it loaded the file or not. The last one drops a result no Load picked up, its decode runs to the end unread.
+     */
+    void Prefetch(const std::string& path, bool srgb);
+    void CancelPrefetch(const std::string& path, bool srgb);
+    void Cancel(const Texture& texture);
+
+    /* The table must stay at the same address until untracked, which it is before a rebuild or destruction. */
+    void Track(MaterialTable& table);
+    void Untrack(const MaterialTable& table);
+
+    /* Once per frame, on the GL thread, before the draws that request levels. Returns the bytes uploaded. */
+    size_t Update();
+    unsigned long long GetFrame() const { return mFrame; }
+
+    /* Level the array should hold: as requested, or the tail once it is idle. */
+    int GetWantedLevel(const MaterialTable::Array& array) const;
+
+    bool IsIdle() const { return GetPendingCount() == 0; }
+    bool IsCompressing() const { return mCompress; }
+    /* Textures loading, arrays refining and requests waiting to start. Requests over budget don't count. */
+    size_t GetPendingCount() const { return mJobs.size() + mRefinements.size() + mWaitingRequests; }
+
+    /* Of the tracked arrays, as of the last Update. */
+    size_t GetResidentBytes() const { return mResidentBytes; }
+    size_t GetWantedBytes() const { return mWantedBytes; }
+    size_t GetRefinedLevels() const { return mRefinedLevels; }
+    size_t GetEvictedLevels() const { return mEvictedLevels; }
+
+    size_t fUploadBudget = 4u << 20;
+    size_t fVRAMBudget   = 128u << 20;
+
+private:
+    struct Job
+    {
+        Texture*           texture;
+        std::string        path;
+        bool               srgb;
+        std::future<Image> decoding;        /* Not valid when prepared inline. */
+        Image              image;
+        bool               decoded   = false;
+        unsigned int       target    = 0;   /* Texture the bands go into, adopted by `texture` when complete. */
+        int                nextLevel = 0;
+        int                nextRow   = 0;
+    };
+
+    struct Prefetched
+    {
+        std::future<Image> decoding;    /* Not valid once a Load took it, until prepared again. */
+        unsigned int       wanted = 1;  /* Prefetch calls not yet matched by a CancelPrefetch. */
+    };
+
+    /* Finer levels for all layers of an array, filled a level at a time. */
+    struct Refinement
+    {
+        MaterialTable*                  table       = nullptr;
+        size_t                          array       = 0;
+        int                             targetLevel = 0;
+        std::future<std::vector<Image>> preparing   = {};   /* Not valid when prepared inline. */
+        std::vector<Image>              layers      = {};
+        bool                            prepared    = false;
+        bool                            filling     = false;    /* The level above the base is allocated. */
+        int                             nextLayer   = 0;
+        int                             nextRow     = 0;
+    };
+
+    /* Uploads bands of the job within budget, true once the texture is complete. */
+    bool Stream(Job& job, size_t& budget);
+    bool StreamCompressed(Job& job, size_t& budget);
+    /* Likewise, true once the array holds its target level or the refinement was dropped. */
+    bool Refine(Refinement& refinement, size_t& budget);
+    /* Starts and drops refinements, evicts over budget. */
+    void UpdateResidency();
+    /* Drops levels until committed is at most target, only those finer than wanted with excessOnly. */
+    size_t Evict(size_t committed, size_t target, bool excessOnly);
+    bool IsRefining(const MaterialTable& table, size_t array) const;
+    /* Copies into the next buffer of the ring, left bound to GL_PIXEL_UNPACK_BUFFER. */
+    void FillPixelBuffer(const unsigned char* data, size_t bytes);
+
+    ThreadPool&                 mPool;
+    bool                        mCompress;
+    bool                        mUseCache;
+    std::deque<Job>             mJobs;
+    std::deque<Refinement>      mRefinements;
+    std::map<std::pair<std::string, bool>, Prefetched> mPrefetches;
+    std::vector<MaterialTable*> mTables;
+    unsigned long long          mFrame = 0;
+    size_t                      mWaitingRequests = 0;
+    size_t                      mResidentBytes = 0;
+    size_t                      mWantedBytes = 0;
+    size_t                      mRefinedLevels = 0;
+    size_t                      mEvictedLevels = 0;
+    unsigned int                mPixelBuffers[kRingSize]{};
+    GLResources::Handle         mPixelBufferResources[kRingSize]{};
+    unsigned int                mNextBuffer = 0;
+};
+
+#endif /* TextureStreamer_hpp */
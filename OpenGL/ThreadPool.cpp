@@ -0,0 +1,114 @@
+//
+//  ThreadPool.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+ThreadPool::ThreadPool(unsigned int threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+    for (unsigned int index = 0; index < threads; index++)
+        mWorkers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+
+    mCondition.notify_all();
+
+    for (auto& worker: mWorkers)
+        worker.join();
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+
+            /* Drain the queue before stopping, futures handed out must complete. */
+            if (mTasks.empty())
+                return;
+
+            task = std::move(mTasks.front());
+            mTasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body)
+{
+    grain = std::max<size_t>(1, grain);
+    const size_t chunks = (count + grain - 1) / grain;
+    if (chunks == 0)
+        return;
+
+    if (chunks == 1 || mWorkers.empty())
+    {
+        body(0, count);
+        return;
+    }
+
+    struct Job
+    {
+        std::atomic<size_t>     next{0};
+        std::atomic<size_t>     done{0};
+        std::mutex              mutex;
+        std::condition_variable finished;
+    };
+
+    auto job = std::make_shared<Job>();
+
+    /* Whoever gets here first takes the next chunk, the caller included. */
+    auto work = [job, chunks, grain, count, &body]() {
+        size_t chunk;
+        while ((chunk = job->next.fetch_add(1)) < chunks)
+        {
+            body(chunk * grain, std::min(count, (chunk + 1) * grain));
+
+            if (job->done.fetch_add(1) + 1 == chunks)
+            {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->finished.notify_all();
+            }
+        }
+    };
+
+    const size_t helpers = std::min<size_t>(mWorkers.size(), chunks - 1);
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (size_t index = 0; index < helpers; index++)
+            mTasks.emplace_back(work);
+    }
+    mCondition.notify_all();
+
+    work();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&job, chunks] { return job->done.load() == chunks; });
+}
@@ -0,0 +1,76 @@
+//
+//  ThreadPool.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Fixed set of worker threads with one shared FIFO queue. Not for GL work, workers have no context. */
+class ThreadPool
+{
+public:
+    /* 0 means one thread per core, minus the calling thread. */
+    explicit ThreadPool(unsigned int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /* Without workers (one core) the task runs right here, its future is ready on return. */
+    template <typename Function>
+    auto Enqueue(Function&& function) -> std::future<decltype(function())>
+    {
+        using Result = decltype(function());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        std::future<Result> future = task->get_future();
+
+        if (mWorkers.empty())
+        {
+            (*task)();
+            return future;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTasks.emplace_back([task]() { (*task)(); });
+        }
+
+        mCondition.notify_one();
+        return future;
+    }
+
+    /*
+     * Calls body(begin, end) over [0, count) in chunks of `grain`, on the workers and the calling thread.
+     * Returns when all chunks are done. Safe to call from a worker, the caller always makes progress itself.
+     */
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& body);
+
+    unsigned int GetThreadCount() const { return static_cast<unsigned int>(mWorkers.size()); }
+
+    /* Process wide pool for the CPU side of rendering (culling, decoding, ...). */
+    static ThreadPool& Shared();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread>          mWorkers;
+    std::deque<std::function<void()>> mTasks;
+    std::mutex                        mMutex;
+    std::condition_variable           mCondition;
+    bool                              mStopping = false;
+};
+
+#endif /* ThreadPool_hpp */
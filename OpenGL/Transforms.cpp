@@ -0,0 +1,117 @@
+//
+//  Transforms.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "Transforms.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#if defined(__AVX__) || defined(__SSE2__)
+    #include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
+namespace Transforms
+{
+    namespace
+    {
+        /* Matrices a worker takes at a time, well above the cost of handing them out. */
+        constexpr size_t kGrain = 2048;
+
+        void MultiplyRange(const glm::mat4& left, const glm::mat4* right, glm::mat4* out, size_t begin, size_t end)
+        {
+#if defined(__AVX__)
+            /* Two columns at a time, one per 128 bit lane: column j = sum over k of left[k] * right[j][k]. */
+            const __m256 left0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left[0][0]));
+            const __m256 left1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left[1][0]));
+            const __m256 left2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left[2][0]));
+            const __m256 left3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left[3][0]));
+
+            for (size_t index = begin; index < end; index++)
+            {
+                const float* source = &right[index][0][0];
+                float* target = &out[index][0][0];
+
+                for (int column = 0; column < 4; column += 2)
+                {
+                    const __m256 columns = _mm256_loadu_ps(source + 4 * column);
+                    __m256 result = _mm256_mul_ps(left0, _mm256_permute_ps(columns, 0x00));
+                    result = _mm256_add_ps(result, _mm256_mul_ps(left1, _mm256_permute_ps(columns, 0x55)));
+                    result = _mm256_add_ps(result, _mm256_mul_ps(left2, _mm256_permute_ps(columns, 0xAA)));
+                    result = _mm256_add_ps(result, _mm256_mul_ps(left3, _mm256_permute_ps(columns, 0xFF)));
+                    _mm256_storeu_ps(target + 4 * column, result);
+                }
+            }
+#elif defined(__SSE2__)
+            const __m128 left0 = _mm_loadu_ps(&left[0][0]);
+            const __m128 left1 = _mm_loadu_ps(&left[1][0]);
+            const __m128 left2 = _mm_loadu_ps(&left[2][0]);
+            const __m128 left3 = _mm_loadu_ps(&left[3][0]);
+
+            for (size_t index = begin; index < end; index++)
+            {
+                const float* source = &right[index][0][0];
+                float* target = &out[index][0][0];
+
+                for (int column = 0; column < 4; column++)
+                {
+                    const __m128 values = _mm_loadu_ps(source + 4 * column);
+                    __m128 result = _mm_mul_ps(left0, _mm_shuffle_ps(values, values, 0x00));
+                    result = _mm_add_ps(result, _mm_mul_ps(left1, _mm_shuffle_ps(values, values, 0x55)));
+                    result = _mm_add_ps(result, _mm_mul_ps(left2, _mm_shuffle_ps(values, values, 0xAA)));
+                    result = _mm_add_ps(result, _mm_mul_ps(left3, _mm_shuffle_ps(values, values, 0xFF)));
+                    _mm_storeu_ps(target + 4 * column, result);
+                }
+            }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+            /* Apple silicon: the same column sums, the lane of right's column picked by the multiply-add itself. */
+            const float32x4_t left0 = vld1q_f32(&left[0][0]);
+            const float32x4_t left1 = vld1q_f32(&left[1][0]);
+            const float32x4_t left2 = vld1q_f32(&left[2][0]);
+            const float32x4_t left3 = vld1q_f32(&left[3][0]);
+
+            for (size_t index = begin; index < end; index++)
+            {
+                const float* source = &right[index][0][0];
+                float* target = &out[index][0][0];
+
+                for (int column = 0; column < 4; column++)
+                {
+                    const float32x4_t values = vld1q_f32(source + 4 * column);
+                    float32x4_t result = vmulq_laneq_f32(left0, values, 0);
+                    result = vmlaq_laneq_f32(result, left1, values, 1);
+                    result = vmlaq_laneq_f32(result, left2, values, 2);
+                    result = vmlaq_laneq_f32(result, left3, values, 3);
+                    vst1q_f32(target + 4 * column, result);
+                }
+            }
+#else
+            MultiplyMatricesScalar(left, right + begin, out + begin, end - begin);
+#endif
+        }
+    }
+
+    void MultiplyMatrices(const glm::mat4& left, const glm::mat4* right, glm::mat4* out, size_t count, ThreadPool* pool)
+    {
+        PROFILE_FUNCTION();
+
+        if (!pool || count <= kGrain)
+        {
+            MultiplyRange(left, right, out, 0, count);
+            return;
+        }
+
+        pool->ParallelFor(count, kGrain, [&](size_t begin, size_t end) { MultiplyRange(left, right, out, begin, end); });
+    }
+
+    void MultiplyMatricesScalar(const glm::mat4& left, const glm::mat4* right, glm::mat4* out, size_t count)
+    {
+        for (size_t index = 0; index < count; index++)
+            out[index] = left * right[index];
+    }
+}
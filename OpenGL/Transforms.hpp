@@ -0,0 +1,30 @@
+//
+//  Transforms.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef Transforms_hpp
+#define Transforms_hpp
+
+#include "glm.hpp"
+
+#include <cstddef>
+
+class ThreadPool;
+
+namespace Transforms
+{
+    /*
+     * out[i] = left * right[i] for count matrices, e.g. the MVPs of many objects from one view projection.
+     * SSE, AVX or NEON (arm64) where available, split over the pool (may be null) for large counts. out may be right.
+     */
+    void MultiplyMatrices(const glm::mat4& left, const glm::mat4* right, glm::mat4* out, size_t count, ThreadPool* pool = nullptr);
+
+    /* Reference implementation with glm, one matrix at a time. Same results as MultiplyMatrices, up to rounding. */
+    void MultiplyMatricesScalar(const glm::mat4& left, const glm::mat4* right, glm::mat4* out, size_t count);
+}
+
+#endif /* Transforms_hpp */
@@ -0,0 +1,531 @@
+//
+//  TriangleBVH.cpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#include "TriangleBVH.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace
+{
+    /* Below this depth splits are SAH, past it median, so the traversal stack can stay fixed. */
+    constexpr unsigned int kSAHDepth   = 32;
+    constexpr unsigned int kStackSize  = 64;
+    /* Nodes with fewer triangles are binned on the calling thread. */
+    constexpr size_t       kParallelBinning = 64 * 1024;
+
+    CommonUtils::BBCoord EmptyBox()
+    {
+        const float inf = std::numeric_limits<float>::infinity();
+        return {glm::vec3(inf), glm::vec3(-inf)};
+    }
+
+    void Grow(CommonUtils::BBCoord& box, const CommonUtils::BBCoord& other)
+    {
+        box.Min = glm::min(box.Min, other.Min);
+        box.Max = glm::max(box.Max, other.Max);
+    }
+
+    float HalfArea(const CommonUtils::BBCoord& box)
+    {
+        const glm::vec3 extent = box.Max - box.Min;
+        if (extent.x < 0.0f || extent.y < 0.0f || extent.z < 0.0f)
+            return 0.0f;
+
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+
+    struct Bin
+    {
+        CommonUtils::BBCoord bounds = EmptyBox();
+        unsigned int         count  = 0;
+    };
+
+    constexpr unsigned int kBinCount = 16;
+
+    /* Per axis. */
+    using Bins = std::array<std::array<Bin, kBinCount>, 3>;
+}
+
+struct TriangleBVH::BuildState
+{
+    struct Task
+    {
+        unsigned int node;
+        unsigned int depth;
+    };
+
+    std::vector<CommonUtils::BBCoord> bounds;       /* Per triangle. */
+    std::vector<glm::vec3>            centroids;
+    std::vector<unsigned int>         order;        /* Triangles, leaves own consecutive ranges. */
+    std::vector<Task>                 tasks;        /* Subtrees left for the parallel phase. */
+};
+
+TriangleBVH::TriangleBVH(const TriangleMesh::Attributes& mesh, ThreadPool* pool)
+{
+    Build(mesh.mPositions, mesh.mIndices, pool);
+}
+
+void TriangleBVH::Build(const std::vector<float>& positions, const std::vector<unsigned int>& indices, ThreadPool* pool)
+{
+    PROFILE_FUNCTION();
+
+    mNodes.clear();
+    mBlocks.clear();
+    mTriangleCount = indices.size() / 3;
+    mBounds = {glm::vec3(0.0f), glm::vec3(0.0f)};
+
+    if (mTriangleCount == 0)
+        return;
+
+    auto vertex = [&positions](unsigned int index) {
+        return glm::vec3(positions[3 * index], positions[3 * index + 1], positions[3 * index + 2]);
+    };
+
+    BuildState state;
+    state.bounds.resize(mTriangleCount);
+    state.centroids.resize(mTriangleCount);
+    state.order.resize(mTriangleCount);
+
+    auto prepare = [&](size_t begin, size_t end) {
+        for (size_t triangle = begin; triangle < end; triangle++)
+        {
+            const glm::vec3 a = vertex(indices[3 * triangle]);
+            const glm::vec3 b = vertex(indices[3 * triangle + 1]);
+            const glm::vec3 c = vertex(indices[3 * triangle + 2]);
+
+            state.bounds[triangle]    = {glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c))};
+            state.centroids[triangle] = (state.bounds[triangle].Min + state.bounds[triangle].Max) * 0.5f;
+            state.order[triangle]     = static_cast<unsigned int>(triangle);
+        }
+    };
+
+    if (pool)
+        pool->ParallelFor(mTriangleCount, 16 * 1024, prepare);
+    else
+        prepare(0, mTriangleCount);
+
+    CommonUtils::BBCoord rootBounds = EmptyBox();
+    for (const auto& box: state.bounds)
+        Grow(rootBounds, box);
+
+    mBounds = rootBounds;
+    mNodes.reserve(mTriangleCount);
+    mNodes.push_back({rootBounds.Min, 0, rootBounds.Max, static_cast<unsigned int>(mTriangleCount)});
+
+    /* Top of the tree here, with binning spread over the pool. Roughly 8 subtrees per thread keeps everyone busy. */
+    const unsigned int threads = pool ? pool->GetThreadCount() + 1 : 1;
+    const size_t taskSize = threads > 1 ? std::max<size_t>(mTriangleCount / (8 * threads), 4 * 1024) : 0;
+
+    Subdivide(state, mNodes, 0, 0, pool, taskSize);
+
+    if (!state.tasks.empty())
+    {
+        /* Each subtree goes into its own array, local root first, and is spliced in afterwards. */
+        std::vector<std::vector<Node>> subtrees(state.tasks.size());
+
+        pool->ParallelFor(state.tasks.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t task = begin; task < end; task++)
+            {
+                subtrees[task].push_back(mNodes[state.tasks[task].node]);
+                Subdivide(state, subtrees[task], 0, state.tasks[task].depth, nullptr, 0);
+            }
+        });
+
+        for (size_t task = 0; task < subtrees.size(); task++)
+        {
+            const unsigned int offset = static_cast<unsigned int>(mNodes.size()) - 1;
+            std::vector<Node>& subtree = subtrees[task];
+
+            for (auto& node: subtree)
+                if (node.count == 0)
+                    node.first += offset;
+
+            mNodes[state.tasks[task].node] = subtree[0];
+            mNodes.insert(mNodes.end(), subtree.begin() + 1, subtree.end());
+        }
+    }
+
+    /* Leaves point at triangle ranges in `order` until here, now they get their block. */
+    for (auto& node: mNodes)
+    {
+        if (node.count == 0)
+            continue;
+
+        TriangleBlock block{};
+        for (unsigned int lane = 0; lane < node.count; lane++)
+        {
+            const unsigned int triangle = state.order[node.first + lane];
+            const glm::vec3 a = vertex(indices[3 * triangle]);
+            const glm::vec3 b = vertex(indices[3 * triangle + 1]);
+            const glm::vec3 c = vertex(indices[3 * triangle + 2]);
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                block.v0[axis][lane]    = a[axis];
+                block.edge1[axis][lane] = b[axis] - a[axis];
+                block.edge2[axis][lane] = c[axis] - a[axis];
+            }
+            block.triangle[lane] = triangle;
+        }
+        for (unsigned int lane = node.count; lane < 4; lane++)
+            block.triangle[lane] = kNoTriangle;
+
+        node.first = static_cast<unsigned int>(mBlocks.size());
+        mBlocks.push_back(block);
+    }
+}
+
+void TriangleBVH::Subdivide(BuildState& state, std::vector<Node>& nodes, unsigned int rootIndex, unsigned int rootDepth,
+                            ThreadPool* pool, size_t taskSize)
+{
+    static_assert(kBins == kBinCount, "bin arrays are sized by kBinCount");
+
+    std::vector<BuildState::Task> stack{{rootIndex, rootDepth}};
+
+    while (!stack.empty())
+    {
+        const BuildState::Task entry = stack.back();
+        stack.pop_back();
+
+        const unsigned int first = nodes[entry.node].first;
+        const unsigned int count = nodes[entry.node].count;
+        if (count <= kMaxLeafSize)
+            continue;
+
+        if (taskSize && count <= taskSize)
+        {
+            state.tasks.push_back(entry);
+            continue;
+        }
+
+        CommonUtils::BBCoord centroidBounds = EmptyBox();
+        for (unsigned int index = first; index < first + count; index++)
+        {
+            const glm::vec3& centroid = state.centroids[state.order[index]];
+            Grow(centroidBounds, {centroid, centroid});
+        }
+
+        const glm::vec3 extent = centroidBounds.Max - centroidBounds.Min;
+        const glm::vec3 scale  = glm::vec3(static_cast<float>(kBins)) / glm::max(extent, glm::vec3(1e-30f));
+
+        auto binOf = [&](unsigned int triangle, int axis) {
+            const int bin = static_cast<int>((state.centroids[triangle][axis] - centroidBounds.Min[axis]) * scale[axis]);
+            return std::min(bin, static_cast<int>(kBins) - 1);
+        };
+
+        float bestCost  = std::numeric_limits<float>::max();
+        int   bestAxis  = -1;
+        int   bestSplit = 0;
+        CommonUtils::BBCoord bestLeft, bestRight;
+
+        if (entry.depth < kSAHDepth)
+        {
+            auto fill = [&](Bins& bins, size_t begin, size_t end) {
+                for (size_t index = begin; index < end; index++)
+                {
+                    const unsigned int triangle = state.order[first + index];
+                    for (int axis = 0; axis < 3; axis++)
+                    {
+                        Bin& bin = bins[axis][binOf(triangle, axis)];
+                        Grow(bin.bounds, state.bounds[triangle]);
+                        bin.count++;
+                    }
+                }
+            };
+
+            Bins bins;
+
+            if (pool && count >= kParallelBinning)
+            {
+                const size_t grain = 16 * 1024;
+                std::vector<Bins> partial((count + grain - 1) / grain);
+                pool->ParallelFor(count, grain, [&](size_t begin, size_t end) { fill(partial[begin / grain], begin, end); });
+
+                for (const auto& chunk: partial)
+                    for (int axis = 0; axis < 3; axis++)
+                        for (unsigned int bin = 0; bin < kBins; bin++)
+                        {
+                            Grow(bins[axis][bin].bounds, chunk[axis][bin].bounds);
+                            bins[axis][bin].count += chunk[axis][bin].count;
+                        }
+            }
+            else
+            {
+                fill(bins, 0, count);
+            }
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (extent[axis] <= 0.0f)
+                    continue;
+
+                /* Sweep from the right first, then evaluate every split plane from the left. */
+                CommonUtils::BBCoord rightBounds[kBins];
+                unsigned int         rightCount[kBins];
+                CommonUtils::BBCoord box = EmptyBox();
+                unsigned int         sum = 0;
+
+                for (int bin = kBins - 1; bin > 0; bin--)
+                {
+                    Grow(box, bins[axis][bin].bounds);
+                    sum += bins[axis][bin].count;
+                    rightBounds[bin] = box;
+                    rightCount[bin]  = sum;
+                }
+
+                box = EmptyBox();
+                sum = 0;
+                for (unsigned int split = 1; split < kBins; split++)
+                {
+                    Grow(box, bins[axis][split - 1].bounds);
+                    sum += bins[axis][split - 1].count;
+
+                    if (sum == 0 || rightCount[split] == 0)
+                        continue;
+
+                    const float cost = sum * HalfArea(box) + rightCount[split] * HalfArea(rightBounds[split]);
+                    if (cost < bestCost)
+                    {
+                        bestCost  = cost;
+                        bestAxis  = axis;
+                        bestSplit = static_cast<int>(split);
+                        bestLeft  = box;
+                        bestRight = rightBounds[split];
+                    }
+                }
+            }
+        }
+
+        unsigned int leftCount;
+
+        if (bestAxis >= 0)
+        {
+            auto middle = std::partition(state.order.begin() + first, state.order.begin() + first + count,
+                                         [&](unsigned int triangle) { return binOf(triangle, bestAxis) < bestSplit; });
+            leftCount = static_cast<unsigned int>(middle - (state.order.begin() + first));
+        }
+        else
+        {
+            /* Too deep, or all centroids on one spot: halve the count, that bounds the depth. */
+            const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+            leftCount = count / 2;
+
+            std::nth_element(state.order.begin() + first, state.order.begin() + first + leftCount, state.order.begin() + first + count,
+                             [&](unsigned int a, unsigned int b) { return state.centroids[a][axis] < state.centroids[b][axis]; });
+
+            bestLeft = bestRight = EmptyBox();
+            for (unsigned int index = first; index < first + leftCount; index++)
+                Grow(bestLeft, state.bounds[state.order[index]]);
+            for (unsigned int index = first + leftCount; index < first + count; index++)
+                Grow(bestRight, state.bounds[state.order[index]]);
+        }
+
+        const unsigned int left = static_cast<unsigned int>(nodes.size());
+        nodes.push_back({bestLeft.Min, first, bestLeft.Max, leftCount});
+        nodes.push_back({bestRight.Min, first + leftCount, bestRight.Max, count - leftCount});
+
+        nodes[entry.node].first = left;
+        nodes[entry.node].count = 0;
+
+        stack.push_back({left + 1, entry.depth + 1});
+        stack.push_back({left, entry.depth + 1});
+    }
+}
+
+bool TriangleBVH::Intersect(const glm::vec3& origin, const glm::vec3& direction, const glm::mat4& modelMatrix, Hit& hit) const
+{
+    /* Not normalized on purpose, t along the local ray is t along the world ray. */
+    const glm::mat4 inverse = glm::inverse(modelMatrix);
+    return Intersect(glm::vec3(inverse * glm::vec4(origin, 1.0f)), glm::vec3(inverse * glm::vec4(direction, 0.0f)), hit);
+}
+
+bool TriangleBVH::Intersect(const glm::vec3& origin, const glm::vec3& direction, Hit& hit) const
+{
+    if (mNodes.empty())
+        return false;
+
+    const float inf = std::numeric_limits<float>::infinity();
+    const glm::vec3 inverseDirection = 1.0f / direction;
+    bool found = false;
+
+#if defined(__SSE2__)
+    /* Lane 3 of a node row holds first/count, masked to 0 so it never turns into a denormal. */
+    const __m128 xyzMask    = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    const __m128 rayOrigin  = _mm_set_ps(0.0f, origin.z, origin.y, origin.x);
+    const __m128 rayInverse = _mm_set_ps(0.0f, inverseDirection.z, inverseDirection.y, inverseDirection.x);
+
+    auto enter = [&](const Node& node) {
+        const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_and_ps(_mm_load_ps(&node.min.x), xyzMask), rayOrigin), rayInverse);
+        const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_and_ps(_mm_load_ps(&node.max.x), xyzMask), rayOrigin), rayInverse);
+        const __m128 near = _mm_min_ps(t0, t1);
+        const __m128 far  = _mm_max_ps(t0, t1);
+
+        const float entry = _mm_cvtss_f32(_mm_max_ss(_mm_max_ss(near, _mm_shuffle_ps(near, near, 1)), _mm_movehl_ps(near, near)));
+        const float exit  = _mm_cvtss_f32(_mm_min_ss(_mm_min_ss(far, _mm_shuffle_ps(far, far, 1)), _mm_movehl_ps(far, far)));
+
+        const float from = std::max(entry, 0.0f);
+        return from <= std::min(exit, hit.distance) ? from : inf;
+    };
+
+    const __m128 dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+    const __m128 ox = _mm_set1_ps(origin.x),    oy = _mm_set1_ps(origin.y),    oz = _mm_set1_ps(origin.z);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+
+    /* Moller-Trumbore on the 4 triangles of a leaf at once. */
+    auto intersectLeaf = [&](const TriangleBlock& block) {
+        const __m128 e1x = _mm_load_ps(block.edge1[0]), e1y = _mm_load_ps(block.edge1[1]), e1z = _mm_load_ps(block.edge1[2]);
+        const __m128 e2x = _mm_load_ps(block.edge2[0]), e2y = _mm_load_ps(block.edge2[1]), e2z = _mm_load_ps(block.edge2[2]);
+
+        const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+        const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        const __m128 inverseDet = _mm_div_ps(one, det);
+
+        const __m128 tx = _mm_sub_ps(ox, _mm_load_ps(block.v0[0]));
+        const __m128 ty = _mm_sub_ps(oy, _mm_load_ps(block.v0[1]));
+        const __m128 tz = _mm_sub_ps(oz, _mm_load_ps(block.v0[2]));
+
+        const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), inverseDet);
+
+        const __m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+        const __m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+        const __m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+
+        const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverseDet);
+        const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverseDet);
+
+        __m128 mask = _mm_cmpneq_ps(det, zero);
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+        mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+        mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        mask = _mm_and_ps(mask, _mm_cmpgt_ps(t, zero));
+        mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(hit.distance)));
+
+        int lanes = _mm_movemask_ps(mask);
+        if (!lanes)
+            return;
+
+        alignas(16) float distance[4], uLane[4], vLane[4];
+        _mm_store_ps(distance, t);
+        _mm_store_ps(uLane, u);
+        _mm_store_ps(vLane, v);
+
+        for (int lane = 0; lanes; lane++, lanes >>= 1)
+        {
+            if ((lanes & 1) && distance[lane] < hit.distance)
+            {
+                hit = {distance[lane], block.triangle[lane], uLane[lane], vLane[lane]};
+                found = true;
+            }
+        }
+    };
+#else
+    auto enter = [&](const Node& node) {
+        const glm::vec3 t0 = (node.min - origin) * inverseDirection;
+        const glm::vec3 t1 = (node.max - origin) * inverseDirection;
+        const glm::vec3 near = glm::min(t0, t1);
+        const glm::vec3 far  = glm::max(t0, t1);
+
+        const float from = std::max(std::max(std::max(near.x, near.y), near.z), 0.0f);
+        return from <= std::min(std::min(std::min(far.x, far.y), far.z), hit.distance) ? from : inf;
+    };
+
+    /* Same arithmetic order as the SSE path. */
+    auto intersectLeaf = [&](const TriangleBlock& block) {
+        for (int lane = 0; lane < 4; lane++)
+        {
+            const glm::vec3 e1(block.edge1[0][lane], block.edge1[1][lane], block.edge1[2][lane]);
+            const glm::vec3 e2(block.edge2[0][lane], block.edge2[1][lane], block.edge2[2][lane]);
+
+            const glm::vec3 p(direction.y * e2.z - direction.z * e2.y, direction.z * e2.x - direction.x * e2.z, direction.x * e2.y - direction.y * e2.x);
+            const float det = e1.x * p.x + e1.y * p.y + e1.z * p.z;
+            if (det == 0.0f)
+                continue;
+
+            const float inverseDet = 1.0f / det;
+            const glm::vec3 s = origin - glm::vec3(block.v0[0][lane], block.v0[1][lane], block.v0[2][lane]);
+
+            const float u = (s.x * p.x + s.y * p.y + s.z * p.z) * inverseDet;
+            const glm::vec3 q(s.y * e1.z - s.z * e1.y, s.z * e1.x - s.x * e1.z, s.x * e1.y - s.y * e1.x);
+            const float v = (direction.x * q.x + direction.y * q.y + direction.z * q.z) * inverseDet;
+            const float t = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * inverseDet;
+
+            if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t > 0.0f && t < hit.distance)
+            {
+                hit = {t, block.triangle[lane], u, v};
+                found = true;
+            }
+        }
+    };
+#endif
+
+    if (enter(mNodes[0]) == inf)
+        return false;
+
+    struct Entry
+    {
+        unsigned int node;
+        float        distance;
+    };
+
+    Entry stack[kStackSize];
+    unsigned int stackSize = 0;
+    unsigned int current = 0;
+
+    for (;;)
+    {
+        const Node& node = mNodes[current];
+
+        if (node.count)
+        {
+            intersectLeaf(mBlocks[node.first]);
+        }
+        else
+        {
+            /* Nearer child next, the farther one waits on the stack with its entry distance. */
+            unsigned int nearChild = node.first, farChild = node.first + 1;
+            float nearDistance = enter(mNodes[nearChild]);
+            float farDistance  = enter(mNodes[farChild]);
+
+            if (farDistance < nearDistance)
+            {
+                std::swap(nearChild, farChild);
+                std::swap(nearDistance, farDistance);
+            }
+
+            if (nearDistance != inf)
+            {
+                if (farDistance != inf)
+                    stack[stackSize++] = {farChild, farDistance};
+
+                current = nearChild;
+                continue;
+            }
+        }
+
+        /* Skip whatever a closer hit has made unreachable. */
+        while (stackSize && stack[stackSize - 1].distance >= hit.distance)
+            stackSize--;
+
+        if (!stackSize)
+            break;
+
+        current = stack[--stackSize].node;
+    }
+
+    return found;
+}
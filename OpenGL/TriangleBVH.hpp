@@ -0,0 +1,88 @@
+//
+//  TriangleBVH.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef TriangleBVH_hpp
+#define TriangleBVH_hpp
+
+#include "CommonUtils.hpp"
+#include "TriangleMesh.hpp"
+
+#include <limits>
+#include <vector>
+
+class ThreadPool;
+
+/*
+ * Bounding volume hierarchy over the triangles of one mesh, for picking and ray queries. Binned SAH build, the
+ * upper levels split on the calling thread and the subtrees below are built in parallel. Nodes are 32 bytes.
+ * Leaves hold up to 4 triangles stored side by side, so one SSE ray/triangle test covers a whole leaf.
+ */
+class TriangleBVH
+{
+public:
+    static constexpr unsigned int kNoTriangle = std::numeric_limits<unsigned int>::max();
+
+    struct Hit
+    {
+        float        distance = std::numeric_limits<float>::infinity();    /* In units of the ray direction. */
+        unsigned int triangle = kNoTriangle;                                /* Index into mIndices / 3. */
+        float        u = 0.0f;                                              /* Barycentrics of vertex 1 and 2. */
+        float        v = 0.0f;
+
+        bool IsHit() const { return triangle != kNoTriangle; }
+    };
+
+    TriangleBVH() = default;
+    /* pool may be null. */
+    TriangleBVH(const TriangleMesh::Attributes& mesh, ThreadPool* pool);
+
+    void Build(const std::vector<float>& positions, const std::vector<unsigned int>& indices, ThreadPool* pool);
+
+    /* Closest hit in front of the origin. `hit` is only replaced by a closer one, so it can carry a previous result. */
+    bool Intersect(const glm::vec3& origin, const glm::vec3& direction, Hit& hit) const;
+    /* World space ray against the mesh placed by modelMatrix. Distances stay in world space ray units. */
+    bool Intersect(const glm::vec3& origin, const glm::vec3& direction, const glm::mat4& modelMatrix, Hit& hit) const;
+
+    const CommonUtils::BBCoord& GetBounds() const { return mBounds; }
+    size_t GetTriangleCount() const { return mTriangleCount; }
+    size_t GetNodeCount() const { return mNodes.size(); }
+
+private:
+    static constexpr unsigned int kMaxLeafSize = 4;
+    static constexpr unsigned int kBins        = 16;
+
+    struct alignas(32) Node
+    {
+        glm::vec3    min;
+        unsigned int first;     /* Leaf: its triangle block. Interior: left child, right is first + 1. */
+        glm::vec3    max;
+        unsigned int count;     /* Triangles in the leaf, 0 for interior nodes. */
+    };
+
+    /* Up to 4 triangles of a leaf, lane per triangle. Unused lanes are degenerate and never hit. */
+    struct alignas(16) TriangleBlock
+    {
+        float        v0[3][4];
+        float        edge1[3][4];
+        float        edge2[3][4];
+        unsigned int triangle[4];
+    };
+
+    struct BuildState;
+
+    /* Splits until leaves fit a block. With taskSize set, nodes up to that size are left for the parallel phase. */
+    static void Subdivide(BuildState& state, std::vector<Node>& nodes, unsigned int rootIndex, unsigned int rootDepth,
+                          ThreadPool* pool, size_t taskSize);
+
+    std::vector<Node>          mNodes;
+    std::vector<TriangleBlock> mBlocks;
+    CommonUtils::BBCoord       mBounds{glm::vec3(0.0f), glm::vec3(0.0f)};
+    size_t                     mTriangleCount = 0;
+};
+
+#endif /* TriangleBVH_hpp */
@@ -11,7 +11,10 @@
 #include "assimp/scene.h"           // Output data structure
 #include "assimp/postprocess.h"     // Post processing flags
 #include "ErrorHandler.hpp"
+#include "Profiler.hpp"
+#include "gtc/type_ptr.hpp"
 #include <algorithm>
+#include <utility>
 
 TriangleMesh::TriangleMesh(const std::string& path)
 {
@@ -25,6 +28,7 @@ TriangleMesh::~TriangleMesh()
 
 void TriangleMesh::Import3DModel(const std::string& path)
 {
+    PROFILE_SCOPE("TriangleMesh::Import3DModel");
     CleanModel();
     mFilePath = path;
    // Create an instance of the Importer class
@@ -33,12 +37,16 @@ void TriangleMesh::Import3DModel(const std::string& path)
     // And have it read the given file with some example postprocessing
     // Usually - if speed is not the most important aspect for you - you'll
     // probably to request more postprocessing than we do in this example.
-    const aiScene* scene = importer.ReadFile( path,
-                                             aiProcess_Triangulate            |
-                                             aiProcess_JoinIdenticalVertices  |
-                                             aiProcess_GenNormals             |
-                                             aiProcess_OptimizeMeshes         |
-                                             aiProcess_SplitLargeMeshes);
+    const aiScene* scene = nullptr;
+    {
+        PROFILE_SCOPE("Assimp::ReadFile");
+        scene = importer.ReadFile( path,
+                                   aiProcess_Triangulate            |
+                                   aiProcess_JoinIdenticalVertices  |
+                                   aiProcess_GenNormals             |
+                                   aiProcess_OptimizeMeshes         |
+                                   aiProcess_SplitLargeMeshes);
+    }
     
     // If the import failed, report it
     if(!scene)
@@ -52,10 +60,12 @@ void TriangleMesh::CleanModel()
     mMeshes.clear();
     mFilePath.clear();
     mTexturePaths.clear();
+    mSceneGraph.Clear();
 }
 
 void TriangleMesh::ProcessModel(const aiScene* scene)
 {
+    PROFILE_SCOPE("TriangleMesh::ProcessModel");
     ASSERT(scene != nullptr);
     
     if(scene->HasMeshes())
@@ -82,10 +92,49 @@ void TriangleMesh::ProcessModel(const aiScene* scene)
     {
         throw std::runtime_error("Mesh not found in file!");
     }
+
+    ProcessNodes(scene);
+}
+
+void TriangleMesh::ProcessNodes(const aiScene* scene)
+{
+    PROFILE_SCOPE("TriangleMesh::ProcessNodes");
+
+    /* Without a hierarchy every mesh is drawn once, as is. */
+    if (!scene->mRootNode)
+    {
+        const SceneGraph::NodeID root = mSceneGraph.AddNode(SceneGraph::kNone, glm::mat4(1.0f));
+        for (MeshID id = 0; id < scene->mNumMeshes; id++)
+            mSceneGraph.AddMesh(root, id);
+        mSceneGraph.Update();
+        return;
+    }
+
+    /* Depth first, so every node goes in after its parent. */
+    std::vector<std::pair<const aiNode*, SceneGraph::NodeID>> stack{{scene->mRootNode, SceneGraph::kNone}};
+    while (!stack.empty())
+    {
+        const aiNode* node = stack.back().first;
+        const SceneGraph::NodeID parent = stack.back().second;
+        stack.pop_back();
+
+        /* Assimp matrices are row major. */
+        const glm::mat4 transform = glm::transpose(glm::make_mat4(&node->mTransformation.a1));
+        const SceneGraph::NodeID id = mSceneGraph.AddNode(parent, transform, node->mName.C_Str());
+
+        for (unsigned int index = 0; index < node->mNumMeshes; index++)
+            mSceneGraph.AddMesh(id, node->mMeshes[index]);
+
+        for (unsigned int child = node->mNumChildren; child-- > 0;)
+            stack.emplace_back(node->mChildren[child], id);
+    }
+
+    mSceneGraph.Update();
 }
 
 void TriangleMesh::ProcessPositions(const aiMesh& mesh, MeshID id)
 {
+    PROFILE_SCOPE("TriangleMesh::ProcessPositions");
     ASSERT(mesh.HasPositions());
 
     Attributes& attr = mMeshes[id];
@@ -103,6 +152,7 @@ void TriangleMesh::ProcessPositions(const aiMesh& mesh, MeshID id)
 
 void TriangleMesh::ProcessIndices(const aiMesh& mesh, MeshID id)
 {
+    PROFILE_SCOPE("TriangleMesh::ProcessIndices");
     ASSERT(mesh.HasFaces());
     
     Attributes& attr = mMeshes[id];
@@ -115,6 +165,7 @@ void TriangleMesh::ProcessIndices(const aiMesh& mesh, MeshID id)
 
 void TriangleMesh::ProcessNormals(const aiMesh& mesh, MeshID id)
 {
+    PROFILE_SCOPE("TriangleMesh::ProcessNormals");
     ASSERT(mesh.HasNormals());
 
     Attributes& attr = mMeshes[id];
@@ -132,6 +183,7 @@ void TriangleMesh::ProcessNormals(const aiMesh& mesh, MeshID id)
 
 void TriangleMesh::ProcessUVCoords(const aiMesh& mesh, MeshID id)
 {
+    PROFILE_SCOPE("TriangleMesh::ProcessUVCoords");
     /* WARNING: I ONLY SUPPORT SINGLE CHANNEL 2D UV COORDS FOR NOW. */
     /* ToDo: Support for 3D texture. */
     const unsigned int channelIndex = 0;
@@ -152,6 +204,7 @@ void TriangleMesh::ProcessUVCoords(const aiMesh& mesh, MeshID id)
 
 void TriangleMesh::ProcessMaterials(const aiMaterial& material, MeshID id)
 {
+    PROFILE_SCOPE("TriangleMesh::ProcessMaterials");
     std::string directory = mFilePath.substr(0, mFilePath.find_last_of('/'));   /* the hell with Windows! ToDo: use boost::fs */
 
     Attributes& attr = mMeshes[id];
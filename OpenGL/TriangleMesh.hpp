@@ -15,6 +15,7 @@
 #include <float.h>
 #include "glm.hpp"
 #include "gtc/matrix_transform.hpp"
+#include "SceneGraph.hpp"
 #include <map>
 #include <set>
 #include <deque>
@@ -56,8 +57,12 @@ public:
     const Attributes&                   GetMeshAttributes(MeshID) const;
     const std::map<MeshID, Attributes>& GetModelMesh() const;
     unsigned int                        GetNumberOfMeshes() const;
+    const std::string&                  GetFilePath() const { return mFilePath; }
     const std::vector<std::string>&     GetTexturePaths() const;
     const std::string&                  GetTexturePath(unsigned int) const;
+    /* The file's node hierarchy, which meshes are drawn where. Positions and normals stay in mesh space. */
+    const SceneGraph&                   GetSceneGraph() const { return mSceneGraph; }
+    SceneGraph&                         GetSceneGraph() { return mSceneGraph; }
 
 private:
 
@@ -66,6 +71,7 @@ private:
     static constexpr unsigned kTextureCoordinates = 2;
 
     void ProcessModel(const aiScene* scene);
+    void ProcessNodes(const aiScene* scene);
     void ProcessPositions(const aiMesh& mesh, MeshID);
     void ProcessIndices(const aiMesh& mesh, MeshID);
     void ProcessNormals(const aiMesh& mesh, MeshID);
@@ -75,6 +81,7 @@ private:
     std::map<MeshID, Attributes>    mMeshes;
     std::string                     mFilePath;
     std::vector<std::string>        mTexturePaths;
+    SceneGraph                      mSceneGraph;
 };
 
 #endif
@@ -0,0 +1,61 @@
+//
+//  TripleBuffer.hpp
+//  OpenGL
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+
+#ifndef TripleBuffer_hpp
+#define TripleBuffer_hpp
+
+#include <atomic>
+
+/*
+ * Latest value handoff from one writer thread to one reader thread, lock-free. The writer fills its buffer and
+ * publishes it, the reader swaps in whatever was published last. Neither ever waits, and neither touches a buffer
+ * the other holds: values the reader didn't get to in time are overwritten, never torn.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /* Writer only. */
+    T& GetWriteBuffer() { return mBuffers[mWrite]; }
+    void Publish()
+    {
+        const unsigned int previous = mMiddle.exchange(mWrite | kFresh, std::memory_order_acq_rel);
+        mWrite = previous & kIndex;
+    }
+
+    /* Reader only. True when something newer was published, it is then the read buffer. */
+    bool Update()
+    {
+        if (!HasNew())
+            return false;
+
+        const unsigned int previous = mMiddle.exchange(mRead, std::memory_order_acq_rel);
+        mRead = previous & kIndex;
+        return true;
+    }
+    T& GetReadBuffer() { return mBuffers[mRead]; }
+
+    /* Either side. */
+    bool HasNew() const { return mMiddle.load(std::memory_order_acquire) & kFresh; }
+
+private:
+    static constexpr unsigned int kIndex = 3;
+    static constexpr unsigned int kFresh = 4;       /* The middle buffer was published and not read yet. */
+
+    T                         mBuffers[3];
+    unsigned int              mWrite = 0;
+    unsigned int              mRead  = 1;
+    std::atomic<unsigned int> mMiddle{2};
+};
+
+#endif /* TripleBuffer_hpp */
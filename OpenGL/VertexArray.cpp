@@ -12,11 +12,13 @@
 VertexArray::VertexArray() : mIndex(0)
 {
     GLCall(glGenVertexArrays(1, &mRendererID));
+    mResource = GLResources::Register(GLResources::Type::VertexArray, mRendererID, 0, "", GL_RESOURCE_SITE);
 }
 
 VertexArray::~VertexArray()
 {
     GLCall(glDeleteVertexArrays(1, &mRendererID));
+    GLResources::Release(mResource);
 }
 
 
@@ -18,6 +18,7 @@ class VertexArray
 {
     unsigned int mRendererID;
     unsigned int mIndex;
+    GLResources::Handle mResource;
 
     void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
 
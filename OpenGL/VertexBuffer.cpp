@@ -11,6 +11,7 @@
 VertexBuffer::~VertexBuffer()
 {
     GLCall(glDeleteBuffers(1, &mRendererId));
+    GLResources::Release(mResource);
 }
 
 void VertexBuffer::Bind() const
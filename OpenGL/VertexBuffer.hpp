@@ -11,11 +11,13 @@
 
 #include <vector>
 #include "ErrorHandler.hpp"
+#include "GLResources.hpp"
 
 class VertexBuffer
 {
 private:
     unsigned int mRendererId;
+    GLResources::Handle mResource;
 
 public:
     template <typename T>
@@ -24,6 +26,7 @@ public:
         GLCall(glGenBuffers(1, &mRendererId));
         GLCall(glBindBuffer(GL_ARRAY_BUFFER, mRendererId));
         GLCall(glBufferData(GL_ARRAY_BUFFER, buffer.size() * sizeof(T), buffer.data(), GL_STATIC_DRAW));
+        mResource = GLResources::Register(GLResources::Type::Buffer, mRendererId, buffer.size() * sizeof(T), "vertex buffer", GL_RESOURCE_SITE);
     }
 
     ~VertexBuffer();
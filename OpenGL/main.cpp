@@ -11,6 +11,15 @@
 #include "TriangleMesh.hpp"
 #include "CommonUtils.hpp"
 #include "ModelRendererHelper.hpp"
+#include "SceneRenderHelper.hpp"
+#include "ScenePipeline.hpp"
+#include "CameraPath.hpp"
+#include "FrameGraph.hpp"
+#include "FrameRecorder.hpp"
+#include "GLResources.hpp"
+#include "PixelReadback.hpp"
+#include "Profiler.hpp"
+#include "ThreadPool.hpp"
 
 #include "glm.hpp"
 #include "gtc/matrix_transform.hpp"
@@ -38,42 +47,73 @@ int main(void)
     const int ScreenWidth = 1280;
     const int ScreenHeight = 720;
     const std::string WindowName = "OpenGL";
+    const std::string ResourceRoot = "../../../res/";
+    const std::string CameraPathFile = "camera_path.txt";
+    const char* const RecordingFiles[] = {"recording.png", "recording.y4m", "recording.raw"};
+
+#ifdef ENABLE_PROFILER
+    /* Captures startup (model import, texture decode, shader compile) and the first frames. */
+    Profiler::SetAutoDump(5.0f, "startup_trace.json");
+#endif
+
+    /* Whatever GL object outlives main is listed on stderr. */
+    GLResources::EnableLeakReportAtExit();
 
     GLFWInitWindow window(ScreenWidth, ScreenHeight, WindowName);
     window.HideCursor();
 
-    
-    /* Y axis is up. */
-    
-    Helper::ModelRenderer groundModel("../../../res/Models/GroundPlane/GroundPlane.obj");
-    Helper::ModelRenderer objectModel("../../../res/Models/Ivysaur_OBJ/Pokemon.obj");
+    /* Startup times, the texture cache makes the second launch much quicker. */
+    const double loadStartTime = glfwGetTime();
+    double firstFrameTime = -1.0, texturesReadyTime = -1.0;
 
-    Shader modelShader("../../../res/Shaders/ModelObject.shader");
-    modelShader.Bind();
+    Helper::SceneRenderer scene(ResourceRoot);
+    int textureBudget = static_cast<int>(scene.GetTextureStreamer().fVRAMBudget >> 20);
 
-    /* ToDo: extract these values from model itself. */
-    modelShader.SetUniform3f("u_DirectionalLight.direction", 0.0f, 1.0f, 0.0f);
-    modelShader.SetUniform3f("u_DirectionalLight.ambient",  0.3f, 0.3f, 0.3f);
-    modelShader.SetUniform3f("u_DirectionalLight.diffuse",  0.7f, 0.7f, 0.7f);
-    modelShader.SetUniform3f("u_DirectionalLight.specular", 1.0f, 1.0f, 1.0f);
+    /* Matrices and light clusters of the next frame are prepared on an update thread while this one draws. */
+    Helper::ScenePipeline scenePipeline(scene, true);
+    bool updateThread = scenePipeline.IsThreaded();
 
-    /****************************************/
+    /* Render targets, and the passes drawing into them. Rebuilt each frame. */
+    FramebufferPool framebufferPool;
+    FrameGraph frameGraph(framebufferPool);
 
-    Helper::ModelRenderer lightModel("../../../res/Models/Light/Light.obj");
+    /* Screenshots are read back a few frames later and written by a worker, the frame does not wait. */
+    PixelReadback readback(ThreadPool::Shared());
+    bool takeScreenshot = false;
 
-    Shader lightShader("../../../res/Shaders/LightObject.shader");
-    lightShader.Bind();
-    lightShader.SetUniform3f("u_LightColor", 1.0f, 1.0f, 1.0f);
-    
+    /* While recording, time advances a frame at a time at the recording frame rate, however long frames take. */
+    FrameRecorder recorder;
+    int    recordingFormat = 1;
+    int    recordingFps    = 30;
+    double recordingStartTime = 0.0;
+
+    /* On demand, frames are only drawn while something changes: input, the orbit, loading textures or readbacks. */
+    bool   renderOnDemand = false;
+    bool   animateCamera  = true;
+    bool   busy           = true;
+    int    presentMode    = static_cast<int>(window.GetPresentMode());
+    int    frameRateCap   = 0;
+    double animationTime  = 0.0;
+    double lastFrameTime  = glfwGetTime();
 
     /******* Frame Buffer code here *********/
-//    Helper::FramebufferRenderer framebuffer(ScreenWidth, ScreenHeight);
+//    Helper::FramebufferRenderer framebuffer(framebufferPool, ScreenWidth, ScreenHeight);
 //    Shader framebufferShader("../../../res/Shaders/Framebuffer.shader");
     /****************************************/
 
     Renderer renderer;
     renderer.EnableDepth(GL_LESS);
 //    renderer.EnableBlend();
+
+    /* Compare scene GPU time with and without occlusion queries. */
+    GpuTimer gpuTimer;
+
+    /* Left click picks the triangle under the cursor. */
+    Helper::SceneRenderer::PickHit pickHit{};
+    bool picked = false;
+
+    /* Scattered point lights on top of the movable one, to load the clustered shading. */
+    int extraLights = 0;
     
     ImGui::CreateContext();
     ImGui::StyleColorsDark();
@@ -81,43 +121,31 @@ int main(void)
     ImGui_ImplGlfw_InitForOpenGL(window.GetWindowContext(), true);
     ImGui_ImplOpenGL3_Init("#version 150");
 
-    /* Todo: abstract all these GetBBox calls and put them in relevent class. SERIOUSLY! */
-    CommonUtils::BBCoord lightObjectBB = CommonUtils::GetBBox(lightModel.GetTriangleMesh());
-    CommonUtils::BBCoord modelObjectBB = CommonUtils::GetBBox(objectModel.GetTriangleMesh());
-    CommonUtils::BBCoord groundObjectBB = CommonUtils::GetBBox(groundModel.GetTriangleMesh()); /* Todo: Add a get bound to renderermodel maybe?*/
-
-    CommonUtils::BBCoord unionizedBB = CommonUtils::GetBBox({lightObjectBB, modelObjectBB, groundObjectBB}); /* ToDo: Ugh... Copy... */
-
-    /* Translation, Scale, Rotation to object, Model Matrix. Local to World coordinates. */ /* Todo: abstract to class*/
-    CommonUtils::ModelMatrix objectModelMatrix(unionizedBB, modelObjectBB);
-    CommonUtils::ModelMatrix lightModelMatrix(unionizedBB, lightObjectBB);
-    CommonUtils::ModelMatrix groundModelMatrix(unionizedBB, groundObjectBB);
-
-    glm::vec3 initialLightPosition = CommonUtils::GetBBoxCenter(lightObjectBB);
-    glm::vec3 lightColorPicker{1.0f, 1.0f, 1.0f};
-
-    glm::vec3 lookAtCenter = CommonUtils::GetBBoxCenter(unionizedBB);
-    
-    {
-        lightModelMatrix.fTranslation.x = -15.0f;
-        lightModelMatrix.fScale.x = lightModelMatrix.fScale.y = lightModelMatrix.fScale.z = 1.4f;
-    }
+    glm::vec3 lookAtCenter = scene.GetLookAtCenter();
     
     float fieldOfView = 45.0f;
-    bool enableDirectionalLight = true;
 
     /* Todo: Abstract view matrix into a struct */
     glm::vec3 viewTranslate{};
-    
-    objectModelMatrix.fScale = glm::vec3(5.0f, 5.0f, 5.0f);
+
+    /* Recorded paths are replayed frame by frame by viewer_bench. */
+    CameraPath recordedPath;
+    bool   recordCamera = false;
+    double recordStartTime = 0.0;
     
 //    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     /* Loop until the user closes the window */
     while (!(window.ShouldCloseWindow()))
     {
+        /* Otherwise a timed out wait is just another look at the close flag. */
+        if (renderOnDemand && !busy && !window.WaitForRedraw(1.0))
+            continue;
+
         /* Render here */
-        renderer.Clear();
+        renderer.ResetStats();
+        framebufferPool.BeginFrame();
         
+//        framebuffer.Resize(window.GetFramebufferSize().first, window.GetFramebufferSize().second);
 //        framebuffer.Bind();
 
         ImGui_ImplOpenGL3_NewFrame();
@@ -129,63 +157,76 @@ int main(void)
 
         /*************************************/
         const float radius = 60.0;
-        float xdist = sin(glfwGetTime()) * radius;
-        float ydist = cos(glfwGetTime()) * radius;
-        glm::vec3 cameraPosition(xdist, 0.0, ydist);
-        glm::mat4 view = glm::translate(glm::identity<glm::mat4>(), viewTranslate) *
-                         glm::lookAt(cameraPosition, lookAtCenter, glm::vec3(0.0, 1.0, 0.0));
-        /*************************************/
-
-        /*************************************/
-        float yAngle = 0; /* glfwGetTime(); */
-        objectModelMatrix.fAngle = glm::vec3(0.0f, yAngle, 0.0f);
-        /*************************************/
-
-        auto finalLightPosition = glm::vec3(lightModelMatrix.GetMatrix() * glm::vec4(initialLightPosition, 1.0f));
-        
-        modelShader.Bind();
-        modelShader.SetUniform3f("u_ViewPos", cameraPosition.x, cameraPosition.y, cameraPosition.z);
-        
-        {
-            modelShader.SetUniform1i("u_DirectionalLight.enable", enableDirectionalLight);
-        }
-        
+        const double now = glfwGetTime();
+        if (recorder.IsRecording())
+            animationTime = recordingStartTime + recorder.GetTime();
+        else if (animateCamera)
+            animationTime += now - lastFrameTime;
+        lastFrameTime = now;
+        const double time = animationTime;
+        CameraPath::Keyframe camera = CameraPath::OrbitKeyframe(lookAtCenter, radius, static_cast<float>(time));
+        camera.viewTranslate = viewTranslate;
+        glm::mat4 view = CameraPath::GetViewMatrix(camera);
+
+        if (recordCamera)
         {
-            modelShader.SetUniform3f("u_LightProperty.lightPos", finalLightPosition.x, finalLightPosition.y, finalLightPosition.z);
-            modelShader.SetUniform3f("u_LightProperty.ambient",  0.1f*lightColorPicker.x, 0.1f*lightColorPicker.y, 0.1f*lightColorPicker.z);
-            modelShader.SetUniform3f("u_LightProperty.diffuse",  lightColorPicker.x/2, lightColorPicker.y/2, lightColorPicker.z/2);
-            modelShader.SetUniform3f("u_LightProperty.specular", lightColorPicker.x, lightColorPicker.y, lightColorPicker.z);
-        }
-        
-        {
-            /* Place ground below object */
-            auto distance = CommonUtils::GetBBoxCenter(modelObjectBB) - CommonUtils::GetBBoxCenter(groundObjectBB);
-            distance -= glm::vec3(0, CommonUtils::GetBBoxHeight(modelObjectBB)/2  * objectModelMatrix.fScale.y, 0);
-            groundModelMatrix.fTranslation = distance;
-            /* ToDo: I should actually put object on ground instead of other way round. */
+            camera.time = static_cast<float>(glfwGetTime() - recordStartTime);
+            recordedPath.AddKeyframe(camera);
         }
+        /*************************************/
 
+        const auto framebufferSize = window.GetFramebufferSize();
+
+        Helper::ScenePipeline::Input sceneInput;
+        sceneInput.settings       = scene.GetSettings();
+        sceneInput.proj           = proj;
+        sceneInput.view           = view;
+        sceneInput.cameraPosition = camera.eye;
+        sceneInput.width          = framebufferSize.first;
+        sceneInput.height         = framebufferSize.second;
+        scenePipeline.Submit(sceneInput);
+        Helper::SceneState& sceneState = scenePipeline.Acquire();
+
+        /* The backbuffer is cleared by its first writer. */
+        frameGraph.Reset();
+        const FrameGraph::Resource backbuffer = frameGraph.ImportBackbuffer("Backbuffer", framebufferSize.first, framebufferSize.second);
+        frameGraph.AddPass("Scene", [&](FrameGraph::Builder& builder) { builder.Write(backbuffer); }, [&](const FrameGraph&) {
+            gpuTimer.Begin();
+            scene.Draw(renderer, sceneState);
+            gpuTimer.End();
+        });
+        if (takeScreenshot)
         {
-            /* Todo: cache Get matrix output */
-            modelShader.SetUniformMat4f("u_Model", objectModelMatrix.GetMatrix()); /* Todo: pass Normal matrix here. */
-            modelShader.SetUniformMat4f("u_MVP", proj * view * objectModelMatrix.GetMatrix());
-            objectModel.Draw(renderer, modelShader);
+            /* The scene without the GUI on top. */
+            frameGraph.AddPass("Screenshot", [&](FrameGraph::Builder& builder) {
+                builder.Read(backbuffer);
+                builder.SideEffect();
+            }, [&](const FrameGraph&) {
+                readback.Read(0, framebufferSize.first, framebufferSize.second, 3, ImGui::GetFrameCount(), PixelReadback::SavePNG("screenshot.png"));
+            });
+            takeScreenshot = false;
         }
-        
+        /* Every frame must have the size the recording started with. */
+        if (recorder.IsRecording() && framebufferSize != std::make_pair(recorder.GetWidth(), recorder.GetHeight()))
+            recorder.Stop();
+        if (recorder.IsRecording())
         {
-            /* Todo: cache Get matrix output */
-            modelShader.SetUniformMat4f("u_Model", groundModelMatrix.GetMatrix()); /* Todo: pass Normal matrix here. */
-            modelShader.SetUniformMat4f("u_MVP", proj * view * groundModelMatrix.GetMatrix());
-            groundModel.Draw(renderer, modelShader);
+            frameGraph.AddPass("Record", [&](FrameGraph::Builder& builder) {
+                builder.Read(backbuffer);
+                builder.SideEffect();
+            }, [&](const FrameGraph&) {
+                recorder.Capture(0);
+            });
         }
+        frameGraph.Compile();
+        frameGraph.Run();
+        readback.Update();
+        recorder.Update();
 
-        {
-            lightShader.Bind();
-            lightShader.SetUniformMat4f("u_MVP", proj * view * lightModelMatrix.GetMatrix());
-            lightShader.SetUniform3f("u_LightColor", lightColorPicker.x, lightColorPicker.y, lightColorPicker.z);
-            
-            lightModel.Draw(renderer, lightShader);
-        }
+        if (firstFrameTime < 0.0)
+            firstFrameTime = (glfwGetTime() - loadStartTime) * 1000.0;
+        if (texturesReadyTime < 0.0 && scene.GetPendingTextureCount() == 0)
+            texturesReadyTime = (glfwGetTime() - loadStartTime) * 1000.0;
 
 //        framebuffer.Unbind();
 //        framebuffer.Draw(renderer, framebufferShader);
@@ -193,24 +234,195 @@ int main(void)
         /** IM GUI **/
         {
             ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+            ImGui::Text("%u draw calls, %llu triangles, %u texture binds", renderer.GetStats().drawCalls, renderer.GetStats().triangles,
+                        renderer.GetStats().textureBinds);
+            ImGui::Text("Objects %u visible, %u culled. Meshes %u visible, %u culled",
+                        renderer.GetStats().objectsVisible, renderer.GetStats().objectsCulled,
+                        renderer.GetStats().meshesVisible, renderer.GetStats().meshesCulled);
+            ImGui::Checkbox("Frustum Culling", &scene.fEnableFrustumCulling);
+            ImGui::SameLine();
+            ImGui::Checkbox("Occlusion Culling", &scene.fEnableOcclusionCulling);
+            ImGui::Text("Occluded %u objects (%.0f%%)", renderer.GetStats().objectsOccluded,
+                        100.0f * renderer.GetStats().objectsOccluded / std::max(1u, renderer.GetStats().objectsVisible + renderer.GetStats().objectsCulled));
+            ImGui::Checkbox("Occlusion Queries", &scene.fEnableOcclusionQueries);
+            ImGui::Text("Scene GPU %.3f ms, %u queries, %u conditional draws", gpuTimer.GetMilliseconds(),
+                        renderer.GetStats().occlusionQueries, renderer.GetStats().conditionalDraws);
+
+            if (ImGui::IsMouseClicked(0) && !ImGui::GetIO().WantCaptureMouse)
+            {
+                /* Cursor y grows downwards, NDC y upwards. */
+                const auto cursor = window.GetNormalizedCursorPosition();
+                picked = scene.Pick(glm::vec2(cursor.first, -cursor.second), proj, view, pickHit);
+            }
+
+            if (picked)
+                ImGui::Text("Picked %s, mesh %u, triangle %u at %.2f", Helper::SceneRenderer::GetObjectName(pickHit.object),
+                            pickHit.mesh, pickHit.triangle, pickHit.distance);
+            else
+                ImGui::Text("Click the scene to pick a triangle");
             
             ImGui::SliderFloat("FOV", &fieldOfView, 1.0f, 120.0f);
             ImGui::SliderFloat3("View Translate", glm::value_ptr(viewTranslate), -100.0f, 100.0f);
-//            ImGui::SliderFloat3("View Translate", glm::value_ptr(viewTranslate), -100.0f, 100.0f);
 
-            ImGui::Checkbox("Sky Light", &enableDirectionalLight);
-            ImGui::SliderFloat3("Light Translate", glm::value_ptr(lightModelMatrix.fTranslation), -100.0f, 100.0f);
+            ImGui::Checkbox("Sky Light", &scene.fEnableDirectionalLight);
+            ImGui::SliderFloat3("Sky Light Direction", glm::value_ptr(scene.fDirectionalLightDirection), -1.0f, 1.0f);
+            ImGui::Checkbox("Shadows", &scene.fEnableShadows);
+            ImGui::SameLine();
+            ImGui::Checkbox("Cache Shadows", &scene.fEnableShadowCache);
+            ImGui::Text("Shadow pass %.3f ms GPU, %u of %d cascades rendered", scene.GetShadowMilliseconds(),
+                        renderer.GetStats().shadowCascades, CascadedShadowMap::kCascades);
+            if (scene.GetPendingTextureCount())
+                ImGui::Text("Loading %zu textures", scene.GetPendingTextureCount());
+            else
+                ImGui::Text("First frame %.0f ms, textures ready %.0f ms after load", firstFrameTime, texturesReadyTime);
+            for (SceneBVH::ObjectID object = 0; object < Helper::SceneRenderer::GetObjectCount(); object++)
+            {
+                const auto memory = scene.GetTextureMemory(object);
+                ImGui::Text("%s textures %.1f MB, %.1f MB uncompressed", Helper::SceneRenderer::GetObjectName(object),
+                            memory.bytes / (1024.0 * 1024.0), memory.uncompressedBytes / (1024.0 * 1024.0));
+            }
+
+            auto& streamer = scene.GetTextureStreamer();
+            if (ImGui::SliderInt("Texture VRAM MB", &textureBudget, 1, 1024))
+                streamer.fVRAMBudget = static_cast<size_t>(textureBudget) << 20;
+            ImGui::Text("Texture detail %.1f MB resident, %.1f MB requested, %zu levels refined, %zu evicted",
+                        streamer.GetResidentBytes() / (1024.0 * 1024.0), streamer.GetWantedBytes() / (1024.0 * 1024.0),
+                        streamer.GetRefinedLevels(), streamer.GetEvictedLevels());
+            if (ImGui::CollapsingHeader("Texture Residency"))
+            {
+                /* One row per array, its layers share the levels. Sizes are of the finest level. */
+                ImGui::Columns(3, "residency");
+                ImGui::Text("Texture");   ImGui::NextColumn();
+                ImGui::Text("Resident");  ImGui::NextColumn();
+                ImGui::Text("Requested"); ImGui::NextColumn();
+                ImGui::Separator();
+
+                for (SceneBVH::ObjectID object = 0; object < Helper::SceneRenderer::GetObjectCount(); object++)
+                {
+                    const MaterialTable& materials = scene.GetMaterials(object);
+                    for (size_t index = 0; index < materials.GetArrayCount(); index++)
+                    {
+                        const auto& array = materials.GetArray(index);
+                        const std::string path = array.paths.empty() ? std::string() : array.paths[0];
+                        const int wanted = array.streamable ? streamer.GetWantedLevel(array) : array.residentLevel;
+
+                        ImGui::Text("%s%s", path.substr(path.find_last_of('/') + 1).c_str(), array.layers > 1 ? (" +" + std::to_string(array.layers - 1)).c_str() : "");
+                        ImGui::NextColumn();
+                        ImGui::Text("%dx%d %.2f MB", std::max(1, array.width >> array.residentLevel), std::max(1, array.height >> array.residentLevel),
+                                    materials.GetByteSize(index, array.residentLevel) / (1024.0 * 1024.0));
+                        ImGui::NextColumn();
+                        ImGui::Text("%dx%d %.2f MB", std::max(1, array.width >> wanted), std::max(1, array.height >> wanted),
+                                    materials.GetByteSize(index, wanted) / (1024.0 * 1024.0));
+                        ImGui::NextColumn();
+                    }
+                }
+
+                ImGui::Columns(1);
+            }
+            if (ImGui::CollapsingHeader("GL Resources"))
+            {
+                ImGui::Columns(4, "glresources");
+                ImGui::Text("Type");    ImGui::NextColumn();
+                ImGui::Text("Count");   ImGui::NextColumn();
+                ImGui::Text("MB");      ImGui::NextColumn();
+                ImGui::Text("Peak MB"); ImGui::NextColumn();
+                ImGui::Separator();
+
+                for (unsigned int type = 0; type <= static_cast<unsigned int>(GLResources::Type::Count); type++)
+                {
+                    const bool all = type == static_cast<unsigned int>(GLResources::Type::Count);
+                    const auto totals = all ? GLResources::GetTotals() : GLResources::GetTotals(static_cast<GLResources::Type>(type));
+                    ImGui::Text("%s", all ? "total" : GLResources::GetTypeName(static_cast<GLResources::Type>(type))); ImGui::NextColumn();
+                    ImGui::Text("%zu", totals.count);                                ImGui::NextColumn();
+                    ImGui::Text("%.2f", totals.bytes / (1024.0 * 1024.0));           ImGui::NextColumn();
+                    ImGui::Text("%.2f", totals.peakBytes / (1024.0 * 1024.0));       ImGui::NextColumn();
+                }
+
+                ImGui::Columns(1);
+                if (ImGui::Button("Dump GL Resources"))
+                    GLResources::DumpJSON("gl_resources.json");
+            }
+            ImGui::Text("Frame graph %zu passes, %zu culled, transients %.1f MB at peak", frameGraph.GetPassCount(),
+                        frameGraph.GetCulledPassCount(), frameGraph.GetPeakTransientBytes() / (1024.0 * 1024.0));
+            if (ImGui::Button("Print Frame Graph"))
+                frameGraph.Print(std::cout);
+            ImGui::SameLine();
+            if (ImGui::Button("Screenshot"))
+                takeScreenshot = true;
+
+            if (!recorder.IsRecording())
+            {
+                ImGui::Combo("Recording Format", &recordingFormat, "PNG sequence\0Y4M\0Raw RGB\0");
+                ImGui::SliderInt("Recording FPS", &recordingFps, 10, 60);
+                if (ImGui::Button("Start Recording") &&
+                    recorder.Start(RecordingFiles[recordingFormat], framebufferSize.first, framebufferSize.second, static_cast<float>(recordingFps)))
+                    recordingStartTime = animationTime;
+            }
+            else
+            {
+                ImGui::Text("Recording %s: %llu frames, queue %zu/%zu, encode %.2f ms, waited %.1f ms", recorder.GetPath().c_str(),
+                            recorder.GetCapturedCount(), recorder.GetQueueDepth(), FrameRecorder::kQueueSize,
+                            recorder.GetAverageEncodeTime(), recorder.GetBackpressureTime());
+                if (ImGui::Button("Stop Recording"))
+                    recorder.Stop();
+            }
+            if (ImGui::SliderInt("Extra Lights", &extraLights, 0, 1024))
+                scene.ScatterExtraLights(static_cast<unsigned int>(extraLights));
+            ImGui::Text("%zu point lights, %zu cluster entries", scene.GetLightClusters().GetLightCount(),
+                        scene.GetLightClusters().GetIndices().size());
+            ImGui::SliderFloat3("Light Translate", glm::value_ptr(scene.fLightModelMatrix.fTranslation), -100.0f, 100.0f);
             //ImGui::SliderFloat3("ModelRotate", glm::value_ptr(lightModel.fAngle), glm::radians(0.0f), glm::radians(360.0f));
-            ImGui::SliderFloat("Model Scale", glm::value_ptr(objectModelMatrix.fScale), 0.1f, 10.0f);
-            objectModelMatrix.fScale.y = objectModelMatrix.fScale.z = objectModelMatrix.fScale.x;
-            groundModelMatrix.fScale = objectModelMatrix.fScale;
-            ImGui::ColorPicker3("Light Picker", glm::value_ptr(lightColorPicker), ImGuiColorEditFlags_NoSidePreview | ImGuiColorEditFlags_NoSmallPreview);
+            ImGui::SliderFloat("Model Scale", glm::value_ptr(scene.fObjectModelMatrix.fScale), 0.1f, 10.0f);
+            scene.fObjectModelMatrix.fScale.y = scene.fObjectModelMatrix.fScale.z = scene.fObjectModelMatrix.fScale.x;
+            scene.fGroundModelMatrix.fScale = scene.fObjectModelMatrix.fScale;
+            ImGui::ColorPicker3("Light Picker", glm::value_ptr(scene.fLightColor), ImGuiColorEditFlags_NoSidePreview | ImGuiColorEditFlags_NoSmallPreview);
+
+            if (ImGui::Checkbox("Update Thread", &updateThread))
+                scenePipeline.SetThreaded(updateThread);
+            ImGui::SameLine();
+            ImGui::Text("prepare %.3f ms, waited %.3f ms", scenePipeline.GetPrepareTime(), scenePipeline.GetWaitTime());
+
+            ImGui::Checkbox("Render On Demand", &renderOnDemand);
+            ImGui::SameLine();
+            ImGui::Checkbox("Animate Camera", &animateCamera);
+            if (ImGui::Combo("Present Mode", &presentMode, "Immediate\0VSync\0Adaptive\0"))
+            {
+                window.SetPresentMode(static_cast<GLFWInitWindow::PresentMode>(presentMode));
+                presentMode = static_cast<int>(window.GetPresentMode());
+            }
+            if (ImGui::SliderInt("Frame Rate Cap", &frameRateCap, 0, 240, frameRateCap ? "%d FPS" : "Off"))
+                window.SetFrameRateCap(frameRateCap);
+
+            if (ImGui::Checkbox("Record Camera", &recordCamera))
+            {
+                if (recordCamera)
+                {
+                    recordedPath.Clear();
+                    recordStartTime = glfwGetTime();
+                }
+                else
+                {
+                    recordedPath.Save(CameraPathFile);
+                }
+            }
+
+#ifdef ENABLE_PROFILER
+            if (ImGui::Button("Dump Trace"))
+                Profiler::DumpChromeTrace("frame_trace.json");
+#endif
         }
         
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
         window.SwapBuffersAndPollEvents();
+
+        busy = animateCamera || recorder.IsRecording() || recordCamera || scene.GetPendingTextureCount() > 0 ||
+               readback.GetPendingCount() > 0 || ImGui::IsAnyItemActive();
+
+#ifdef ENABLE_PROFILER
+        Profiler::Update();
+#endif
     }
     
     ImGui_ImplOpenGL3_Shutdown();
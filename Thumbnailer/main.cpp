@@ -0,0 +1,397 @@
+//
+//  main.cpp
+//  thumbnailer
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+//  Renders a batch of models to PNG thumbnails without showing a window, the camera framed on each model's bounds.
+//  Runs without a GPU (llvmpipe through OSMesa or EGL, see GLFWInitWindow).
+//
+//  thumbnailer [--size 256] [--samples 4] [--threads N] [--output-dir .] [--res ../../../res/]
+//              [--list models.txt] [--compress-textures 0|1] [--texture-cache 0|1] [--sweep 0|1]
+//              [--output result.json] model.obj ...
+//
+//  Models are parsed, and their textures decoded, on --threads workers a few models ahead of the one the GL thread
+//  is rendering; PNGs are encoded on the same workers. --list adds the paths in the file, one per line. Throughput
+//  goes out as JSON, --sweep renders the batch once for every thread count from 1 to --threads. Run sweeps with
+//  --texture-cache 0, or all runs after the first only map cached textures.
+//
+
+#include "GUIContext.hpp"
+
+#include "ClusteredLighting.hpp"
+#include "CommonUtils.hpp"
+#include "Framebuffer.hpp"
+#include "GLResources.hpp"
+#include "ModelRendererHelper.hpp"
+#include "PixelReadback.hpp"
+#include "Renderer.hpp"
+#include "Shader.hpp"
+#include "TextureStreamer.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    /* Texture units, the material ones first (see ModelRenderer). */
+    constexpr unsigned int kShadowMapSlot    = 4;
+    constexpr unsigned int kLightsSlot       = 5;
+    constexpr unsigned int kLightGridSlot    = 6;
+    constexpr unsigned int kLightIndicesSlot = 7;
+
+    struct Options
+    {
+        int                      size    = 256;
+        int                      samples = 4;
+        unsigned int             threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+        std::string              outputDir = ".";
+        std::string              resourceRoot = "../../../res/";
+        bool                     compressTextures = true;
+        bool                     textureCache     = true;
+        bool                     sweep            = false;
+        std::string              output;
+        std::vector<std::string> models;
+    };
+
+    struct Run
+    {
+        unsigned int threads  = 0;
+        double       seconds  = 0.0;
+        size_t       rendered = 0;
+        size_t       failed   = 0;
+    };
+
+    Options ParseOptions(int argc, const char* argv[])
+    {
+        Options options;
+
+        for (int index = 1; index < argc; index++)
+        {
+            const std::string arg = argv[index];
+            if (arg.compare(0, 2, "--") != 0)
+            {
+                options.models.push_back(arg);
+                continue;
+            }
+
+            if (index + 1 >= argc)
+                throw std::runtime_error("Missing value for " + arg);
+
+            const std::string value = argv[++index];
+
+            if (arg == "--size")              options.size         = std::stoi(value);
+            else if (arg == "--samples")      options.samples      = std::stoi(value);
+            else if (arg == "--threads")      options.threads      = static_cast<unsigned int>(std::stoul(value));
+            else if (arg == "--output-dir")   options.outputDir    = value;
+            else if (arg == "--res")          options.resourceRoot = value;
+            else if (arg == "--compress-textures") options.compressTextures = value != "0";
+            else if (arg == "--texture-cache") options.textureCache = value != "0";
+            else if (arg == "--sweep")        options.sweep        = value != "0";
+            else if (arg == "--output")       options.output       = value;
+            else if (arg == "--list")
+            {
+                std::ifstream list(value);
+                if (!list)
+                    throw std::runtime_error("Can't read " + value);
+
+                for (std::string line; std::getline(list, line);)
+                    if (!line.empty() && line[0] != '#')
+                        options.models.push_back(line);
+            }
+            else throw std::runtime_error("Unknown option " + arg);
+        }
+
+        if (options.models.empty() || options.size <= 0 || options.threads == 0)
+            throw std::runtime_error("Need at least one model, a positive size and a worker thread!");
+
+        return options;
+    }
+
+    /* <output-dir>/<file name without extension>.png, numbered from the second model of the same name. */
+    std::vector<std::string> GetThumbnailPaths(const Options& options)
+    {
+        std::vector<std::string> paths;
+        std::map<std::string, int> seen;
+
+        for (const auto& model: options.models)
+        {
+            const size_t slash = model.find_last_of("/\\");
+            std::string stem = slash == std::string::npos ? model : model.substr(slash + 1);
+            stem = stem.substr(0, stem.find_last_of('.'));
+
+            const int count = seen[stem]++;
+            paths.push_back(options.outputDir + "/" + stem + (count ? "_" + std::to_string(count) : std::string()) + ".png");
+        }
+
+        return paths;
+    }
+
+    struct Camera
+    {
+        glm::vec3 position;
+        glm::mat4 view;
+        glm::mat4 proj;
+    };
+
+    /* Three quarter view from the front right, just far enough for the bounding sphere to fill the narrower field of view. */
+    Camera FrameBounds(const CommonUtils::BBCoord& bounds, float aspectRatio)
+    {
+        const glm::vec3 center = CommonUtils::GetBBoxCenter(bounds);
+        const float radius   = std::max(0.5f * glm::length(bounds.Max - bounds.Min), 1e-3f);
+        const float fovY     = glm::radians(35.0f);
+        const float fovX     = 2.0f * std::atan(std::tan(0.5f * fovY) * aspectRatio);
+        const float distance = radius / std::sin(0.5f * std::min(fovX, fovY));
+
+        Camera camera;
+        camera.position = center + glm::normalize(glm::vec3(1.0f, 0.6f, 1.5f)) * distance;
+        camera.view     = glm::lookAt(camera.position, center, glm::vec3(0.0f, 1.0f, 0.0f));
+        camera.proj     = glm::perspective(fovY, aspectRatio, std::max(distance - 1.01f * radius, 0.01f * distance), distance + 1.01f * radius);
+        return camera;
+    }
+
+    class Thumbnailer
+    {
+    public:
+        Thumbnailer(const Options& options, FramebufferPool& framebufferPool, Shader& shader):
+            mOptions(options), mOutputs(GetThumbnailPaths(options)), mShader(shader),
+            mTarget(framebufferPool, options.size, options.size, GL_RGB8, options.samples)
+        {
+        }
+
+        Run Render(unsigned int threads)
+        {
+            ThreadPool pool(threads);
+            TextureStreamer streamer(pool, mOptions.compressTextures, mOptions.textureCache);
+            PixelReadback readback(pool);
+            Run run;
+            run.threads = threads;
+
+            /* Nothing to keep interactive, whole textures go up in one Update. */
+            streamer.fUploadBudget = 64u << 20;
+
+            mPending.clear();
+            mNextModel = 0;
+
+            const auto start = std::chrono::steady_clock::now();
+            while (mNextModel < mOptions.models.size() || !mPending.empty())
+            {
+                Advance(pool, streamer, threads + 1);
+
+                Pending& pending = mPending.front();
+                while (!pending.model && !pending.failed)
+                {
+                    pending.parsing.wait_for(std::chrono::milliseconds(1));
+                    Advance(pool, streamer, threads + 1);
+                    readback.Update();
+                }
+
+                if (pending.model)
+                {
+                    Draw(pending, streamer, readback, pool);
+                    run.rendered++;
+                }
+                else
+                    run.failed++;
+
+                mPending.pop_front();
+            }
+
+            readback.Flush();
+            run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return run;
+        }
+
+    private:
+        struct Pending
+        {
+            size_t                                     index;
+            std::future<std::unique_ptr<TriangleMesh>> parsing;
+            std::unique_ptr<TriangleMesh>              model;
+            bool                                       failed = false;
+        };
+
+        /* Keeps `lookahead` models parsing, and starts decoding the textures of those that are parsed. */
+        void Advance(ThreadPool& pool, TextureStreamer& streamer, size_t lookahead)
+        {
+            while (mNextModel < mOptions.models.size() && mPending.size() < lookahead)
+            {
+                const std::string path = mOptions.models[mNextModel];
+                mPending.push_back({mNextModel++, pool.Enqueue([path] { return std::make_unique<TriangleMesh>(path); }), nullptr});
+            }
+
+            for (auto& pending: mPending)
+            {
+                /* Parsing taken: parsed already, or the model is being drawn (Draw advances too). */
+                if (pending.model || pending.failed || !pending.parsing.valid() ||
+                    pending.parsing.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                    continue;
+
+                try
+                {
+                    pending.model = pending.parsing.get();
+                }
+                catch (const std::exception& error)
+                {
+                    std::cout << "Failed to load " << mOptions.models[pending.index] << ": " << error.what() << std::endl;
+                    pending.failed = true;
+                    continue;
+                }
+
+                const auto& texturePaths = pending.model->GetTexturePaths();
+                const std::vector<bool> srgb = Helper::ModelRenderer::GetSRGBTextures(*pending.model);
+                for (size_t texture = 0; texture < texturePaths.size(); texture++)
+                    streamer.Prefetch(texturePaths[texture], srgb[texture]);
+            }
+        }
+
+        void Draw(Pending& pending, TextureStreamer& streamer, PixelReadback& readback, ThreadPool& pool)
+        {
+            const std::vector<std::string> texturePaths = pending.model->GetTexturePaths();
+            const std::vector<bool> srgb = Helper::ModelRenderer::GetSRGBTextures(*pending.model);
+
+            Helper::ModelRenderer model(std::move(pending.model), &streamer);
+            const CommonUtils::BBCoord bounds = CommonUtils::GetBBox(model.GetTriangleMesh());
+            const Camera camera = FrameBounds(bounds, 1.0f);
+            const glm::mat4 modelMatrix(1.0f);
+            const float pixelsPerUnit = 0.5f * mOptions.size * camera.proj[1][1];
+
+            /*
+             * Full detail for the thumbnail: all textures in, then every level the view asks for. Idle twice in a row,
+             * since the arrays only take the last textures (and ask for more detail) on the pass after they load.
+             */
+            for (bool wasIdle = false; ;)
+            {
+                model.UpdateMaterials();
+                model.RequestMips(modelMatrix, camera.position, pixelsPerUnit, false);
+                const size_t uploaded = streamer.Update();
+                Advance(pool, streamer, pool.GetThreadCount() + 1);
+
+                if (wasIdle && streamer.IsIdle())
+                    break;
+                wasIdle = streamer.IsIdle();
+
+                /* Nothing went up, the decodes are still running: give the workers the core instead of spinning. */
+                if (!uploaded && !wasIdle)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            model.UpdateMaterials();
+
+            mTarget.Bind();
+
+            mLightClusters.Build({}, camera.view, camera.proj, mOptions.size, mOptions.size, nullptr);
+            mLightClusters.Upload();
+            mLightClusters.Bind(kLightsSlot, kLightGridSlot, kLightIndicesSlot);
+
+            const glm::vec3 viewForward = -glm::vec3(camera.view[0][2], camera.view[1][2], camera.view[2][2]);
+            const glm::vec2 tileScale   = mLightClusters.GetTileScale();
+            /* Key light above the camera. */
+            const glm::vec3 towardsLight = glm::normalize(glm::normalize(camera.position - CommonUtils::GetBBoxCenter(bounds)) + glm::vec3(0.0f, 1.0f, 0.0f));
+
+            mShader.Bind();
+            mShader.SetUniformMat4f("u_Model", modelMatrix);
+            mShader.SetUniformMat3f("u_NormalMatrix", glm::mat3(1.0f));
+            mShader.SetUniformMat4f("u_MVP", camera.proj * camera.view * modelMatrix);
+            mShader.SetUniform3f("u_ViewPos", camera.position.x, camera.position.y, camera.position.z);
+            mShader.SetUniform3f("u_DirectionalLight.direction", towardsLight.x, towardsLight.y, towardsLight.z);
+            mShader.SetUniform3f("u_ViewForward", viewForward.x, viewForward.y, viewForward.z);
+            mShader.SetUniform2f("u_ClusterTileScale", tileScale.x, tileScale.y);
+            mShader.SetUniform1f("u_ClusterNear", mLightClusters.GetNear());
+            mShader.SetUniform1f("u_ClusterSliceScale", mLightClusters.GetSliceScale());
+
+            model.Draw(mRenderer, mShader);
+            mTarget.Unbind();
+
+            /* The ring only fills up when encoding falls behind, then the GL thread waits for it. */
+            while (!mTarget.ReadPixels(readback, pending.index, PixelReadback::SavePNG(mOutputs[pending.index])))
+            {
+                readback.Update();
+                std::this_thread::yield();
+            }
+            readback.Update();
+
+            /*
+             * Matches the Prefetch calls of Advance. Textures no model loads (e.g. unused materials) would keep their
+             * decoded images forever, those a later model shares stay prefetched for it.
+             */
+            for (size_t texture = 0; texture < texturePaths.size(); texture++)
+                streamer.CancelPrefetch(texturePaths[texture], srgb[texture]);
+        }
+
+        const Options&           mOptions;
+        std::vector<std::string> mOutputs;
+        Shader&                  mShader;
+        Framebuffer              mTarget;
+        Renderer                 mRenderer;
+        Lighting::ClusterGrid    mLightClusters;
+        std::deque<Pending>      mPending;
+        size_t                   mNextModel = 0;
+    };
+}
+
+int main(int argc, const char* argv[])
+{
+    const Options options = ParseOptions(argc, argv);
+    GLResources::EnableLeakReportAtExit();
+
+    GLFWInitWindow window(options.size, options.size, "thumbnailer", true);
+
+    FramebufferPool framebufferPool;
+    Shader shader(options.resourceRoot + "Shaders/ModelObject.shader");
+    shader.Bind();
+    shader.SetUniform1i("u_DirectionalLight.enable", 1);
+    shader.SetUniform3f("u_DirectionalLight.ambient",  0.3f, 0.3f, 0.3f);
+    shader.SetUniform3f("u_DirectionalLight.diffuse",  0.7f, 0.7f, 0.7f);
+    shader.SetUniform3f("u_DirectionalLight.specular", 0.5f, 0.5f, 0.5f);
+    shader.SetUniform1i("u_DiffuseMaps", Helper::ModelRenderer::kDiffuseMapsSlot);
+    shader.SetUniform1i("u_SpecularMaps", Helper::ModelRenderer::kSpecularMapsSlot);
+    shader.SetUniform1i("u_Materials", Helper::ModelRenderer::kMaterialsSlot);
+    shader.SetUniform1i("u_EnableShadows", 0);
+    shader.SetUniform1i("u_ShadowMap", kShadowMapSlot);
+    shader.SetUniform1i("u_Lights", kLightsSlot);
+    shader.SetUniform1i("u_LightGrid", kLightGridSlot);
+    shader.SetUniform1i("u_LightIndices", kLightIndicesSlot);
+
+    std::vector<Run> runs;
+    {
+        Thumbnailer thumbnailer(options, framebufferPool, shader);
+
+        if (options.sweep)
+            for (unsigned int threads = 1; threads <= options.threads; threads++)
+                runs.push_back(thumbnailer.Render(threads));
+        else
+            runs.push_back(thumbnailer.Render(options.threads));
+    }
+
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"renderer\": \"" << glGetString(GL_RENDERER) << "\",\n";
+    json << "  \"models\": " << options.models.size() << ",\n";
+    json << "  \"size\": " << options.size << ",\n";
+    json << "  \"samples\": " << options.samples << ",\n";
+    json << "  \"runs\": [\n";
+    for (size_t index = 0; index < runs.size(); index++)
+    {
+        const Run& run = runs[index];
+        json << "    {\"threads\": " << run.threads << ", \"seconds\": " << run.seconds
+             << ", \"rendered\": " << run.rendered << ", \"failed\": " << run.failed
+             << ", \"models_per_second\": " << (run.seconds > 0.0 ? run.rendered / run.seconds : 0.0) << "}"
+             << (index + 1 < runs.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n";
+    json << "}\n";
+
+    std::cout << json.str();
+    if (!options.output.empty())
+        std::ofstream(options.output) << json.str();
+
+    return runs.back().failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,467 @@
+//
+//  main.cpp
+//  viewer_bench
+//
+//  Created by Sumit Dhingra on 19/10/26.
+//  Copyright © 2026 LinuxSDA. All rights reserved.
+//
+//  Renders the viewer scene offscreen for a fixed number of frames along a camera path and prints frame
+//  statistics as JSON. Runs without a GPU (llvmpipe through OSMesa or EGL, see GLFWInitWindow).
+//
+//  viewer_bench [--frames N] [--warmup N] [--width W] [--height H] [--fps F]
+//               [--camera-path camera_path.txt] [--res ../../../res/] [--output result.json]
+//               [--occlusion-culling 0|1] [--occlusion-queries 0|1] [--shadows 0|1] [--shadow-cache 0|1]
+//               [--lights N] [--light-sweep 0|1] [--texture-budget MB]
+//               [--compress-textures 0|1] [--texture-cache 0|1] [--texture-vram MB] [--print-frame-graph 0|1]
+//               [--readback 0|1] [--screenshot last_frame.png|.raw] [--record frames.png|.y4m|.raw]
+//               [--update-thread 0|1]
+//
+//  Flags (0|1) also take true or false. --lights adds N scattered point lights. --light-sweep also times 1, 2, 4 ... 1024 point lights in total,
+//  reported as "light_sweep". --texture-vram is the residency budget of the streamed texture detail, run it low
+//  to see eviction at work in "texture_residency". "gl_resources" has the GL objects alive at the end and their peaks,
+//  objects still alive at exit are listed on stderr. --print-frame-graph writes the compiled frame graph to stderr.
+//  --readback reads every frame back asynchronously (and throws it away), to see what capture costs. --screenshot
+//  renders the last frame once more and saves it, for image comparisons. --record writes the measured frames at --fps,
+//  "recording" has the encoder's cost and how long the frames waited for it. --update-thread (off by default) prepares each frame's
+//  matrices and light clusters on an update thread while the previous one draws, "cpu_frame_ms" is the frame before
+//  glFinish: compare it with 0 and 1 on a heavy scene (--lights 1024).
+//
+
+#include "GUIContext.hpp"
+
+#include "CameraPath.hpp"
+#include "FrameGraph.hpp"
+#include "FrameRecorder.hpp"
+#include "GLResources.hpp"
+#include "PixelReadback.hpp"
+#include "ScenePipeline.hpp"
+#include "SceneRenderHelper.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace
+{
+    struct Options
+    {
+        unsigned int frames = 600;
+        unsigned int warmup = 30;
+        int          width  = 1280;
+        int          height = 720;
+        float        fps    = 60.0f;
+        std::string  cameraPath;
+        std::string  resourceRoot = "../../../res/";
+        std::string  output;
+        bool         occlusionCulling = false;
+        bool         occlusionQueries = false;
+        bool         shadows          = true;
+        bool         shadowCache      = true;
+        unsigned int lights           = 0;
+        bool         lightSweep       = false;
+        float        textureBudget    = 4.0f;
+        bool         compressTextures = true;
+        bool         textureCache     = true;
+        float        textureVRAM      = 128.0f;
+        bool         printFrameGraph  = false;
+        bool         readback         = false;
+        std::string  screenshot;
+        std::string  record;
+        bool         updateThread     = false;
+    };
+
+    /* 0, 1, true or false. Anything else is reported, the run stops once every option has been read. */
+    bool ParseFlag(const std::string& arg, const std::string& value, bool& flag)
+    {
+        if (value == "1" || value == "true")       flag = true;
+        else if (value == "0" || value == "false") flag = false;
+        else
+        {
+            std::cerr << "Bad value '" << value << "' for " << arg << ", expected 0, 1, true or false" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    Options ParseOptions(int argc, const char* argv[])
+    {
+        Options options;
+        bool valid = true;
+
+        for (int index = 1; index < argc; index++)
+        {
+            const std::string arg = argv[index];
+            if (index + 1 >= argc)
+                throw std::runtime_error("Missing value for " + arg);
+
+            const std::string value = argv[++index];
+
+            if (arg == "--frames")            options.frames       = static_cast<unsigned int>(std::stoul(value));
+            else if (arg == "--warmup")       options.warmup       = static_cast<unsigned int>(std::stoul(value));
+            else if (arg == "--width")        options.width        = std::stoi(value);
+            else if (arg == "--height")       options.height       = std::stoi(value);
+            else if (arg == "--fps")          options.fps          = std::stof(value);
+            else if (arg == "--camera-path")  options.cameraPath   = value;
+            else if (arg == "--res")          options.resourceRoot = value;
+            else if (arg == "--output")       options.output       = value;
+            else if (arg == "--occlusion-culling") valid &= ParseFlag(arg, value, options.occlusionCulling);
+            else if (arg == "--occlusion-queries") valid &= ParseFlag(arg, value, options.occlusionQueries);
+            else if (arg == "--shadows")      valid &= ParseFlag(arg, value, options.shadows);
+            else if (arg == "--shadow-cache") valid &= ParseFlag(arg, value, options.shadowCache);
+            else if (arg == "--lights")       options.lights       = static_cast<unsigned int>(std::stoul(value));
+            else if (arg == "--light-sweep")  valid &= ParseFlag(arg, value, options.lightSweep);
+            else if (arg == "--texture-budget") options.textureBudget = std::stof(value);
+            else if (arg == "--compress-textures") valid &= ParseFlag(arg, value, options.compressTextures);
+            else if (arg == "--texture-cache") valid &= ParseFlag(arg, value, options.textureCache);
+            else if (arg == "--texture-vram") options.textureVRAM = std::stof(value);
+            else if (arg == "--print-frame-graph") valid &= ParseFlag(arg, value, options.printFrameGraph);
+            else if (arg == "--readback") valid &= ParseFlag(arg, value, options.readback);
+            else if (arg == "--screenshot") options.screenshot = value;
+            else if (arg == "--record") options.record = value;
+            else if (arg == "--update-thread") valid &= ParseFlag(arg, value, options.updateThread);
+            else throw std::runtime_error("Unknown option " + arg);
+        }
+
+        if (!valid)
+            std::exit(EXIT_FAILURE);
+
+        if (options.frames == 0 || options.fps <= 0.0f)
+            throw std::runtime_error("Need at least one frame and a positive fps!");
+
+        return options;
+    }
+
+    double Percentile(std::vector<double> sorted, double fraction)
+    {
+        std::sort(sorted.begin(), sorted.end());
+        const size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    const Options options = ParseOptions(argc, argv);
+    GLResources::EnableLeakReportAtExit();
+
+    GLFWInitWindow window(options.width, options.height, "viewer_bench", true);
+
+    /*
+     * Textures stream in over the first frames: time until the first frame is out and until the last texture is in,
+     * both from before the scene loads. Run with --texture-cache 0, then twice with 1, for cold and warm cache times.
+     */
+    const auto loadStart = std::chrono::steady_clock::now();
+    Helper::SceneRenderer scene(options.resourceRoot, options.compressTextures, options.textureCache);
+    const double sceneLoadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+    scene.GetTextureStreamer().fUploadBudget = static_cast<size_t>(options.textureBudget * 1024.0f * 1024.0f);
+    scene.GetTextureStreamer().fVRAMBudget   = static_cast<size_t>(options.textureVRAM * 1024.0f * 1024.0f);
+    scene.fEnableOcclusionCulling = options.occlusionCulling;
+    scene.fEnableOcclusionQueries = options.occlusionQueries;
+    scene.fEnableShadows          = options.shadows;
+    scene.fEnableShadowCache      = options.shadowCache;
+    scene.ScatterExtraLights(options.lights);
+    Helper::ScenePipeline scenePipeline(scene, options.updateThread);
+    /* The scene goes into a transient colour target kept as the frame's output, its depth is dropped after the pass. */
+    FramebufferPool framebufferPool;
+    FrameGraph frameGraph(framebufferPool);
+    frameGraph.fClearColor = glm::vec4(0.1f, 0.1f, 0.1f, 1.0f);
+    PixelReadback readback(ThreadPool::Shared());
+    bool captureScreenshot = false;
+    FrameRecorder recorder;
+    bool recordFrame = false;
+    size_t peakRecordingQueue = 0;
+    if (!options.record.empty() && !recorder.Start(options.record, options.width, options.height, options.fps))
+        return 1;
+
+    /* Replay a recorded path if we have one, else the viewer's default orbit. Time comes from the frame index only. */
+    const float radius = 60.0f;
+    const CameraPath cameraPath = options.cameraPath.empty()
+        ? CameraPath::Orbit(scene.GetLookAtCenter(), radius, (options.warmup + options.frames) / options.fps)
+        : CameraPath::Load(options.cameraPath);
+
+    const float fieldOfView = 45.0f;
+    const glm::mat4 proj = glm::perspective(glm::radians(fieldOfView), (float)options.width / (float)options.height, 0.1f, 100.0f);
+
+    Renderer renderer;
+    renderer.EnableDepth(GL_LESS);
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(options.frames);
+    std::vector<double> cpuFrameTimes;
+    double cpuFrameTime = 0.0;
+    double prepareTime = 0.0, prepareWaitTime = 0.0;
+    unsigned long long drawCalls = 0;
+    unsigned long long triangles = 0;
+    unsigned long long meshesCulled = 0;
+    unsigned long long objectsCulled = 0;
+    unsigned long long objectsOccluded = 0;
+    unsigned long long objects = 0;
+    unsigned long long occlusionQueries = 0;
+    unsigned long long conditionalDraws = 0;
+    unsigned long long textureBinds = 0;
+
+    GpuTimer gpuTimer;
+    std::vector<double> gpuTimes;
+    std::vector<double> shadowTimes;
+    unsigned long long shadowCascades = 0;
+
+    /* Wall time of one frame at the path time of frame. */
+    auto renderFrame = [&](unsigned int frame) {
+        const auto start = std::chrono::steady_clock::now();
+
+        renderer.ResetStats();
+        framebufferPool.BeginFrame();
+
+        const CameraPath::Keyframe camera = cameraPath.Sample(frame / options.fps);
+
+        Helper::ScenePipeline::Input sceneInput;
+        sceneInput.settings       = scene.GetSettings();
+        sceneInput.proj           = proj;
+        sceneInput.view           = CameraPath::GetViewMatrix(camera);
+        sceneInput.cameraPosition = camera.eye;
+        sceneInput.width          = options.width;
+        sceneInput.height         = options.height;
+        scenePipeline.Submit(sceneInput);
+        Helper::SceneState& sceneState = scenePipeline.Acquire();
+
+        frameGraph.Reset();
+        FrameGraph::Resource sceneColor = FrameGraph::kNone;
+        frameGraph.AddPass("Scene", [&](FrameGraph::Builder& builder) {
+            sceneColor = builder.Create("Scene Color", {options.width, options.height, GL_RGB8, 1});
+            builder.Write(sceneColor);
+            builder.Write(builder.Create("Scene Depth", {options.width, options.height, GL_DEPTH24_STENCIL8, 1}));
+        }, [&](const FrameGraph&) {
+            gpuTimer.Begin();
+            scene.Draw(renderer, sceneState);
+            gpuTimer.End();
+        });
+        frameGraph.SetOutput(sceneColor);
+
+        if (options.readback || captureScreenshot)
+        {
+            frameGraph.AddPass("Readback", [&](FrameGraph::Builder& builder) {
+                builder.Read(sceneColor);
+                builder.SideEffect();
+            }, [&](const FrameGraph& graph) {
+                PixelReadback::Callback save;
+                if (captureScreenshot)
+                    save = options.screenshot.size() > 4 && options.screenshot.substr(options.screenshot.size() - 4) == ".raw"
+                        ? PixelReadback::SaveRaw(options.screenshot) : PixelReadback::SavePNG(options.screenshot);
+                readback.Read(graph.GetFramebuffer(sceneColor), options.width, options.height, 3, frame, save);
+            });
+        }
+
+        if (recordFrame)
+        {
+            frameGraph.AddPass("Record", [&](FrameGraph::Builder& builder) {
+                builder.Read(sceneColor);
+                builder.SideEffect();
+            }, [&](const FrameGraph& graph) {
+                recorder.Capture(graph.GetFramebuffer(sceneColor));
+            });
+        }
+
+        frameGraph.Compile();
+        frameGraph.Run();
+        readback.Update();
+        recorder.Update();
+        peakRecordingQueue = std::max(peakRecordingQueue, recorder.GetQueueDepth());
+
+        if (options.printFrameGraph && frame == 0)
+            frameGraph.Print(std::cerr);
+
+        /* What the CPU spends on the frame, then the GPU (or llvmpipe) work too, not just command submission. */
+        cpuFrameTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        GLCall(glFinish());
+
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    double firstFrameTime = -1.0;
+    double texturesReadyTime = -1.0;
+    int    texturesReadyFrame = -1;
+    size_t peakResidentBytes = 0;
+
+    for (unsigned int frame = 0; frame < options.warmup + options.frames; frame++)
+    {
+        recordFrame = recorder.IsRecording() && frame >= options.warmup;
+        const double frameTime = renderFrame(frame);
+
+        if (frame == 0)
+            firstFrameTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+        if (texturesReadyFrame < 0 && scene.GetPendingTextureCount() == 0)
+        {
+            texturesReadyTime  = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+            texturesReadyFrame = static_cast<int>(frame);
+        }
+
+        peakResidentBytes = std::max(peakResidentBytes, scene.GetTextureStreamer().GetResidentBytes());
+
+        if (frame < options.warmup)
+            continue;
+
+        frameTimes.push_back(frameTime);
+        cpuFrameTimes.push_back(cpuFrameTime);
+        prepareTime     += scenePipeline.GetPrepareTime();
+        prepareWaitTime += scenePipeline.GetWaitTime();
+        drawCalls += renderer.GetStats().drawCalls;
+        triangles += renderer.GetStats().triangles;
+        meshesCulled  += renderer.GetStats().meshesCulled;
+        objectsCulled += renderer.GetStats().objectsCulled;
+        objectsOccluded += renderer.GetStats().objectsOccluded;
+        objects += renderer.GetStats().objectsVisible + renderer.GetStats().objectsCulled;
+        occlusionQueries += renderer.GetStats().occlusionQueries;
+        conditionalDraws += renderer.GetStats().conditionalDraws;
+        textureBinds += renderer.GetStats().textureBinds;
+        gpuTimes.push_back(gpuTimer.GetMilliseconds());
+        shadowTimes.push_back(scene.GetShadowMilliseconds());
+        shadowCascades += renderer.GetStats().shadowCascades;
+    }
+
+    recordFrame = false;
+    recorder.Stop();
+
+    if (!options.screenshot.empty())
+    {
+        captureScreenshot = true;
+        renderFrame(options.warmup + options.frames - 1);
+        captureScreenshot = false;
+    }
+
+    /* Same path for every light count, shorter runs. The movable light counts as one. */
+    std::vector<std::pair<unsigned int, double>> lightSweep;
+    if (options.lightSweep)
+    {
+        const unsigned int sweepFrames = std::min(options.frames, 120u);
+        for (unsigned int lights = 1; lights <= 1024; lights *= 2)
+        {
+            scene.ScatterExtraLights(lights - 1);
+
+            double total = 0.0;
+            for (unsigned int frame = 0; frame < options.warmup + sweepFrames; frame++)
+            {
+                const double frameTime = renderFrame(frame);
+                if (frame >= options.warmup)
+                    total += frameTime;
+            }
+
+            lightSweep.emplace_back(lights, total / sweepFrames);
+        }
+
+        scene.ScatterExtraLights(options.lights);
+    }
+
+    /* Screenshot written, readback counts final. */
+    readback.Flush();
+
+    /* Timer results trail a few frames behind, good enough for a mean. */
+    const double gpuMean = std::accumulate(gpuTimes.begin(), gpuTimes.end(), 0.0) / gpuTimes.size();
+    const double shadowMean = std::accumulate(shadowTimes.begin(), shadowTimes.end(), 0.0) / shadowTimes.size();
+
+    const double mean = std::accumulate(frameTimes.begin(), frameTimes.end(), 0.0) / frameTimes.size();
+    const double cpuMean = std::accumulate(cpuFrameTimes.begin(), cpuFrameTimes.end(), 0.0) / cpuFrameTimes.size();
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"benchmark\": \"viewer_bench\",\n"
+         << "  \"renderer\": \"" << glGetString(GL_RENDERER) << "\",\n"
+         << "  \"width\": " << options.width << ",\n"
+         << "  \"height\": " << options.height << ",\n"
+         << "  \"frames\": " << frameTimes.size() << ",\n"
+         << "  \"camera_path\": \"" << (options.cameraPath.empty() ? "orbit" : options.cameraPath) << "\",\n"
+         << "  \"frame_ms\": {"
+         << "\"mean\": " << mean
+         << ", \"p50\": " << Percentile(frameTimes, 0.50)
+         << ", \"p95\": " << Percentile(frameTimes, 0.95)
+         << ", \"p99\": " << Percentile(frameTimes, 0.99)
+         << ", \"min\": " << *std::min_element(frameTimes.begin(), frameTimes.end())
+         << ", \"max\": " << *std::max_element(frameTimes.begin(), frameTimes.end()) << "},\n"
+         << "  \"cpu_frame_ms\": {"
+         << "\"mean\": " << cpuMean
+         << ", \"p50\": " << Percentile(cpuFrameTimes, 0.50)
+         << ", \"p95\": " << Percentile(cpuFrameTimes, 0.95) << "},\n"
+         << "  \"update_thread\": " << (scenePipeline.IsThreaded() ? "true" : "false") << ",\n"
+         << "  \"prepare_ms\": " << prepareTime / frameTimes.size() << ",\n"
+         << "  \"prepare_wait_ms\": " << prepareWaitTime / frameTimes.size() << ",\n"
+         << "  \"draw_calls_per_frame\": " << drawCalls / frameTimes.size() << ",\n"
+         << "  \"triangles_per_frame\": " << triangles / frameTimes.size() << ",\n"
+         << "  \"texture_binds_per_frame\": " << double(textureBinds) / frameTimes.size() << ",\n"
+         << "  \"objects_culled_per_frame\": " << double(objectsCulled) / frameTimes.size() << ",\n"
+         << "  \"meshes_culled_per_frame\": " << double(meshesCulled) / frameTimes.size() << ",\n"
+         << "  \"occluded_fraction\": " << (objects ? double(objectsOccluded) / objects : 0.0) << ",\n"
+         << "  \"occlusion_queries_per_frame\": " << double(occlusionQueries) / frameTimes.size() << ",\n"
+         << "  \"conditional_draws_per_frame\": " << double(conditionalDraws) / frameTimes.size() << ",\n"
+         << "  \"gpu_ms\": " << (GpuTimer::IsSupported() ? gpuMean : -1.0) << ",\n"
+         << "  \"shadow_gpu_ms\": " << (GpuTimer::IsSupported() ? shadowMean : -1.0) << ",\n"
+         << "  \"shadow_cascades_per_frame\": " << double(shadowCascades) / frameTimes.size() << ",\n"
+         << "  \"scene_load_ms\": " << sceneLoadTime << ",\n"
+         << "  \"first_frame_ms\": " << firstFrameTime << ",\n"
+         << "  \"textures_ready_ms\": " << texturesReadyTime << ",\n"
+         << "  \"textures_ready_frame\": " << texturesReadyFrame << ",\n"
+         << "  \"texture_compression\": " << (scene.GetTextureStreamer().IsCompressing() ? "true" : "false") << ",\n"
+         << "  \"texture_cache\": " << (options.textureCache ? "true" : "false") << ",\n"
+         << "  \"texture_vram\": {";
+
+    for (SceneBVH::ObjectID object = 0; object < Helper::SceneRenderer::GetObjectCount(); object++)
+    {
+        const auto memory = scene.GetTextureMemory(object);
+        json << (object ? ", " : "") << "\"" << Helper::SceneRenderer::GetObjectName(object) << "\": {\"bytes\": " << memory.bytes
+             << ", \"uncompressed_bytes\": " << memory.uncompressedBytes << "}";
+    }
+
+    const TextureStreamer& streamer = scene.GetTextureStreamer();
+    json << "},\n"
+         << "  \"texture_residency\": {"
+         << "\"budget_bytes\": " << streamer.fVRAMBudget
+         << ", \"resident_bytes\": " << streamer.GetResidentBytes()
+         << ", \"peak_resident_bytes\": " << peakResidentBytes
+         << ", \"requested_bytes\": " << streamer.GetWantedBytes()
+         << ", \"refined_levels\": " << streamer.GetRefinedLevels()
+         << ", \"evicted_levels\": " << streamer.GetEvictedLevels() << "},\n"
+         << "  \"framebuffer_pool\": {"
+         << "\"attachments\": " << framebufferPool.GetAttachmentCount()
+         << ", \"bytes\": " << framebufferPool.GetByteSize()
+         << ", \"allocations\": " << framebufferPool.GetAllocations()
+         << ", \"reuses\": " << framebufferPool.GetReuses() << "},\n"
+         << "  \"frame_graph\": {"
+         << "\"passes\": " << frameGraph.GetPassCount()
+         << ", \"culled_passes\": " << frameGraph.GetCulledPassCount()
+         << ", \"peak_transient_bytes\": " << frameGraph.GetPeakTransientBytes()
+         << ", \"transient_bytes\": " << frameGraph.GetTransientBytes() << "},\n"
+         << "  \"readback\": {"
+         << "\"completed\": " << readback.GetCompletedCount()
+         << ", \"dropped\": " << readback.GetDroppedCount()
+         << ", \"latency_frames\": " << readback.GetAverageLatency() << "},\n"
+         << "  \"recording\": {"
+         << "\"frames\": " << recorder.GetCapturedCount()
+         << ", \"encoded\": " << recorder.GetEncodedCount()
+         << ", \"encode_ms\": " << recorder.GetAverageEncodeTime()
+         << ", \"backpressure_ms\": " << recorder.GetBackpressureTime()
+         << ", \"peak_queue_depth\": " << peakRecordingQueue << "},\n"
+         << "  \"gl_resources\": ";
+    GLResources::WriteJSON(json, false);
+    json << ",\n"
+         << "  \"point_lights\": " << 1 + options.lights << ",\n"
+         << "  \"light_sweep\": [";
+
+    for (size_t index = 0; index < lightSweep.size(); index++)
+        json << (index ? ", " : "") << "{\"lights\": " << lightSweep[index].first << ", \"frame_ms\": " << lightSweep[index].second << "}";
+
+    json << "]\n"
+         << "}\n";
+
+    if (options.output.empty())
+        std::cout << json.str();
+    else
+        std::ofstream(options.output) << json.str();
+
+    return 0;
+}
@@ -9,30 +9,29 @@ out vec2 v_TexCoord;
 
 uniform mat4 u_MVP;
 uniform mat4 u_Model;
+uniform mat4 u_NodeTransform;   /* Of the mesh within the model. */
 
 void main()
 {
-    gl_Position = u_MVP * position;
+    gl_Position = u_MVP * u_NodeTransform * position;
     v_TexCoord = texCoord;
 }
 
 #shader fragment
 #version 330 core
 
-struct Material {
-    sampler2D diffuseTex;
-    sampler2D specularTex;
-    float shininess;
-};
-
 in vec2 v_TexCoord;
 
-uniform Material  u_MaterialProperty;
+uniform sampler2DArray u_DiffuseMaps;
+uniform samplerBuffer  u_Materials;
+uniform int            u_MaterialIndex;
 
 layout(location = 0) out vec4 color;
 uniform vec3 u_LightColor;
 
 void main()
 {
-    color = vec4( 0.5*u_LightColor + 0.5*vec3(texture(u_MaterialProperty.diffuseTex, v_TexCoord)), 1.0);
+    float layer = texelFetch(u_Materials, u_MaterialIndex).x;
+    vec3 diffuseTexel = layer < 0.0 ? vec3(1.0) : vec3(texture(u_DiffuseMaps, vec3(v_TexCoord, layer)));
+    color = vec4( 0.5*u_LightColor + 0.5*diffuseTexel, 1.0);
 }
@@ -11,24 +11,22 @@ out vec3 fragmetPosition;
 
 uniform mat4 u_MVP;
 uniform mat4 u_Model;
+uniform mat3 u_NormalMatrix;    /* Inverse transpose of u_Model's 3x3. */
+uniform mat4 u_NodeTransform;   /* Of the mesh within the model. */
 
 void main()
 {
-    gl_Position = u_MVP * position;
-    fragmetPosition = vec3(u_Model * position);
-    fragmentNormal = vec3(u_Model * normal);
+    vec4 modelPosition = u_NodeTransform * position;
+    gl_Position = u_MVP * modelPosition;
+    fragmetPosition = vec3(u_Model * modelPosition);
+    /* Node transforms are taken as rigid or uniformly scaled, as in the files we load. */
+    fragmentNormal = u_NormalMatrix * (mat3(u_NodeTransform) * normal.xyz);
     v_TexCoord = texCoord;
 }
 
 #shader fragment
 #version 330 core
 
-struct Material {
-    sampler2D diffuseTex;
-    sampler2D specularTex;
-        float shininess;
-};
-
 struct DirectionalLight {
     bool enable;
     vec3 direction;
@@ -37,14 +35,6 @@ struct DirectionalLight {
     vec3 specular;
 };
 
-struct Light {
-    bool enable;
-    vec3 lightPos;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-
 layout(location = 0) out vec4 color;
 
 in vec2 v_TexCoord;
@@ -52,15 +42,70 @@ in vec2 v_TexCoord;
 in vec3 fragmentNormal;
 in vec3 fragmetPosition;
 
-uniform Material            u_MaterialProperty;
-uniform Light               u_LightProperty;
+/* Maps of all materials of the model, see MaterialTable.hpp. */
+uniform sampler2DArray      u_DiffuseMaps;
+uniform sampler2DArray      u_SpecularMaps;
+uniform samplerBuffer       u_Materials;        /* Per material: diffuse layer, specular layer, shininess. -1 for no map. */
+uniform int                 u_MaterialIndex;
+
 uniform DirectionalLight    u_DirectionalLight;
 
 uniform vec3 u_ViewPos;
 
+const int kCascades = 3;
+
+uniform bool                u_EnableShadows;
+uniform sampler2DArrayShadow u_ShadowMap;
+uniform mat4                u_LightViewProj[kCascades];
+uniform float               u_CascadeSplits[kCascades];
+uniform vec3                u_ViewForward;
+
+/* Point lights, clustered on the CPU (see ClusteredLighting.hpp). */
+const ivec3 kClusters = ivec3(16, 9, 24);
+
+uniform samplerBuffer       u_Lights;           /* 2 texels per light: position, radius / color. */
+uniform usamplerBuffer      u_LightGrid;        /* Per cluster: first index, count. */
+uniform usamplerBuffer      u_LightIndices;
+uniform vec2                u_ClusterTileScale;
+uniform float               u_ClusterNear;
+uniform float               u_ClusterSliceScale;
+
+/* 1 lit, 0 in shadow. 3x3 taps, each one already a 2x2 comparison. */
+float DirectionalShadow()
+{
+    if (!u_EnableShadows)
+        return 1.0;
+
+    float depth = dot(fragmetPosition - u_ViewPos, u_ViewForward);
+    int cascade = 0;
+    while (cascade < kCascades - 1 && depth > u_CascadeSplits[cascade])
+        cascade++;
+
+    vec4 lightPosition = u_LightViewProj[cascade] * vec4(fragmetPosition, 1.0);
+    vec3 coord = lightPosition.xyz / lightPosition.w * 0.5 + 0.5;
+    if (depth > u_CascadeSplits[kCascades - 1] || coord.z > 1.0)
+        return 1.0;
+
+    vec2 texel = 1.0 / vec2(textureSize(u_ShadowMap, 0).xy);
+    float lit = 0.0;
+    for (int x = -1; x <= 1; x++)
+        for (int y = -1; y <= 1; y++)
+            lit += texture(u_ShadowMap, vec4(coord.xy + vec2(x, y) * texel, float(cascade), coord.z));
+
+    return lit / 9.0;
+}
+
 void main()
 {
-    color = vec4(0.0f);
+    /* Without a specular map the diffuse one stands in, as it did with per mesh texture binds. */
+    vec4 material = texelFetch(u_Materials, u_MaterialIndex);
+    vec4 diffuseSample = material.x < 0.0 ? vec4(1.0) : texture(u_DiffuseMaps, vec3(v_TexCoord, material.x));
+    vec3 diffuseTexel  = diffuseSample.rgb;
+    vec3 specularTexel = material.y < 0.0 ? diffuseTexel : vec3(texture(u_SpecularMaps, vec3(v_TexCoord, material.y)));
+    float shininess    = material.z;
+
+    /* Alpha is the material's, however many lights reach the fragment (none included). */
+    vec3 shaded = vec3(0.0f);
     //Direction light
     {
         if(u_DirectionalLight.enable)
@@ -71,40 +116,57 @@ void main()
 
             vec3 eyeDirectionVec = normalize(u_ViewPos - fragmetPosition);
             vec3 reflectionVec   = reflect(-lightDirectionVec, normalisedNormal);
-            float specularComponent = pow(max(dot(eyeDirectionVec, reflectionVec), 0.0), u_MaterialProperty.shininess);
+            float specularComponent = pow(max(dot(eyeDirectionVec, reflectionVec), 0.0), shininess);
 
-            vec3 outAmbient =   u_DirectionalLight.ambient * vec3(texture(u_MaterialProperty.diffuseTex, v_TexCoord));
-            vec3 outDiffuse =   u_DirectionalLight.diffuse  * vec3(texture(u_MaterialProperty.diffuseTex, v_TexCoord)) * diffuseComponent;
-            vec3 outSpecular =  u_DirectionalLight.specular * vec3(texture(u_MaterialProperty.specularTex, v_TexCoord)) * specularComponent;
-            vec3 result = (outAmbient + outDiffuse + outSpecular);
+            vec3 outAmbient =   u_DirectionalLight.ambient * diffuseTexel;
+            vec3 outDiffuse =   u_DirectionalLight.diffuse  * diffuseTexel * diffuseComponent;
+            vec3 outSpecular =  u_DirectionalLight.specular * specularTexel * specularComponent;
+            vec3 result = (outAmbient + (outDiffuse + outSpecular) * DirectionalShadow());
             
-            color += vec4(result, 1.0);
+            shaded += result;
         }
     }
 
-    //phong shading model
+    //phong shading model, every point light of this fragment's cluster
     {
         const float kc = 1.0f;
         const float kl = 0.0022f;
         const float kq = 0.000018f;
-        
-        float distance = length(u_LightProperty.lightPos - fragmetPosition);
-        float attenuation = 1.0 / (kc + kl * distance + kq * (distance * distance));
+
+        float depth = max(dot(fragmetPosition - u_ViewPos, u_ViewForward), u_ClusterNear);
+        ivec3 cluster = ivec3(ivec2(gl_FragCoord.xy * u_ClusterTileScale), int(log(depth / u_ClusterNear) * u_ClusterSliceScale));
+        cluster = clamp(cluster, ivec3(0), kClusters - 1);
+
+        uvec2 range = texelFetch(u_LightGrid, (cluster.z * kClusters.y + cluster.y) * kClusters.x + cluster.x).xy;
 
         vec3 normalisedNormal = normalize(fragmentNormal);
-        vec3 lightDirectionVec = normalize(u_LightProperty.lightPos - fragmetPosition);
-        float diffuseComponent = max(dot(normalisedNormal, lightDirectionVec), 0.0);
-        
-        vec3 eyeDirectionVec = normalize(u_ViewPos - fragmetPosition);
-        vec3 reflectionVec   = reflect(-lightDirectionVec, normalisedNormal);
-        float specularComponent = pow(max(dot(eyeDirectionVec, reflectionVec), 0.0), u_MaterialProperty.shininess);
-        
-        vec3 outAmbient =   u_LightProperty.ambient * vec3(texture(u_MaterialProperty.diffuseTex, v_TexCoord));
-        vec3 outDiffuse =   u_LightProperty.diffuse  * vec3(texture(u_MaterialProperty.diffuseTex, v_TexCoord)) * diffuseComponent;
-        vec3 outSpecular =  u_LightProperty.specular * vec3(texture(u_MaterialProperty.specularTex, v_TexCoord)) * specularComponent;
-
-        vec3 result = (outAmbient + outDiffuse + outSpecular) * attenuation;
-        color += vec4(result, 1.0);
+        vec3 eyeDirectionVec  = normalize(u_ViewPos - fragmetPosition);
+
+        for (uint entry = range.x; entry < range.x + range.y; entry++)
+        {
+            int light = int(texelFetch(u_LightIndices, int(entry)).x);
+            vec4 positionRadius = texelFetch(u_Lights, 2 * light);
+            vec3 lightColor     = texelFetch(u_Lights, 2 * light + 1).rgb;
+
+            /* Reaches exactly 0 at the light's radius, so clusters outside it lose nothing. */
+            float distance = length(positionRadius.xyz - fragmetPosition);
+            float window = clamp(1.0 - pow(distance / positionRadius.w, 4.0), 0.0, 1.0);
+            float attenuation = window * window / (kc + kl * distance + kq * (distance * distance));
+
+            vec3 lightDirectionVec = normalize(positionRadius.xyz - fragmetPosition);
+            float diffuseComponent = max(dot(normalisedNormal, lightDirectionVec), 0.0);
+
+            vec3 reflectionVec   = reflect(-lightDirectionVec, normalisedNormal);
+            float specularComponent = pow(max(dot(eyeDirectionVec, reflectionVec), 0.0), shininess);
+
+            vec3 outAmbient =   0.1 * lightColor * diffuseTexel;
+            vec3 outDiffuse =   0.5 * lightColor * diffuseTexel * diffuseComponent;
+            vec3 outSpecular =  lightColor * specularTexel * specularComponent;
+
+            shaded += (outAmbient + outDiffuse + outSpecular) * attenuation;
+        }
     }
 
+    color = vec4(shaded, diffuseSample.a);
+
 }
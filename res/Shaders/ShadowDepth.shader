@@ -0,0 +1,19 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+
+uniform mat4 u_MVP;
+uniform mat4 u_NodeTransform;   /* Of the mesh within the model. */
+
+void main()
+{
+    gl_Position = u_MVP * u_NodeTransform * position;
+}
+
+#shader fragment
+#version 330 core
+
+void main()
+{
+}